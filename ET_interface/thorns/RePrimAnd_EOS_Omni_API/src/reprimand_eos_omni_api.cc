@@ -3,6 +3,7 @@
 #include "cctk_Arguments.h"
 #include "cctk_Functions.h"
 #include <stdexcept>
+#include <memory>
 #include <limits>
 #include <string>
 #include <iostream>
@@ -65,29 +66,57 @@ void warn_invalid_rho_eps_ye(const eos_thermal& eos,
   CCTK_WARN(1, msg.str().c_str());
 }
 
-eos_thermal::state state_rho_eps_ye(const eos_thermal& eos, 
-  CCTK_REAL rho, CCTK_REAL eps, CCTK_REAL ye, CCTK_INT& errcode)
+eos_thermal::result_arrays offset(const eos_thermal::result_arrays& r,
+                                  std::size_t i)
 {
-  DECLARE_CCTK_PARAMETERS;
-
-  auto s = eos.at_rho_eps_ye(rho, eps, ye);
-  if (s) {
-    errcode = 0;
-    return s;
-  }
-
-  warn_invalid_rho_eps_ye(eos, rho, eps, ye);
+  eos_thermal::result_arrays o;
+  if (r.press)       o.press       = r.press + i;
+  if (r.csnd)        o.csnd        = r.csnd + i;
+  if (r.temp)        o.temp        = r.temp + i;
+  if (r.eps)         o.eps         = r.eps + i;
+  if (r.sentr)       o.sentr       = r.sentr + i;
+  if (r.dpress_drho) o.dpress_drho = r.dpress_drho + i;
+  if (r.dpress_deps) o.dpress_deps = r.dpress_deps + i;
+  return o;
+}
 
-  if (sloppy_eps && eos.is_rho_ye_valid(rho, ye)) 
+/**
+Evaluates all points with a single call to the EOS. Invalid points
+are then handled one by one, issuing warnings and adjusting the
+specific energy if allowed.
+**/
+void eval_rho_eps_ye(const eos_thermal& eos, const CCTK_INT npoints, 
+  const CCTK_REAL* rho, const CCTK_REAL* eps, const CCTK_REAL* ye, 
+  const eos_thermal::result_arrays& res, 
+  CCTK_INT* keyerr, CCTK_INT* anyerr)
+{
+  DECLARE_CCTK_PARAMETERS;
+  
+  *anyerr = 0;
+  if (npoints <= 0) return;
+  
+  std::unique_ptr<bool[]> ok{ new bool[npoints] };
+  eos.eval_at_rho_eps_ye(npoints, rho, eps, ye, res, ok.get());
+  
+  for (int i=0; i<npoints; ++i) 
   {
-    real_t valid_eps = eos.range_eps(rho, ye).limit_to(eps);
+    keyerr[i] = 0;
+    if (ok[i]) continue;
     
-    errcode = 0; 
-    return eos.at_rho_eps_ye(rho, valid_eps, ye);
+    warn_invalid_rho_eps_ye(eos, rho[i], eps[i], ye[i]);
+
+    if (sloppy_eps && eos.is_rho_ye_valid(rho[i], ye[i])) 
+    {
+      real_t valid_eps = eos.range_eps(rho[i], ye[i]).limit_to(eps[i]);
+      eos.eval_at_rho_eps_ye(1, rho + i, &valid_eps, ye + i, 
+                             offset(res, i));
+    }
+    else 
+    {
+      keyerr[i] = -1;
+      *anyerr   = 1;
+    }
   }
-  
-  errcode = -1;
-  return s;
 }
 
 
@@ -129,29 +158,49 @@ void warn_invalid_rho_temp_ye(const eos_thermal& eos,
   CCTK_WARN(1, msg.str().c_str());
 }
 
-eos_thermal::state state_rho_temp_ye(const eos_thermal& eos, 
-  CCTK_REAL rho, CCTK_REAL temp, CCTK_REAL ye, CCTK_INT& errcode)
+/**
+Same as eval_rho_eps_ye, but based on temperature.
+**/
+void eval_rho_temp_ye(const eos_thermal& eos, const CCTK_INT npoints, 
+  const CCTK_REAL* rho, const CCTK_REAL* temp, const CCTK_REAL* ye, 
+  const eos_thermal::result_arrays& res, 
+  CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   DECLARE_CCTK_PARAMETERS;
+  
+  *anyerr = 0;
+  if (npoints <= 0) return;
+  
+  std::unique_ptr<bool[]> ok{ new bool[npoints] };
+  eos.eval_at_rho_temp_ye(npoints, rho, temp, ye, res, ok.get());
+  
+  for (int i=0; i<npoints; ++i) 
+  {
+    keyerr[i] = 0;
+    if (ok[i]) continue;
+    
+    warn_invalid_rho_temp_ye(eos, rho[i], temp[i], ye[i]);
 
-  auto s = eos.at_rho_temp_ye(rho, temp, ye);
-  if (s) {
-    errcode = 0;
-    return s;
+    if (sloppy_temp && eos.is_rho_ye_valid(rho[i], ye[i])) 
+    {
+      real_t valid_temp = eos.range_temp(rho[i], ye[i]).limit_to(temp[i]);
+      eos.eval_at_rho_temp_ye(1, rho + i, &valid_temp, ye + i, 
+                              offset(res, i));
+    }
+    else 
+    {
+      keyerr[i] = -1;
+      *anyerr   = 1;
+    }
   }
+}
 
-  warn_invalid_rho_temp_ye(eos, rho, temp, ye);
-
-  if (sloppy_temp && eos.is_rho_ye_valid(rho, ye)) 
+void square_in_place(const CCTK_INT npoints, CCTK_REAL* x)
+{
+  for (int i=0; i<npoints; ++i) 
   {
-    real_t valid_temp = eos.range_temp(rho, ye).limit_to(temp);
-    
-    errcode = 0; 
-    return eos.at_rho_temp_ye(rho, valid_temp, ye);
+    x[i] *= x[i];
   }
-  
-  errcode = -1;
-  return s;
 }
 
 
@@ -172,20 +221,29 @@ void warn_invalid_rho(const eos_barotr& eos, CCTK_REAL rho)
   CCTK_WARN(1, msg.str().c_str());
 }
 
-eos_barotr::state state_rho(const eos_barotr& eos, 
-                             CCTK_REAL rho, CCTK_INT& errcode)
+/**
+Evaluates all points with a single call to the EOS. Invalid points
+result in NAN (set by the EOS), a warning, and an error code.
+**/
+void eval_rho(const eos_barotr& eos, const CCTK_INT npoints, 
+  const CCTK_REAL* rho, const eos_barotr::result_arrays& res, 
+  CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
-  auto s = eos.at_rho(rho);
+  *anyerr = 0;
+  if (npoints <= 0) return;
   
-  if (s) {
-    errcode = 0;
-  } 
-  else {
-    warn_invalid_rho(eos, rho);
-    errcode = -1;
-  }
+  std::unique_ptr<bool[]> ok{ new bool[npoints] };
+  eos.eval_at_rho(npoints, rho, res, ok.get());
   
-  return s;
+  for (int i=0; i<npoints; ++i) 
+  {
+    keyerr[i] = 0;
+    if (ok[i]) continue;
+    
+    warn_invalid_rho(eos, rho[i]);
+    keyerr[i] = -1;
+    *anyerr   = 1;
+  }
 }
 
 
@@ -195,24 +253,11 @@ void press_eps_from_rho(const CCTK_INT npoints,
   const CCTK_REAL* rho, CCTK_REAL* eps, CCTK_REAL* press,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
-
   const eos_barotr& eos = global_eos_cold::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho(eos, rho[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]    = s.eps();
-      press[i]  = s.press();
-    }
-    else 
-    {
-      eps[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      press[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_barotr::result_arrays res;
+  res.eps   = eps;
+  res.press = press;
+  eval_rho(eos, npoints, rho, res, keyerr, anyerr);
 }
 
 void press_eps_from_rho_temp_ye(const CCTK_INT npoints, 
@@ -221,22 +266,10 @@ void press_eps_from_rho_temp_ye(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_temp_ye(eos, rho[i], temp[i], ye[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]    = s.eps();
-      press[i]  = s.press();
-    }
-    else 
-    {
-      eps[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      press[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }    
+  eos_thermal::result_arrays res;
+  res.eps   = eps;
+  res.press = press;
+  eval_rho_temp_ye(eos, npoints, rho, temp, ye, res, keyerr, anyerr);
 }
 
 
@@ -246,23 +279,10 @@ void press_from_rho_eps_ye(const CCTK_INT npoints,
   const CCTK_REAL* ye, CCTK_REAL* press,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
-
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_eps_ye(eos, rho[i], eps[i], ye[i], keyerr[i]);
-    
-    if (s) 
-    {
-      press[i]  = s.press();
-    }
-    else 
-    {
-      press[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.press = press;
+  eval_rho_eps_ye(eos, npoints, rho, eps, ye, res, keyerr, anyerr);
 }
 
 
@@ -272,25 +292,12 @@ void press_eps_cs2_from_rho(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_barotr& eos = global_eos_cold::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho(eos, rho[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]    = s.eps();
-      press[i]  = s.press();
-      CCTK_REAL cs = s.csnd();
-      cs2[i]    = cs*cs;
-    }
-    else 
-    {
-      eps[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      press[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      cs2[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_barotr::result_arrays res;
+  res.eps   = eps;
+  res.press = press;
+  res.csnd  = cs2;
+  eval_rho(eos, npoints, rho, res, keyerr, anyerr);
+  square_in_place(npoints, cs2);
 }
 
 
@@ -301,25 +308,12 @@ void press_eps_cs2_from_rho_temp_ye(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {  
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_temp_ye(eos, rho[i], temp[i], ye[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]    = s.eps();
-      press[i]  = s.press();
-      CCTK_REAL cs = s.csnd();
-      cs2[i]    = cs*cs;
-    }
-    else 
-    {
-      eps[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      press[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      cs2[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.eps   = eps;
+  res.press = press;
+  res.csnd  = cs2;
+  eval_rho_temp_ye(eos, npoints, rho, temp, ye, res, keyerr, anyerr);
+  square_in_place(npoints, cs2);
 }
 
 
@@ -329,24 +323,11 @@ void press_cs2_from_rho_eps_ye(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_eps_ye(eos, rho[i], eps[i], ye[i], keyerr[i]);
-
-    if (s) 
-    {
-      press[i]  = s.press();
-      CCTK_REAL cs = s.csnd();
-      cs2[i]    = cs*cs;
-    }
-    else 
-    {
-      press[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      cs2[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.press = press;
+  res.csnd  = cs2;
+  eval_rho_eps_ye(eos, npoints, rho, eps, ye, res, keyerr, anyerr);
+  square_in_place(npoints, cs2);
 }
 
 void eps_cs2_from_rho(const CCTK_INT npoints, 
@@ -354,23 +335,11 @@ void eps_cs2_from_rho(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_barotr& eos = global_eos_cold::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho(eos, rho[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]    = s.eps();
-      CCTK_REAL cs = s.csnd();
-      cs2[i]    = cs*cs;
-    }
-    else 
-    {
-      eps[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      cs2[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_barotr::result_arrays res;
+  res.eps   = eps;
+  res.csnd  = cs2;
+  eval_rho(eos, npoints, rho, res, keyerr, anyerr);
+  square_in_place(npoints, cs2);
 }
 
 
@@ -381,23 +350,11 @@ void eps_cs2_from_rho_temp_ye(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {  
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_temp_ye(eos, rho[i], temp[i], ye[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]    = s.eps();
-      CCTK_REAL cs = s.csnd();
-      cs2[i]    = cs*cs;
-    }
-    else 
-    {
-      eps[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      cs2[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.eps   = eps;
+  res.csnd  = cs2;
+  eval_rho_temp_ye(eos, npoints, rho, temp, ye, res, keyerr, anyerr);
+  square_in_place(npoints, cs2);
 }
 
 
@@ -407,22 +364,10 @@ void cs2_from_rho_eps_ye(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_eps_ye(eos, rho[i], eps[i], ye[i], keyerr[i]);
-
-    if (s) 
-    {
-      CCTK_REAL cs = s.csnd();
-      cs2[i]    = cs*cs;
-    }
-    else 
-    {
-      cs2[i]    = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr   = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.csnd  = cs2;
+  eval_rho_eps_ye(eos, npoints, rho, eps, ye, res, keyerr, anyerr);
+  square_in_place(npoints, cs2);
 }
 
 
@@ -432,24 +377,11 @@ void eps_DPressByDEps_from_rho_temp_ye(const CCTK_INT npoints,
   const CCTK_REAL* ye, CCTK_REAL* dpress_deps, 
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
-  
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_temp_ye(eos, rho[i], temp[i], ye[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]         = s.eps();
-      dpress_deps[i] = s.dpress_deps();
-    }
-    else 
-    {
-      eps[i]          = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      dpress_deps[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.eps         = eps;
+  res.dpress_deps = dpress_deps;
+  eval_rho_temp_ye(eos, npoints, rho, temp, ye, res, keyerr, anyerr);
 }
 
 
@@ -458,20 +390,9 @@ void DPressByDEps_from_rho_eps_ye(const CCTK_INT npoints,
   CCTK_REAL* dpress_deps, CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_eps_ye(eos, rho[i], eps[i], ye[i], keyerr[i]);
-    if (s) 
-    {
-      dpress_deps[i] = s.dpress_deps();
-    }
-    else 
-    {
-      dpress_deps[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.dpress_deps = dpress_deps;
+  eval_rho_eps_ye(eos, npoints, rho, eps, ye, res, keyerr, anyerr);
 }
 
 
@@ -482,22 +403,10 @@ void eps_DPressByDRho_from_rho_temp_ye(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_temp_ye(eos, rho[i], temp[i], ye[i], keyerr[i]);
-    if (s) 
-    {
-      eps[i]          = s.eps();
-      dpress_drho[i]  = s.dpress_drho();
-    }
-    else 
-    {
-      eps[i]          = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      dpress_drho[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.eps         = eps;
+  res.dpress_drho = dpress_drho;
+  eval_rho_temp_ye(eos, npoints, rho, temp, ye, res, keyerr, anyerr);
 }
 
 
@@ -508,20 +417,9 @@ void DPressByDRho_from_rho_eps_ye(const CCTK_INT npoints,
   CCTK_INT* keyerr, CCTK_INT* anyerr)
 {
   const eos_thermal& eos = global_eos_thermal::get_eos();
-  *anyerr = 0;
-  for (int i=0; i<npoints; ++i) 
-  {
-    auto s = state_rho_eps_ye(eos, rho[i], eps[i], ye[i], keyerr[i]);
-    if (s) 
-    {
-      dpress_drho[i] = s.dpress_drho();
-    }
-    else 
-    {
-      dpress_drho[i]  = std::numeric_limits<CCTK_REAL>::quiet_NaN();
-      *anyerr = 1;
-    }
-  }
+  eos_thermal::result_arrays res;
+  res.dpress_drho = dpress_drho;
+  eval_rho_eps_ye(eos, npoints, rho, eps, ye, res, keyerr, anyerr);
 }
 
 
@@ -41,6 +41,42 @@ std::string units_to_repr(const etk::units& u)
   return fmt.str();
 }
 
+using thermal_res = etk::eos_thermal::result_arrays;
+using thermal_result = real_t* thermal_res::*;
+using array_in = py::array_t<real_t, 
+                             py::array::c_style | py::array::forcecast>;
+
+/**
+Evaluate one quantity of a thermal EOS for numpy arrays (or scalars)
+with broadcasting, using a single batched call to the EOS.
+**/
+template<thermal_result Q, bool TEMP>
+py::object eval_thermal(const etk::eos_thermal& eos, 
+                        const py::object& rho, const py::object& x,
+                        const py::object& ye)
+{
+  py::sequence args = py::module::import("numpy")
+                        .attr("broadcast_arrays")(rho, x, ye);
+  array_in a_rho = array_in::ensure(py::object(args[0]));
+  array_in a_x   = array_in::ensure(py::object(args[1]));
+  array_in a_ye  = array_in::ensure(py::object(args[2]));
+  if (!a_rho || !a_x || !a_ye) throw py::error_already_set();
+
+  py::array_t<real_t> res(a_rho.request().shape);
+  thermal_res r;
+  r.*Q = res.mutable_data();
+  const std::size_t n = a_rho.size();
+  if (TEMP) {
+    eos.eval_at_rho_temp_ye(n, a_rho.data(), a_x.data(), a_ye.data(), r);
+  }
+  else {
+    eos.eval_at_rho_eps_ye(n, a_rho.data(), a_x.data(), a_ye.data(), r);
+  }
+  
+  if (res.ndim() == 0) return py::float_(*res.data());
+  return res;
+}
+
 
 PYBIND11_MODULE(pyreprimand, m) {
     m.doc() = "Python bindings for RePrimAnd library";
@@ -137,76 +173,76 @@ of 1 m. The constant G [SI units] can be overridden.)",
     py::class_<etk::eos_thermal>(m, "eos_thermal", 
     "Represents an EOS with thermal and composition effects")
         .def("press_at_rho_eps_ye", 
-             py::vectorize(&etk::eos_thermal::press_at_rho_eps_ye),
+             &eval_thermal<&thermal_res::press, false>,
              "Compute pressure from density, specific energy, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("eps"),py::arg("ye"))
         .def("csnd_at_rho_eps_ye", 
-             py::vectorize(&etk::eos_thermal::csnd_at_rho_eps_ye),
+             &eval_thermal<&thermal_res::csnd, false>,
              "Compute soundspeed from density, specific energy, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("eps"),py::arg("ye"))
         .def("temp_at_rho_eps_ye", 
-             py::vectorize(&etk::eos_thermal::temp_at_rho_eps_ye),
+             &eval_thermal<&thermal_res::temp, false>,
              "Compute temperature from density, specific energy, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("eps"),py::arg("ye"))
         .def("sentr_at_rho_eps_ye", 
-             py::vectorize(&etk::eos_thermal::sentr_at_rho_eps_ye),
+             &eval_thermal<&thermal_res::sentr, false>,
              "Compute specific entropy from density, specific energy, "
              "and electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("eps"),py::arg("ye"))
         .def("dpress_drho_at_rho_eps_ye", 
-             py::vectorize(&etk::eos_thermal::dpress_drho_at_rho_eps_ye),
+             &eval_thermal<&thermal_res::dpress_drho, false>,
              "Compute partial derivative of pressure with respect to "
              "density, given density, specific energy, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("eps"),py::arg("ye"))
         .def("dpress_deps_at_rho_eps_ye", 
-             py::vectorize(&etk::eos_thermal::dpress_deps_at_rho_eps_ye),
+             &eval_thermal<&thermal_res::dpress_deps, false>,
              "Compute partial derivative of pressure with respect to "
              "specific energy, given density, specific energy, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("eps"),py::arg("ye"))
         .def("press_at_rho_temp_ye", 
-             py::vectorize(&etk::eos_thermal::press_at_rho_temp_ye),
+             &eval_thermal<&thermal_res::press, true>,
              "Compute pressure from density, temperature, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("temp"),py::arg("ye"))
         .def("csnd_at_rho_temp_ye", 
-             py::vectorize(&etk::eos_thermal::csnd_at_rho_temp_ye),
+             &eval_thermal<&thermal_res::csnd, true>,
              "Compute soundspeed from density, temperature, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("temp"),py::arg("ye"))
         .def("eps_at_rho_temp_ye", 
-             py::vectorize(&etk::eos_thermal::eps_at_rho_temp_ye),
+             &eval_thermal<&thermal_res::eps, true>,
              "Compute temperature from density, temperature, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("temp"),py::arg("ye"))
         .def("sentr_at_rho_temp_ye", 
-             py::vectorize(&etk::eos_thermal::sentr_at_rho_temp_ye),
+             &eval_thermal<&thermal_res::sentr, true>,
              "Compute specific entropy from density, temperature, "
              "and electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("temp"),py::arg("ye"))
         .def("dpress_drho_at_rho_temp_ye", 
-             py::vectorize(&etk::eos_thermal::dpress_drho_at_rho_temp_ye),
+             &eval_thermal<&thermal_res::dpress_drho, true>,
              "Compute partial derivative of pressure with respect to "
              "density, given density, temperature, and "
              "electron fraction.\n"
              "returns NAN outside EOS validity region.",
              py::arg("rho"),py::arg("temp"),py::arg("ye"))
         .def("dpress_deps_at_rho_temp_ye", 
-             py::vectorize(&etk::eos_thermal::dpress_deps_at_rho_temp_ye),
+             &eval_thermal<&thermal_res::dpress_deps, true>,
              "Compute partial derivative of pressure with respect to "
              "specific energy, given density, temperature, and "
              "electron fraction.\n"
@@ -269,6 +305,21 @@ of 1 m. The constant G [SI units] can be overridden.)",
           py::arg("path"),
           py::arg("units")=etk::units::geom_solar());
 
+    m.def("save_eos_thermal_mapped", &etk::save_eos_thermal_mapped, 
+R"(Save tabulated thermal EOS to memory-mappable file
+
+The file is mapped instead of read when loaded with load_eos_thermal,
+which requires the same units as the saved EOS. The format is binary
+in native byte order, and only supported by tabulated EOS types.
+
+Args:
+    path (str): Path of the EOS file
+    eos (pyreprimand.eos_thermal): The EOS object to be saved
+
+)",
+          py::arg("path"),
+          py::arg("eos"));
+
 
     py::class_<etk::eos_barotr>(m, "eos_barotr",
         "Represents a barotropic EOS")
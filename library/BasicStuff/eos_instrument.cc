@@ -0,0 +1,270 @@
+#include "eos_instrument.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace EOS_Toolkit {
+namespace instrument {
+
+namespace detail {
+
+/*
+Counters are only incremented by the owning thread, but may be read
+or reset concurrently. Relaxed atomic loads and stores avoid data 
+races without the cost of atomic read-modify-write operations.
+*/
+struct method_counters {
+  std::atomic<std::uint64_t> calls{ 0 };
+  std::atomic<std::uint64_t> sampled_calls{ 0 };
+  std::atomic<std::uint64_t> sampled_ticks{ 0 };
+};
+
+}
+
+namespace {
+
+using detail::method_counters;
+
+void add(std::atomic<std::uint64_t>& c, std::uint64_t v)
+{
+  c.store(c.load(std::memory_order_relaxed) + v, 
+          std::memory_order_relaxed);
+}
+
+auto ticks() -> std::uint64_t
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct instance_data {
+  const void* id;
+  std::string descr;
+  method_counters m[num_eos_methods];
+};
+
+struct thread_data {
+  std::mutex mtx;  ///< Protects insertion into map
+  std::unordered_map<const void*, std::unique_ptr<instance_data>> inst;
+  const void* last_id{ nullptr };
+  instance_data* last{ nullptr };
+  std::uint64_t num_probes{ 0 };
+  /// Set by reset(), entries are dropped by owning thread
+  std::atomic<bool> cleared{ false };
+};
+
+struct registry {
+  std::mutex mtx;
+  std::vector<std::shared_ptr<thread_data>> threads;
+  std::atomic<std::uint64_t> timing_interval{ 0 };
+  std::string dump_fname;
+  bool dump_registered{ false };
+};
+
+auto reg() -> registry&
+{ 
+  // Never destroyed, to remain usable when dumping at exit
+  static registry* r{ new registry };
+  return *r;
+}
+
+auto local() -> thread_data&
+{
+  thread_local std::shared_ptr<thread_data> t{ [] {
+    auto p = std::make_shared<thread_data>();
+    std::lock_guard<std::mutex> lock(reg().mtx);
+    reg().threads.push_back(p);
+    return p;
+  }() };
+  return *t;
+}
+
+void dump_handler()
+{
+  const std::string& fname{ reg().dump_fname };
+  if (fname.empty()) {
+    dump(std::cerr);
+  }
+  else {
+    std::ofstream os(fname);
+    dump(os);
+  }
+}
+
+bool init_from_env()
+{
+  const char* fn{ std::getenv("REPRIMAND_EOS_STATS") };
+  if (enabled() && (fn != nullptr)) {
+    dump_at_exit(fn);
+    return true;
+  }
+  return false;
+}
+
+const bool dump_from_env{ init_from_env() };
+
+} // namespace
+
+
+detail::probe::probe(const void* id, describe_fn describe, 
+                     eos_method m)
+{
+  thread_data& t{ local() };
+  if (t.cleared.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(t.mtx);
+    t.inst.clear();
+    t.last_id = nullptr;
+    t.last    = nullptr;
+    t.cleared.store(false, std::memory_order_relaxed);
+  }
+  if (id != t.last_id) {
+    std::lock_guard<std::mutex> lock(t.mtx);
+    auto& p = t.inst[id];
+    if (!p) {
+      p.reset(new instance_data);
+      p->id    = id;
+      p->descr = describe(id);
+    }
+    t.last_id = id;
+    t.last    = p.get();
+  }
+  cnt = &t.last->m[static_cast<std::size_t>(m)];
+  add(cnt->calls, 1);
+  const std::uint64_t iv{ 
+    reg().timing_interval.load(std::memory_order_relaxed) 
+  };
+  if ((iv != 0) && (++t.num_probes % iv == 0)) {
+    timed = true;
+    start = ticks();
+  }
+}
+
+detail::probe::~probe()
+{
+  if (timed) {
+    const std::uint64_t stop{ ticks() };
+    add(cnt->sampled_calls, 1);
+    add(cnt->sampled_ticks, stop - start);
+  }
+}
+
+
+auto method_name(eos_method m) -> const char*
+{
+  static const char* names[num_eos_methods] = {
+    "therm_from_rho_eps_ye", "therm_from_rho_temp_ye",
+    "eps", "temp", "press", "csnd", "sentr", "dpress_drho", 
+    "dpress_deps", "range_eps", "range_temp", "press_limited",
+    "eval_rho_eps_ye", "eval_rho_temp_ye",
+    "barotr_gm1_from_rho", "barotr_rho", "barotr_press", 
+    "barotr_csnd", "barotr_eps", "barotr_hm1", "barotr_temp", 
+    "barotr_ye", "barotr_vars", "barotr_eval_rho"
+  };
+  const std::size_t i{ static_cast<std::size_t>(m) };
+  return (i < num_eos_methods) ? names[i] : "invalid";
+}
+
+bool enabled()
+{
+#ifdef REPRIMAND_EOS_INSTRUMENTATION
+  return true;
+#else
+  return false;
+#endif
+}
+
+void set_timing_interval(std::uint64_t n)
+{
+  reg().timing_interval.store(n, std::memory_order_relaxed);
+}
+
+auto collect() -> std::vector<eos_stats>
+{
+  std::map<const void*, eos_stats> res;
+  std::lock_guard<std::mutex> lock(reg().mtx);
+  for (auto& t : reg().threads) {
+    std::lock_guard<std::mutex> lock_t(t->mtx);
+    if (t->cleared.load(std::memory_order_relaxed)) continue;
+    for (auto& e : t->inst) {
+      const instance_data& d{ *e.second };
+      auto i = res.find(d.id);
+      if (i == res.end()) {
+        eos_stats s;
+        s.id    = d.id;
+        s.descr = d.descr;
+        i = res.insert({d.id, s}).first;
+      }
+      for (std::size_t k = 0; k < num_eos_methods; ++k) {
+        method_stats& s{ i->second.methods[k] };
+        s.calls         += d.m[k].calls.load(std::memory_order_relaxed);
+        s.sampled_calls += 
+          d.m[k].sampled_calls.load(std::memory_order_relaxed);
+        s.sampled_ticks += 
+          d.m[k].sampled_ticks.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  std::vector<eos_stats> v;
+  for (auto& e : res) v.push_back(e.second);
+  return v;
+}
+
+void reset()
+{
+  std::lock_guard<std::mutex> lock(reg().mtx);
+  for (auto& t : reg().threads) {
+    std::lock_guard<std::mutex> lock_t(t->mtx);
+    t->cleared.store(true, std::memory_order_relaxed);
+  }
+}
+
+void dump(std::ostream& os)
+{
+  os << "# EOS call statistics" 
+     << (enabled() ? "" : " (instrumentation disabled)") << "\n";
+  for (const eos_stats& e : collect()) {
+    os << "# EOS " << e.id << ": " << e.descr << "\n";
+    for (std::size_t k = 0; k < num_eos_methods; ++k) {
+      const method_stats& s{ e.methods[k] };
+      if (s.calls == 0) continue;
+      os << std::setw(24) << method_name(static_cast<eos_method>(k)) 
+         << std::setw(16) << s.calls 
+         << std::setw(12) << s.sampled_calls;
+      if (s.sampled_calls > 0) {
+        os << std::setw(12) << std::setprecision(4)
+           << double(s.sampled_ticks) / s.sampled_calls;
+      }
+      os << "\n";
+    }
+  }
+}
+
+void dump_at_exit(const std::string& fname)
+{
+  std::lock_guard<std::mutex> lock(reg().mtx);
+  reg().dump_fname = fname;
+  if (!reg().dump_registered) {
+    std::atexit(dump_handler);
+    reg().dump_registered = true;
+  }
+}
+
+} // namespace instrument
+} // namespace EOS_Toolkit
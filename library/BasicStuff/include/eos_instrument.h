@@ -0,0 +1,131 @@
+/*! \file eos_instrument.h
+\brief Optional instrumentation of EOS calls.
+
+Counts calls to EOS implementation methods made through the generic
+EOS interfaces, per method, per EOS instance, and per thread, and
+optionally samples the time spent. The probes are only compiled
+into the library if the meson option eos_instrumentation is enabled,
+which defines REPRIMAND_EOS_INSTRUMENTATION. Otherwise, they cost
+nothing and the results below are always empty.
+
+Calls bypassing the generic interfaces, such as those made via
+eos_thermal_static or by code using EOS implementations directly,
+are not counted.
+*/
+#ifndef EOS_INSTRUMENT_H
+#define EOS_INSTRUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace EOS_Toolkit {
+namespace instrument {
+
+///EOS implementation methods that are instrumented
+enum class eos_method : unsigned {
+  therm_from_rho_eps_ye, therm_from_rho_temp_ye,
+  eps, temp, press, csnd, sentr, dpress_drho, dpress_deps,
+  range_eps, range_temp, press_limited,
+  eval_rho_eps_ye, eval_rho_temp_ye,
+  barotr_gm1_from_rho, barotr_rho, barotr_press, barotr_csnd,
+  barotr_eps, barotr_hm1, barotr_temp, barotr_ye, barotr_vars,
+  barotr_eval_rho,
+  num_methods
+};
+
+constexpr std::size_t num_eos_methods{ 
+  static_cast<std::size_t>(eos_method::num_methods) 
+};
+
+///Name of method
+auto method_name(eos_method m) -> const char*;
+
+///Statistics for one method
+struct method_stats {
+  std::uint64_t calls{ 0 };          ///< Number of calls
+  std::uint64_t sampled_calls{ 0 };  ///< Number of timed calls
+  std::uint64_t sampled_ticks{ 0 };  ///< Time spent in timed calls
+};
+
+///Statistics for one EOS instance, summed over threads
+struct eos_stats {
+  /**Address of EOS implementation. EOS objects created at the
+     address of a destroyed one are not distinguished until reset().**/
+  const void* id;
+  std::string descr;         ///< Description string of the EOS
+  method_stats methods[num_eos_methods];
+};
+
+///Whether instrumentation was compiled into the library
+bool enabled();
+
+/**\brief Set sampling interval for timing
+
+Every n-th call per thread is timed, in units of CPU timestamp 
+counter ticks where available, else nanoseconds. Zero disables 
+timing, which is the default.
+**/
+void set_timing_interval(std::uint64_t n);
+
+///Statistics collected so far, for all threads and EOS instances
+auto collect() -> std::vector<eos_stats>;
+
+///Remove all statistics collected so far
+void reset();
+
+///Write table of collected statistics
+void dump(std::ostream& os);
+
+/**\brief Write statistics to file at program exit
+
+If the environment variable REPRIMAND_EOS_STATS is set to a 
+filename when the program starts, this is done automatically.
+An empty filename denotes standard error.
+**/
+void dump_at_exit(const std::string& fname);
+
+
+namespace detail {
+
+using describe_fn = std::string (*)(const void*);
+
+struct method_counters;
+
+///Records one call, timing it if sampled. Used by EOS_INSTRUMENT.
+class probe {
+  method_counters* cnt;
+  std::uint64_t start{ 0 };
+  bool timed{ false };
+
+  public:
+  probe(const void* id, describe_fn describe, eos_method m);
+  probe(const probe&)            = delete;
+  probe& operator=(const probe&) = delete;
+  ~probe();
+};
+
+} // namespace detail
+
+} // namespace instrument
+} // namespace EOS_Toolkit
+
+
+#ifdef REPRIMAND_EOS_INSTRUMENTATION
+#define EOS_INSTRUMENT_CONCAT2(a, b) a##b
+#define EOS_INSTRUMENT_CONCAT(a, b) EOS_INSTRUMENT_CONCAT2(a, b)
+/**\brief Instrument remainder of enclosing scope as call to method m
+of EOS implementation at address id. The function describe is called
+once per EOS and thread to obtain a description.
+**/
+#define EOS_INSTRUMENT(id, describe, m) \
+  const EOS_Toolkit::instrument::detail::probe \
+    EOS_INSTRUMENT_CONCAT(eos_instrument_probe_, __LINE__) \
+    {id, describe, EOS_Toolkit::instrument::eos_method::m}
+#else
+#define EOS_INSTRUMENT(id, describe, m)
+#endif
+
+#endif
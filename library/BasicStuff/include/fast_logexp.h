@@ -0,0 +1,128 @@
+#ifndef FAST_LOGEXP_H
+#define FAST_LOGEXP_H
+
+#include "config.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace EOS_Toolkit {
+namespace detail {
+
+/**\brief Natural logarithm without special case handling
+
+The argument is split into exponent and mantissa by bit manipulation,
+and the logarithm of the mantissa is computed with the rational
+approximation used by fdlibm. The function has no branches and can be
+inlined and vectorized by the compiler, in contrast to std::log.
+The relative error is below \f$ 2 \times 10^{-16} \f$, i.e. far 
+below any interpolation error.
+
+\pre The argument must be a normal, finite, positive number. This is
+     not checked, zero, denormals, infinity, NAN, and negative numbers
+     result in garbage.
+**/
+inline auto fast_log(real_t x) -> real_t
+{
+  static_assert(sizeof(real_t) == sizeof(std::uint64_t),
+                "fast_log requires 64 bit IEEE floating point");
+
+  const real_t ln2_hi{ 6.93147180369123816490e-01 };
+  const real_t ln2_lo{ 1.90821492927058770002e-10 };
+  const real_t lg1{ 6.666666666666735130e-01 };
+  const real_t lg2{ 3.999999999940941908e-01 };
+  const real_t lg3{ 2.857142874366239149e-01 };
+  const real_t lg4{ 2.222219843214978396e-01 };
+  const real_t lg5{ 1.818357216161805012e-01 };
+  const real_t lg6{ 1.531383769920937332e-01 };
+  const real_t lg7{ 1.479819860511658591e-01 };
+  const std::uint64_t sqrt_half_hi{ 0x3fe6a09e00000000ULL };
+  const std::uint64_t one_hi{ 0x3ff0000000000000ULL };
+  const std::uint64_t mant_mask{ 0x000fffffffffffffULL };
+  const std::uint64_t two52_bits{ 0x4330000000000000ULL };
+  const real_t two52{ 4503599627370496.0 };
+
+  //Reduce to x = 2^k m with m in [sqrt(1/2), sqrt(2))
+  std::uint64_t ix;
+  std::memcpy(&ix, &x, sizeof(ix));
+  ix += one_hi - sqrt_half_hi;
+  //Convert exponent to floating point by placing it in the mantissa
+  std::uint64_t ik{ (ix >> 52) | two52_bits };
+  real_t k;
+  std::memcpy(&k, &ik, sizeof(k));
+  k -= two52 + 0x3ff;
+  ix = (ix & mant_mask) + sqrt_half_hi;
+  real_t m;
+  std::memcpy(&m, &ix, sizeof(m));
+
+  const real_t f{ m - 1.0 };
+  const real_t hfsq{ 0.5 * f * f };
+  const real_t s{ f / (2.0 + f) };
+  const real_t z{ s * s };
+  const real_t w{ z * z };
+  const real_t t1{ w * (lg2 + w * (lg4 + w * lg6)) };
+  const real_t t2{ z * (lg1 + w * (lg3 + w * (lg5 + w * lg7))) };
+  const real_t r{ t1 + t2 };
+
+  return s * (hfsq + r) + k * ln2_lo - hfsq + f + k * ln2_hi;
+}
+
+/**\brief Exponential function without special case handling
+
+The argument is reduced to \f$ x = k \ln(2) + r \f$ with integer
+\f$ k \f$ and \f$ |r| \le \ln(2)/2 \f$, and \f$ \exp(r) \f$ is computed
+with the rational approximation used by fdlibm. The result is scaled by
+\f$ 2^k \f$ via bit manipulation. The function has no branches and
+can be inlined and vectorized by the compiler, in contrast to
+std::exp. The relative error is below \f$ 2 \times 10^{-16} \f$.
+
+Arguments are limited to the range \f$ [-708, 709] \f$, for which the
+result is a normal floating point number. Outside, the result is
+the one at the nearest bound instead of zero or infinity.
+
+\pre The argument must not be NAN. This is not checked.
+**/
+inline auto fast_exp(real_t x) -> real_t
+{
+  static_assert(sizeof(real_t) == sizeof(std::int64_t),
+                "fast_exp requires 64 bit IEEE floating point");
+
+  const real_t inv_ln2{ 1.44269504088896338700e+00 };
+  const real_t ln2_hi{ 6.93147180369123816490e-01 };
+  const real_t ln2_lo{ 1.90821492927058770002e-10 };
+  const real_t p1{ 1.66666666666666019037e-01 };
+  const real_t p2{ -2.77777777770155933842e-03 };
+  const real_t p3{ 6.61375632143793436117e-05 };
+  const real_t p4{ -1.65339022054652515390e-06 };
+  const real_t p5{ 4.13813679705723846039e-08 };
+  //Adding this rounds to integer, stored in lowest mantissa bits
+  const real_t shift{ 6755399441055744.0 }; // 1.5 * 2^52
+
+  x = std::max(-708.0, std::min(709.0, x));
+
+  const real_t ks{ x * inv_ln2 + shift };
+  const real_t k{ ks - shift };
+  std::int64_t iks, ishift;
+  std::memcpy(&iks, &ks, sizeof(iks));
+  std::memcpy(&ishift, &shift, sizeof(ishift));
+  const std::int64_t ik{ iks - ishift };
+
+  const real_t hi{ x - k * ln2_hi };
+  const real_t lo{ k * ln2_lo };
+  const real_t r{ hi - lo };
+  const real_t t{ r * r };
+  const real_t c{ r - t * (p1 + t * (p2 + t * (p3 + t * (p4 + t * p5)))) };
+  const real_t p{ 1.0 + ((r * c / (2.0 - c) - lo) + hi) };
+
+  std::int64_t ip;
+  std::memcpy(&ip, &p, sizeof(ip));
+  ip += ik * (std::int64_t(1) << 52);
+  real_t y;
+  std::memcpy(&y, &ip, sizeof(y));
+  return y;
+}
+
+} // namespace detail
+} // namespace EOS_Toolkit
+
+#endif
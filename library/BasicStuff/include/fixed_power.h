@@ -0,0 +1,104 @@
+#ifndef FIXED_POWER_H
+#define FIXED_POWER_H
+
+#include "config.h"
+#include <cmath>
+
+namespace EOS_Toolkit {
+namespace detail {
+
+/**\brief Power function with exponent fixed at construction
+
+The exponent is classified once when constructing the object. Positive
+exponents which are exact multiples of \f$ 1/2 \f$ or \f$ 1/3 \f$ are
+evaluated using multiplications and one square or cube root,
+respectively, which is several times faster than std::pow. Other
+exponents, or exponents larger than 8, use std::pow.
+
+This is used for polytropic EOS, where indices like \f$ n=1 \f$,
+\f$ n=3/2 \f$, or \f$ n=3 \f$ are common. For integer and 
+half-integer exponents, the results agree with std::pow within a few 
+ulp. For multiples of 1/3, the result is the one for the exact 
+fraction, which differs from std::pow with the rounded exponent by 
+around \f$ |\ln(x)| \f$ ulp.
+**/
+class fixed_power {
+  public:
+
+  ///Create power function \f$ x^p \f$
+  explicit fixed_power(
+    real_t p_=1   ///< Exponent \f$ p \f$
+  ) : p{p_}
+  {
+    if (classify(2, kind_t::half)) return;
+    classify(3, kind_t::third);
+  }
+
+  ///Compute \f$ x^p \f$.
+  real_t operator()(real_t x) const
+  {
+    switch (kind) {
+      case kind_t::integer:
+        return ipow(x, q);
+      case kind_t::half:
+        return ipow(x, q) * std::sqrt(x);
+      case kind_t::third:
+        return ipow(x, q) * std::cbrt(x);
+      case kind_t::two_thirds: {
+        const real_t c{ std::cbrt(x) };
+        return ipow(x, q) * (c * c);
+      }
+      default:
+        return std::pow(x, p);
+    }
+  }
+
+  ///The exponent
+  real_t exponent() const {return p;}
+
+  ///Whether the exponent is evaluated without std::pow
+  bool is_specialized() const {return kind != kind_t::general;}
+
+  private:
+
+  enum class kind_t {integer, half, third, two_thirds, general};
+
+  ///Largest exponent which is specialized
+  static constexpr unsigned max_int{ 8 };
+
+  real_t p;
+  unsigned q{ 0 };    ///< Integer part of exponent
+  kind_t kind{ kind_t::general };
+
+  ///Try to write \f$ p = q + r / d \f$ with integers q, r
+  bool classify(unsigned d, kind_t frac)
+  {
+    const real_t pd{ p * d };
+    if (!(pd > 0) || (pd > max_int * d) || (pd != std::floor(pd))) {
+      return false;
+    }
+    const unsigned m{ static_cast<unsigned>(pd) };
+    const unsigned r{ m % d };
+    q = m / d;
+    kind = (r == 0) ? kind_t::integer
+                    : ((r == 2) ? kind_t::two_thirds : frac);
+    return true;
+  }
+
+  ///Integer power by repeated squaring
+  static real_t ipow(real_t x, unsigned k)
+  {
+    real_t r{ 1 };
+    while (k != 0) {
+      if (k & 1u) r *= x;
+      x *= x;
+      k >>= 1;
+    }
+    return r;
+  }
+};
+
+} // namespace detail
+} // namespace EOS_Toolkit
+
+#endif
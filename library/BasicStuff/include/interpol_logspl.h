@@ -87,6 +87,9 @@ class interpol_logspl_impl : public interpolator_impl {
 
   void assert_valid() const;
 
+  ///Underlying spline in terms of \f$ \log(x) \f$
+  auto spline_z() const -> const interpol_regspl_impl& {return yz;}
+
   private:
   
   interpol_regspl_impl yz;  
@@ -174,6 +177,9 @@ class interpol_llogspl_impl : public interpolator_impl {
   
   static const std::string datastore_id;
 
+  ///Underlying spline for \f$ \log(y) \f$
+  auto spline_logy() const -> const interpol_logspl_impl& {return yz;}
+
   private:
 
   void assert_valid() const;
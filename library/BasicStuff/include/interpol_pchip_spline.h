@@ -1,9 +1,10 @@
 #ifndef INTERPOL_PCHIP_SPLINE_H
 #define INTERPOL_PCHIP_SPLINE_H
+#include <cassert>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <vector>
-#include <gsl/gsl_spline.h>
 #include "config.h"
 #include "interpol.h"
 #include "datastore.h"
@@ -16,36 +17,53 @@ namespace detail {
 
 
 
+/**\brief Monotonic cubic spline interpolation
+
+Uses the method by Steffen (1990), which preserves monotonicity of
+the data, with the same boundary conditions as the GSL implementation. 
+The cubic polynomial coefficients for each segment are precomputed 
+and stored together with the segment start. Evaluation only reads 
+the spline data and is therefore safe to call concurrently.
+**/
 class interpol_pchip_impl : public interpolator_impl {  
-      
-  struct wrap_interp_accel {
-    gsl_interp_accel* p{nullptr};
-    
-    wrap_interp_accel();
-    ~wrap_interp_accel();
+
+  ///Polynomial \f$ d + c t + b t^2 + a t^3 \f$ with \f$ t = x - x_0 \f$
+  struct segment {
+    real_t x0, d, c, b, a;
   };
 
-  struct wrap_interp_cspline {
-    wrap_interp_accel acc;
-    gsl_interp* p{nullptr};
+  struct steffen_spline {
     std::vector<real_t> x;
     std::vector<real_t> y;
+    std::vector<segment> seg;
     
-    wrap_interp_cspline() = delete;
-    wrap_interp_cspline(const wrap_interp_cspline&) = delete;
-    wrap_interp_cspline(wrap_interp_cspline&&) = delete;
-    wrap_interp_cspline& operator=(const wrap_interp_cspline&) = delete;
-    wrap_interp_cspline& operator=(wrap_interp_cspline&&) = delete;
-    wrap_interp_cspline(std::vector<double> x_, 
-                        std::vector<double> y_);
-    auto operator()(real_t t) const -> real_t;
-    
-    ~wrap_interp_cspline();
+    steffen_spline(std::vector<real_t> x_, std::vector<real_t> y_);
+
+    ///Segment containing t, assuming t is within range
+    auto find(real_t t) const -> std::size_t;
+
+    ///Same as find(), but first checks given and following segment
+    auto find(real_t t, std::size_t hint) const -> std::size_t
+    {
+      const std::size_t ns{ seg.size() };
+      if ((hint < ns) && (x[hint] <= t)) {
+        if (t < x[hint + 1]) return hint;
+        if ((hint + 1 < ns) && (t < x[hint + 2])) return hint + 1;
+      }
+      return find(t);
+    }
+
+    auto eval(std::size_t i, real_t t) const -> real_t
+    {
+      const segment& s{ seg[i] };
+      const real_t dx{ t - s.x0 };
+      return s.d + dx * (s.c + dx * (s.b + dx * s.a));
+    }
   };
     
   public:
   
-  using spline_t = wrap_interp_cspline; 
+  using spline_t = steffen_spline; 
   using interpolator_impl::func_t;
   using interpolator_impl::range_t;
 
@@ -70,6 +88,24 @@ class interpol_pchip_impl : public interpolator_impl {
 
   ///Look up value. 
   auto operator()(real_t x) const -> real_t final;
+
+  /**\brief Look up value, using search hint
+
+  This is faster for monotonic sequences of arguments, since the
+  segment found in the previous call is checked first, together with
+  the next one. 
+
+  @param x    Argument
+  @param hint Segment index from previous call. Initialize with zero.
+              Is set to segment index found for x. 
+  **/
+  auto operator()(real_t x, std::size_t& hint) const -> real_t
+  {
+    assert(spline);
+    const real_t t{ rgx.limit_to(x) };
+    hint = spline->find(t, hint);
+    return spline->eval(hint, t);
+  }
   
   void save(datasink s) const;
 
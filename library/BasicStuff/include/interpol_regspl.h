@@ -77,6 +77,12 @@ class interpol_regspl_impl : public interpolator_impl {
 
   void assert_valid() const;
 
+  ///Spline segments, each parametrized on the unit interval
+  auto segments() const -> const std::vector<segment>& {return segs;}
+
+  ///Spacing of sample points
+  auto spacing() const -> real_t {return dx;}
+
   static const std::string datastore_id;
 
   private:
@@ -0,0 +1,42 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace EOS_Toolkit {
+
+/**\brief Read-only memory mapping of a whole file
+
+The file content is mapped as shared memory, such that the pages
+are loaded lazily and shared between all processes mapping the
+same file. The mapping is removed on destruction.
+**/
+class mapped_file {
+  const char* addr{ nullptr };
+  std::size_t len{ 0 };
+
+  public:
+
+  /**\brief Map given file
+  
+  \throws std::runtime_error if the file cannot be opened or mapped,
+          or is empty.
+  **/
+  explicit mapped_file(const std::string& path);
+
+  mapped_file(const mapped_file&)            = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  ~mapped_file();
+
+  ///Start of the mapped file content
+  auto data() const -> const char* {return addr;}
+
+  ///Size of the file in bytes
+  auto size() const -> std::size_t {return len;}
+};
+
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef SHARED_ARRAY_H
+#define SHARED_ARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace EOS_Toolkit {
+
+/**\brief Immutable array with shared ownership of the storage
+
+The elements are either stored in a vector owned by the array, or in
+memory owned by another object, e.g. a memory-mapped file, which is
+kept alive as long as any array referencing it exists. Copying an
+array does not copy the elements.
+**/
+template<class T>
+class shared_array {
+  std::shared_ptr<const void> owner;
+  const T* ptr{ nullptr };
+  std::size_t sz{ 0 };
+
+  public:
+
+  ///Default constructor results in empty array
+  shared_array() = default;
+
+  ///Take ownership of the elements in a vector
+  explicit shared_array(std::vector<T>&& v)
+  {
+    auto p = std::make_shared<const std::vector<T>>(std::move(v));
+    ptr   = p->data();
+    sz    = p->size();
+    owner = std::move(p);
+  }
+
+  /**\brief Reference memory owned by another object
+  
+  @param owner_ Object owning the memory, kept alive by the array
+  @param ptr_   Pointer to first element
+  @param sz_    Number of elements
+  **/
+  shared_array(std::shared_ptr<const void> owner_, const T* ptr_,
+               std::size_t sz_)
+  : owner{std::move(owner_)}, ptr{ptr_}, sz{sz_} {}
+
+  ///Access element (unchecked)
+  const T& operator[](std::size_t i) const {return ptr[i];}
+
+  ///Pointer to first element
+  auto data() const -> const T* {return ptr;}
+
+  ///Number of elements
+  auto size() const -> std::size_t {return sz;}
+
+  ///Whether the array is empty
+  bool empty() const {return sz == 0;}
+
+  auto begin() const -> const T* {return ptr;}
+  auto end() const -> const T* {return ptr + sz;}
+};
+
+}
+
+#endif
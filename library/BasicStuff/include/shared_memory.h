@@ -0,0 +1,70 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace EOS_Toolkit {
+
+/**\brief Named POSIX shared memory segment
+
+Segments are identified by a name of the form "/somename" and persist
+until removed, even if no process uses them. Mappings stay valid after
+removing the name. Processes creating a segment obtain write access,
+processes attaching to an existing one map it read-only.
+**/
+class shared_memory {
+  char* addr{ nullptr };
+  std::size_t len{ 0 };
+
+  shared_memory(char* addr_, std::size_t len_) : addr{addr_}, len{len_} {}
+
+  public:
+
+  /**\brief Create new segment of given size, initialized to zero
+
+  @return The writable segment, or nullptr if a segment with this name
+          already exists.
+  \throws std::runtime_error if the segment cannot be created.
+  **/
+  static auto create(const std::string& name, std::size_t size)
+  -> std::shared_ptr<shared_memory>;
+
+  /**\brief Map existing segment read-only
+
+  If the segment exists but its size was not yet set by the creating
+  process, this waits until it is or the timeout expires.
+
+  @param name    Name of the segment
+  @param timeout Maximum time to wait, in seconds
+  @return The segment, or nullptr if no segment with this name exists.
+  \throws std::runtime_error if the segment cannot be mapped.
+  **/
+  static auto attach(const std::string& name, double timeout)
+  -> std::shared_ptr<const shared_memory>;
+
+  /**\brief Remove segment name
+
+  @return If a segment with this name existed
+  **/
+  static bool remove(const std::string& name);
+
+  shared_memory(const shared_memory&)            = delete;
+  shared_memory& operator=(const shared_memory&) = delete;
+
+  ~shared_memory();
+
+  ///Start of segment
+  auto data() const -> const char* {return addr;}
+
+  ///Start of segment, only for the process that created it
+  auto data() -> char* {return addr;}
+
+  ///Size of the segment in bytes
+  auto size() const -> std::size_t {return len;}
+};
+
+}
+
+#endif
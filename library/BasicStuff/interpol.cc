@@ -1,4 +1,5 @@
 #include "interpol.h"
+#include "fast_logexp.h"
 #include <cmath>
 #include <limits>
 #include <algorithm>
@@ -188,12 +189,18 @@ lookup_table_magx::lookup_table_magx(func_t func, range_t range,
 
 /**
 If x is outside the tabulated range, the function value at the 
-closest boundary is returned
+closest boundary is returned. If the library is built with the 
+fast_logexp option, the logarithm is computed by 
+detail::fast_log().
 */
 real_t lookup_table_magx::operator()(real_t x) const
 {
   x = range_x().limit_to(x);
+#ifdef REPRIMAND_FAST_LOGEXP
+  return tbl(detail::fast_log(x + x_offs));
+#else
   return tbl(log(x + x_offs));
+#endif
 }
 
 
@@ -1,4 +1,5 @@
 #include "interpol_logspl.h"
+#include "fast_logexp.h"
 #include <cmath>
 #include <algorithm>
 #include <iterator>
@@ -13,16 +14,32 @@ const std::string interpol_logspl_impl::datastore_id {
   "cubic_monotone_spline_regular_spaced_logx"
 };
 
+/**
+If the library is built with the fast_logexp option, this uses 
+fast_log() instead of the standard library.
+**/
 auto interpol_logspl_impl::x2z(real_t x)
 -> real_t
 {
+#ifdef REPRIMAND_FAST_LOGEXP
+  return fast_log(x);
+#else
   return log(x);
+#endif
 }
 
+/**
+If the library is built with the fast_logexp option, this uses 
+fast_exp() instead of the standard library.
+**/
 auto interpol_logspl_impl::z2x(real_t z)
 -> real_t
 {
+#ifdef REPRIMAND_FAST_LOGEXP
+  return fast_exp(z);
+#else
   return exp(z);
+#endif
 }
 
 auto interpol_logspl_impl::rgz2rgx(range_t rgz)
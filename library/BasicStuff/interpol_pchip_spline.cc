@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <iterator>
 #include <stdexcept>
+#include <cassert>
 
 namespace {
 
@@ -27,24 +28,16 @@ const std::string interpol_pchip_impl::datastore_id {
 };
   
 
-interpol_pchip_impl::wrap_interp_accel::wrap_interp_accel()
-: p{gsl_interp_accel_alloc()}
-{
-  if (p==nullptr) {
-    throw std::runtime_error("interpol_pchip_impl: could not allocate memory");
-  }
-}
-
-interpol_pchip_impl::wrap_interp_accel::~wrap_interp_accel()
-{
-  if (p!=nullptr) gsl_interp_accel_free(p);
-}
-
-interpol_pchip_impl::wrap_interp_cspline::wrap_interp_cspline( 
-                   std::vector<double> x_, std::vector<double> y_)
+/**
+Steffen's method with the simplest boundary conditions, i.e. the 
+derivatives at the boundaries are set to the slopes of the adjacent
+segments. This is the same as the GSL implementation.
+*/
+interpol_pchip_impl::steffen_spline::steffen_spline( 
+                   std::vector<real_t> x_, std::vector<real_t> y_)
 : x{std::move(x_)}, y{std::move(y_)}
 {
-  const int min_points = 5;
+  const std::size_t min_points = 5;
   if (x.size() < min_points) {
     throw std::invalid_argument("interpol_pchip_impl: not enough "
                                 "interpolation points");
@@ -57,26 +50,50 @@ interpol_pchip_impl::wrap_interp_cspline::wrap_interp_cspline(
                              "increasing");
   }
 
-  p = gsl_interp_alloc(gsl_interp_steffen, x.size());
-  if (p == nullptr) {
-    throw std::runtime_error("interpol_pchip_impl: could not allocate memory");
+  const std::size_t n{ x.size() };
+  std::vector<real_t> yp(n);
+  yp[0] = (y[1] - y[0]) / (x[1] - x[0]);
+  for (std::size_t i = 1; i < n - 1; ++i) {
+    const real_t hi{ x[i+1] - x[i] };
+    const real_t him1{ x[i] - x[i-1] };
+    const real_t si{ (y[i+1] - y[i]) / hi };
+    const real_t sim1{ (y[i] - y[i-1]) / him1 };
+    const real_t pi{ (sim1 * hi + si * him1) / (him1 + hi) };
+    yp[i] = (std::copysign(1.0, sim1) + std::copysign(1.0, si)) 
+            * std::min(std::fabs(sim1), 
+                       std::min(std::fabs(si), 0.5 * std::fabs(pi)));
+  }
+  yp[n-1] = (y[n-1] - y[n-2]) / (x[n-1] - x[n-2]);
+
+  seg.resize(n - 1);
+  for (std::size_t i = 0; i < n - 1; ++i) {
+    const real_t hi{ x[i+1] - x[i] };
+    const real_t si{ (y[i+1] - y[i]) / hi };
+    seg[i] = {x[i], y[i], yp[i], 
+              (3 * si - 2 * yp[i] - yp[i+1]) / hi,
+              (yp[i] + yp[i+1] - 2 * si) / (hi * hi)};
   }
-  gsl_interp_init(p, &(x[0]), &(y[0]), x.size());
 }
 
-interpol_pchip_impl::wrap_interp_cspline::~wrap_interp_cspline()
-{
-  if (p!=nullptr) gsl_interp_free(p);
-}
-  
-auto interpol_pchip_impl::wrap_interp_cspline::operator()(real_t t) 
-const -> real_t
+/**
+The loop has a fixed number of iterations for a given number of 
+segments, and the comparison result is only used to select the next
+position. The compiler can use a conditional move instead of a 
+branch, which avoids branch mispredictions for random arguments.
+**/
+auto interpol_pchip_impl::steffen_spline::find(real_t t) const 
+-> std::size_t
 {
-  assert(p);
-  return gsl_interp_eval(p, &(x[0]), &(y[0]), t, acc.p);  
+  const real_t* xs{ x.data() };
+  std::size_t lo{ 0 }, len{ seg.size() };
+  while (len > 1) {
+    const std::size_t half{ len / 2 };
+    lo   = (xs[lo + half] <= t) ? lo + half : lo;
+    len -= half;
+  }
+  return lo;
 }
 
-
 void interpol_pchip_impl::swap(interpol_pchip_impl& other)
 {
   using std::swap;
@@ -253,8 +270,8 @@ closest boundary is returned
 real_t interpol_pchip_impl::operator()(real_t x) const
 {
   assert_valid();
-  
-  return (*spline)(range_x().limit_to(x));
+  const real_t t{ range_x().limit_to(x) };
+  return spline->eval(spline->find(t), t);
 }
 
 
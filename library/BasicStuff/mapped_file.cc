@@ -0,0 +1,46 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace EOS_Toolkit;
+
+
+mapped_file::mapped_file(const std::string& path)
+{
+  const int fd{ ::open(path.c_str(), O_RDONLY) };
+  if (fd < 0) {
+    throw std::runtime_error("mapped_file: cannot open " + path + " ("
+                             + std::strerror(errno) + ")");
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    const int e{ errno };
+    ::close(fd);
+    throw std::runtime_error("mapped_file: cannot stat " + path + " ("
+                             + std::strerror(e) + ")");
+  }
+  if (st.st_size <= 0) {
+    ::close(fd);
+    throw std::runtime_error("mapped_file: empty file " + path);
+  }
+  len = static_cast<std::size_t>(st.st_size);
+  void* p{ ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0) };
+  const int e{ errno };
+  ::close(fd);  // mapping stays valid
+  if (p == MAP_FAILED) {
+    throw std::runtime_error("mapped_file: cannot map " + path + " ("
+                             + std::strerror(e) + ")");
+  }
+  addr = static_cast<const char*>(p);
+}
+
+mapped_file::~mapped_file()
+{
+  ::munmap(const_cast<char*>(addr), len);
+}
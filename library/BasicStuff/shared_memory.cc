@@ -0,0 +1,99 @@
+#include "shared_memory.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace EOS_Toolkit;
+
+namespace {
+
+std::runtime_error shm_error(const std::string& what,
+                             const std::string& name, int e)
+{
+  return std::runtime_error("shared_memory: cannot " + what + " "
+                            + name + " (" + std::strerror(e) + ")");
+}
+
+}
+
+auto shared_memory::create(const std::string& name, std::size_t size)
+-> std::shared_ptr<shared_memory>
+{
+  const int fd{ ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL,
+                           0644) };
+  if (fd < 0) {
+    if (errno == EEXIST) return nullptr;
+    throw shm_error("create", name, errno);
+  }
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    const int e{ errno };
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    throw shm_error("resize", name, e);
+  }
+  void* p{ ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fd, 0) };
+  const int e{ errno };
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    ::shm_unlink(name.c_str());
+    throw shm_error("map", name, e);
+  }
+  return std::shared_ptr<shared_memory>(
+           new shared_memory(static_cast<char*>(p), size));
+}
+
+auto shared_memory::attach(const std::string& name, double timeout)
+-> std::shared_ptr<const shared_memory>
+{
+  const int fd{ ::shm_open(name.c_str(), O_RDONLY, 0) };
+  if (fd < 0) {
+    if (errno == ENOENT) return nullptr;
+    throw shm_error("open", name, errno);
+  }
+  using clock = std::chrono::steady_clock;
+  const auto deadline = clock::now()
+                  + std::chrono::duration_cast<clock::duration>(
+                      std::chrono::duration<double>(timeout));
+  struct stat st;
+  while (true) {
+    if (::fstat(fd, &st) != 0) {
+      const int e{ errno };
+      ::close(fd);
+      throw shm_error("stat", name, e);
+    }
+    if (st.st_size > 0) break;
+    if (clock::now() > deadline) {
+      ::close(fd);
+      throw std::runtime_error("shared_memory: timeout waiting for "
+                               + name);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  const std::size_t size{ static_cast<std::size_t>(st.st_size) };
+  void* p{ ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) };
+  const int e{ errno };
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    throw shm_error("map", name, e);
+  }
+  return std::shared_ptr<const shared_memory>(
+           new shared_memory(static_cast<char*>(p), size));
+}
+
+bool shared_memory::remove(const std::string& name)
+{
+  return ::shm_unlink(name.c_str()) == 0;
+}
+
+shared_memory::~shared_memory()
+{
+  ::munmap(addr, len);
+}
@@ -0,0 +1,116 @@
+#include "c2p_stats.h"
+#include "hdf5store.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace EOS_Toolkit {
+
+
+c2p_mhd_stats::c2p_mhd_stats(unsigned int max_iters_)
+: max_iters{max_iters_},
+  by_status(report::ERR_CODE_NOT_SET + 1, 0),
+  hist_iters(max_iters_ + 1, 0)
+{}
+
+
+c2p_mhd_stats& c2p_mhd_stats::operator+=(const c2p_mhd_stats& o)
+{
+  if (o.max_iters != max_iters) {
+    throw invalid_argument("c2p_mhd_stats: cannot merge statistics "
+                           "with different histogram sizes");
+  }
+  for (size_t k = 0; k < by_status.size(); ++k) {
+    by_status[k] += o.by_status[k];
+  }
+  for (size_t k = 0; k < hist_iters.size(); ++k) {
+    hist_iters[k] += o.hist_iters[k];
+  }
+  atmo      += o.atmo;
+  adjust    += o.adjust;
+  sum_iters += o.sum_iters;
+  return *this;
+}
+
+
+void c2p_mhd_stats::clear()
+{
+  fill(by_status.begin(), by_status.end(), 0);
+  fill(hist_iters.begin(), hist_iters.end(), 0);
+  atmo      = 0;
+  adjust    = 0;
+  sum_iters = 0;
+}
+
+
+auto c2p_mhd_stats::num_calls() const -> count_t
+{
+  count_t n{0};
+  for (count_t c : by_status) n += c;
+  return n;
+}
+
+
+auto c2p_mhd_stats::num_failed() const -> count_t
+{
+  return num_calls() - by_status[report::SUCCESS];
+}
+
+
+real_t c2p_mhd_stats::mean_iters() const
+{
+  const count_t n{ num_calls() };
+  return (n == 0) ? 0. : real_t(sum_iters) / real_t(n);
+}
+
+
+string c2p_mhd_stats::status_name(report::err_code s)
+{
+  switch (s) {
+    case report::SUCCESS:                return "SUCCESS";
+    case report::INVALID_DETG:           return "INVALID_DETG";
+    case report::NEG_BSQR:               return "NEG_BSQR";
+    case report::NANS_IN_CONS:           return "NANS_IN_CONS";
+    case report::RANGE_RHO:              return "RANGE_RHO";
+    case report::RANGE_EPS:              return "RANGE_EPS";
+    case report::SPEED_LIMIT:            return "SPEED_LIMIT";
+    case report::RANGE_YE:               return "RANGE_YE";
+    case report::B_LIMIT:                return "B_LIMIT";
+    case report::ROOT_FAIL_CONV:         return "ROOT_FAIL_CONV";
+    case report::ROOT_FAIL_BRACKET:      return "ROOT_FAIL_BRACKET";
+    case report::PREP_ROOT_FAIL_CONV:    return "PREP_ROOT_FAIL_CONV";
+    case report::PREP_ROOT_FAIL_BRACKET: return "PREP_ROOT_FAIL_BRACKET";
+    case report::ERR_CODE_NOT_SET:       return "ERR_CODE_NOT_SET";
+  }
+  return "UNKNOWN";
+}
+
+
+void c2p_mhd_stats::save(datasink g) const
+{
+  g["num_calls"]   = double(num_calls());
+  g["num_atmo"]    = double(atmo);
+  g["num_adjust"]  = double(adjust);
+  g["total_iters"] = double(sum_iters);
+  g["max_iters"]   = int(max_iters);
+
+  auto gs = g / "status";
+  for (size_t k = 0; k < by_status.size(); ++k) {
+    auto s = static_cast<report::err_code>(k);
+    gs[status_name(s)] = double(by_status[k]);
+  }
+
+  g["iters_histogram"] = vector<double>(hist_iters.begin(),
+                                        hist_iters.end());
+}
+
+
+void save_c2p_mhd_stats(std::string fname, const c2p_mhd_stats& s)
+{
+  auto g = make_hdf5_file_sink(fname);
+  s.save(g / "c2p_mhd_stats");
+}
+
+}
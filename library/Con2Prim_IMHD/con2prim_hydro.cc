@@ -0,0 +1,202 @@
+/*! \file con2prim_hydro.cc
+\brief Primitive variable recovery algorithm for pure hydrodynamics
+*/
+
+#include "con2prim_hydro.h"
+#include "con2prim_imhd_internals.h"
+#include "eos_thermal_static.h"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "find_roots.h"
+
+using namespace EOS_Toolkit;
+using namespace EOS_Toolkit::detail;
+using namespace std;
+
+
+con2prim_hydro::con2prim_hydro(eos_thermal eos_, real_t rho_strict_,
+    bool ye_lenient_, real_t z_lim_, const atmosphere& atmo_,
+    real_t acc_, int max_iter_)
+: eos(std::move(eos_)), rho_strict(rho_strict_),
+  ye_lenient(ye_lenient_), z_lim(z_lim_), atmo(atmo_), acc(acc_),
+  max_iter(max_iter_),
+  eos_s(std::make_shared<const eos_thermal_static>(eos))
+{
+  w_lim = sqrt(1.0 + z_lim*z_lim);
+  v_lim = z_lim / w_lim;
+}
+
+
+/**
+Same as froot::froot() with \f$ b=0 \f$.
+**/
+froot_hydro::froot_hydro(const eos_thermal& eos_, real_t valid_ye,
+      real_t d_, real_t qtot_, real_t rsqr_, cache& last_ )
+: eos(eos_), h0(eos_.minimal_h()),
+  rho_range(eos_.range_rho()), d(d_), qtot(qtot_), rsqr(rsqr_),
+  last(last_)
+{
+  assert(eos.range_ye().contains(valid_ye));
+  last.ye    = valid_ye;
+  last.x     = 1.0;
+  last.calls = 0;
+
+  real_t zsqrinf = rsqr / (h0*h0);
+  real_t wsqrinf = 1 + zsqrinf;
+  winf    = sqrt(wsqrinf);
+  vsqrinf = zsqrinf / wsqrinf;
+}
+
+
+real_t froot_hydro::operator()(const real_t mu)
+{
+  return eval(c2p_eos_generic{eos}, mu);
+}
+
+
+bool froot_hydro::stopif(real_t mu, real_t dmu, real_t acc) const
+{
+  return fabs(dmu) * last.w * last.w < mu * acc;
+}
+
+
+/**
+For \f$ b=0 \f$, the root of the auxiliary function f_upper is
+known analytically, \f$ \mu_+ = 1 / \sqrt{h_0^2 + r^2} \f$.
+We add a small margin to account for roundoff errors.
+**/
+auto froot_hydro::initial_bracket() const -> interval<real_t>
+{
+  const real_t margin{ 10 * numeric_limits<real_t>::epsilon() };
+  const real_t mu_max{ (1.0 + margin) / sqrt(h0*h0 + rsqr) };
+  return {0., min(mu_max, 1.0 / h0)};
+}
+
+
+/**
+This is the condition under which rarecase might modify the bracket.
+**/
+bool froot_hydro::rho_may_leave_range() const
+{
+  return (d > rho_range.max()) || (d < winf * rho_range.min());
+}
+
+
+void con2prim_hydro::set_to_nan(prim_vars& pv, cons_vars& cv)
+{
+  pv.set_to_nan();
+  cv.set_to_nan();
+}
+
+
+/**
+This follows the same steps as con2prim_mhd::operator()(), omitting
+everything related to the magnetic field. The rare case where the
+density might leave the EOS range during root finding is handled
+by the same code as for MHD, since performance does not matter there.
+The steps after root finding are shared with the MHD case.
+**/
+template<class E>
+void con2prim_hydro::recover(const E& e, prim_vars& pv, cons_vars& cv,
+                             const sm_metric3& g, report& errs) const
+{
+  errs.iters        = 0;
+  errs.adjust_cons  = false;
+  errs.set_atmo     = false;
+  errs.status       = report::SUCCESS;
+
+  if ((!isfinite(g.vol_elem)) || (g.vol_elem <= 0)) {
+    errs.set_invalid_detg(g.vol_elem);
+    set_to_nan(pv, cv);
+    return;
+  }
+
+  c2p_mhd_cell c;
+  c.d = cv.dens / g.vol_elem;
+
+  if (c.d <= atmo.rho_cut) {
+    errs.set_atmo_set();
+    atmo.set(pv, cv, g);
+    return;
+  }
+
+  const sm_vec3l rl   = cv.scon / cv.dens;
+  c.ru                = g.raise(rl);
+  c.rsqr              = c.ru * rl;
+  c.rb                = 0;
+  c.rbsqr             = 0;
+  c.bsqr              = 0;
+  c.bu                = ZERO;
+  c.q                 = cv.tau / cv.dens;
+  c.ye0               = cv.tracer_ye / cv.dens;
+
+  if ((!isfinite(c.d)) || (!isfinite(c.rsqr)) || (!isfinite(c.ye0)) ||
+      (!isfinite(c.q)))
+  {
+    errs.set_nans_in_cons(c.d, c.q, c.rsqr, 0., 0., c.ye0);
+    set_to_nan(pv, cv);
+    return;
+  }
+
+  c.ye = eos.range_ye().limit_to(c.ye0);
+
+  froot_hydro f{eos, c.ye, c.d, c.q, c.rsqr, c.sol};
+
+  c.bracket = f.initial_bracket();
+
+  if (f.rho_may_leave_range()) {
+    froot fm{eos, c.ye, c.d, c.q, c.rsqr, 0., 0., c.sol};
+    rarecase nc(c.bracket, eos.range_rho(), fm);
+
+    if (nc.rho_too_big)
+    {
+      errs.set_range_rho(c.d, c.d);
+      set_to_nan(pv, cv);
+      return;
+    }
+
+    if (nc.rho_too_small)
+    {
+      errs.set_atmo_set();
+      atmo.set(pv, cv, g);
+      return;
+    }
+
+    c.bracket   = nc.bracket;
+    c.rho_big   = nc.rho_big;
+    c.rho_small = nc.rho_small;
+  }
+
+  ROOTSTAT status;
+  froot_eos<E, froot_hydro> fe{f, e};
+  findroot_no_deriv(fe, c.bracket, acc, max_iter, status);
+
+  const c2p_policy p{eos, atmo, rho_strict, ye_lenient, v_lim, w_lim};
+  p.finalize(c, status, pv, cv, g, errs);
+}
+
+
+/// Visitor calling the recovery with the EOS interface suitable for
+/// a given implementation type.
+struct con2prim_hydro::recover_pointwise {
+  const con2prim_hydro& c2p;
+  prim_vars& pv;
+  cons_vars& cv;
+  const sm_metric3& g;
+  report& errs;
+
+  template<class E>
+  void operator()(const E& e) const
+  {
+    c2p.recover(c2p_eos(e, c2p.eos), pv, cv, g, errs);
+  }
+};
+
+
+void con2prim_hydro::operator()(prim_vars& pv, cons_vars& cv,
+                                const sm_metric3& g,
+                                report& errs) const
+{
+  eos_s->visit(recover_pointwise{*this, pv, cv, g, errs});
+}
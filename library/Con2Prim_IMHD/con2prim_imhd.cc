@@ -3,22 +3,59 @@
 */
 
 #include "con2prim_imhd_internals.h"
+#include "eos_thermal_static.h"
 #include <cassert>
 #include <cmath>
 #include <limits>
 #include "find_roots.h"
+#include <stdexcept>
 
 using namespace EOS_Toolkit;
 using namespace EOS_Toolkit::detail;
 using namespace std;
 
 
+namespace {
+
+/**
+For the ideal gas, pressure and its derivatives are trivial, and the
+Newton method needs fewer evaluations of the master function.
+**/
+auto select_solver(con2prim_mhd::root_solver s, const eos_thermal& eos)
+-> con2prim_mhd::root_solver
+{
+  using rs = con2prim_mhd::root_solver;
+  if (s != rs::AUTO) return s;
+  if (eos.implementation_as<implementations::eos_idealgas>() != nullptr)
+  {
+    return rs::NEWTON;
+  }
+  return rs::TOMS748;
+}
+
+}
+
+void EOS_Toolkit::detail::press_derivs_limited(
+  const implementations::eos_hybrid& e, real_t rho, real_t eps_raw, 
+  real_t ye, real_t& eps, real_t& p, real_t& dp_drho, real_t& dp_deps)
+{
+  const auto s = e.press_derivs_limited(rho, eps_raw, ye);
+  eps     = s.eps;
+  p       = s.press;
+  dp_drho = s.dpress_drho;
+  dp_deps = s.dpress_deps;
+}
+
+
 con2prim_mhd::con2prim_mhd(eos_thermal eos_, real_t rho_strict_, 
     bool ye_lenient_, real_t z_lim_, real_t b_lim_, 
-    const atmosphere& atmo_, real_t acc_, int max_iter_) 
+    const atmosphere& atmo_, real_t acc_, int max_iter_, 
+    root_solver solver_) 
 : eos(std::move(eos_)), rho_strict(rho_strict_), 
   ye_lenient(ye_lenient_), z_lim(z_lim_),
-  bsqr_lim(b_lim_*b_lim_), atmo(atmo_), acc(acc_), max_iter(max_iter_)
+  bsqr_lim(b_lim_*b_lim_), atmo(atmo_), acc(acc_), max_iter(max_iter_),
+  solver(select_solver(solver_, eos)),
+  eos_s(std::make_shared<const eos_thermal_static>(eos))
 {
   w_lim = sqrt(1.0 + z_lim*z_lim);
   v_lim = z_lim / w_lim;
@@ -203,47 +240,42 @@ real_t froot::get_eps_raw(const real_t mu, const real_t qf,
   return w * (qf - mu * rfsqr*(1.0 - mu * w / (1 + w)));
 }
 
+real_t froot::operator()(const real_t mu) 
+{
+  return eval(c2p_eos_generic{eos}, mu);
+}
+
+
 /**
-This implements the master root function as defined in the 
-article: https://doi.org/10.1103/PhysRevD.103.023018
+The narrow bracket is only used if the density cannot leave the valid
+range of the EOS for any \f$ \mu \f$ (see rarecase). In that case
+the root of the master function is unique within 
+\f$ [0, 1/h_0] \f$, and any bracket within that interval leads to
+the correct solution. The width of the bracket is scaled with 
+\f$ 1 - v^2 \f$ at the guess, since the velocity becomes increasingly
+sensitive to \f$ \mu \f$ for large Lorentz factors, as does the 
+convergence criterion.
 **/
-real_t froot::operator()(const real_t mu) 
+bool froot::hint_bracket(real_t mu_hint, interval<real_t>& b) const
 {
-  cache& c{last};
+  if (!((mu_hint > 0) && isfinite(mu_hint))) return false;
   
-  c.lmu               = mu;
-  c.x                 = x_from_mu(mu);
-  const real_t rfsqr  = rfsqr_from_mu_x(mu, c.x);
-  const real_t qf     = qf_from_mu_x(mu, c.x);
-  c.vsqr              = rfsqr * mu*mu;
+  if ((d > rho_range.max()) || (d < winf * rho_range.min())) {
+    return false;
+  }
   
+  const real_t x{ x_from_mu(mu_hint) };
+  const real_t vsqr{ rfsqr_from_mu_x(mu_hint, x) * mu_hint * mu_hint };
+  if (vsqr >= vsqrinf) return false;
   
-  if (c.vsqr >= vsqrinf) {
-    c.vsqr = vsqrinf;
-    c.w    = winf;
-  } else {
-    c.w    = 1 / sqrt(1 - c.vsqr);
-  }
-
-  c.rho_raw     = d / c.w;
-  c.rho         = rho_range.limit_to(c.rho_raw);
-
-  c.eps_raw     = get_eps_raw(mu, qf, rfsqr, c.w);
-  c.eps         = eos.range_eps(c.rho, c.ye).limit_to(c.eps_raw); 
-
-  c.press       = eos.at_rho_eps_ye(c.rho, c.eps, c.ye).press();
-  ++c.calls;
-
+  const real_t dmu{ mu_hint * hint_width * (1.0 - vsqr) };
+  const real_t mu_min{ mu_hint - dmu };
+  const real_t mu_max{ min(mu_hint + dmu, 1.0 / h0) };
 
-  const real_t a        = c.press / (c.rho * (1. + c.eps));
-
-  const real_t h        = (1 + c.eps) * (1 + a);
-  
-  const real_t hbw_raw  = (1 + a) * (1 + qf - mu * rfsqr);
-  const real_t hbw      = max(hbw_raw, h / c.w);     
-  const real_t newmu    = 1 / (hbw + rfsqr * mu);
+  if (mu_max <= mu_min) return false;
   
-  return mu - newmu; 
+  b = {mu_min, mu_max};
+  return true;
 }
 
 
@@ -293,8 +325,17 @@ void con2prim_mhd::set_to_nan(prim_vars_mhd& pv,
 }
 
 
-void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv, 
-                               const sm_metric3& g, report& errs) const
+/**
+This performs all steps before setting up the master root function:
+checking the input for validity, handling of the atmosphere cut, and
+computing the parameters of the master function.
+
+@return Whether recovery has to continue. If not, pv, cv, and errs 
+        are already set to the final result.
+**/
+bool con2prim_mhd::prepare(c2p_mhd_cell& c, prim_vars_mhd& pv, 
+                           cons_vars_mhd& cv, const sm_metric3& g, 
+                           report& errs) const
 {
   errs.iters        = 0;
   errs.adjust_cons  = false;
@@ -304,84 +345,129 @@ void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv,
   if ((!isfinite(g.vol_elem)) || (g.vol_elem <= 0)) {
     errs.set_invalid_detg(g.vol_elem);
     set_to_nan(pv, cv);
-    return;
+    return false;
   } 
 
   pv.B      = cv.bcons / g.vol_elem;
 
-  const real_t d = cv.dens / g.vol_elem;
+  c.d = cv.dens / g.vol_elem;
 
-  if (d <= atmo.rho_cut) {
+  if (c.d <= atmo.rho_cut) {
     errs.set_atmo_set();
     atmo.set(pv, cv, g);
-    return;
+    return false;
   }
 
-  const sm_vec3u bu   = cv.bcons / (g.vol_elem * sqrt(d));
+  c.bu                = cv.bcons / (g.vol_elem * sqrt(c.d));
   const sm_vec3l rl   = cv.scon / cv.dens;
 
-  const sm_vec3u ru   = g.raise(rl);
-  const real_t rsqr   = ru * rl;
-  const real_t rb     = rl * bu;
-  const real_t rbsqr  = rb * rb;
-  const real_t bsqr   = g.contract(bu, bu);
-  const real_t q      = cv.tau / cv.dens;
-  const real_t ye0    = cv.tracer_ye / cv.dens;
+  c.ru                = g.raise(rl);
+  c.rsqr              = c.ru * rl;
+  c.rb                = rl * c.bu;
+  c.rbsqr             = c.rb * c.rb;
+  c.bsqr              = g.contract(c.bu, c.bu);
+  c.q                 = cv.tau / cv.dens;
+  c.ye0               = cv.tracer_ye / cv.dens;
 
-  if ((!isfinite(d)) || (!isfinite(rsqr))  || (!isfinite(ye0)) ||
-      (!isfinite(q)) || (!isfinite(rbsqr)) || (!isfinite(bsqr))) 
+  if ((!isfinite(c.d)) || (!isfinite(c.rsqr))  || (!isfinite(c.ye0)) ||
+      (!isfinite(c.q)) || (!isfinite(c.rbsqr)) || (!isfinite(c.bsqr))) 
   {
-    errs.set_nans_in_cons(d, q, rsqr, rbsqr, bsqr, ye0);
+    errs.set_nans_in_cons(c.d, c.q, c.rsqr, c.rbsqr, c.bsqr, c.ye0);
     set_to_nan(pv, cv);
-    return;
+    return false;
   }     
 
-  if (bsqr < 0) 
+  if (c.bsqr < 0) 
   {
-    errs.set_neg_bsqr(bsqr);
+    errs.set_neg_bsqr(c.bsqr);
     set_to_nan(pv, cv);
-    return;
+    return false;
   }
 
-  if (bsqr > bsqr_lim) 
+  if (c.bsqr > bsqr_lim) 
   {
-    errs.set_b_limit(bsqr);
+    errs.set_b_limit(c.bsqr);
     set_to_nan(pv, cv);
-    return; 
+    return false; 
   }
   
-  const real_t ye = eos.range_ye().limit_to(ye0);
+  c.ye = eos.range_ye().limit_to(c.ye0);
 
+  return true;
+}
 
-  froot::cache sol{};
-  froot f{eos, ye, d, q, rsqr, rbsqr, bsqr, sol}; 
 
+/**
+This finds the initial root bracket, and deals with the rare case 
+that density might leave the valid range of the EOS while solving.
+
+@return Whether root finding is required. If not, pv, cv, and errs 
+        are already set to the final result.
+**/
+bool con2prim_mhd::find_bracket(c2p_mhd_cell& c, const froot& f,
+                                prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                                const sm_metric3& g, 
+                                report& errs) const
+{
   auto bracket = f.initial_bracket(errs);
   
   if (errs.failed()) {
     set_to_nan(pv, cv);
-    return;
+    return false;
   }
   
   rarecase nc(bracket, eos.range_rho(), f);
 
   if (nc.rho_too_big) 
   {
-    errs.set_range_rho(d, d);
+    errs.set_range_rho(c.d, c.d);
     set_to_nan(pv, cv);
-    return;
+    return false;
   }
 
   if (nc.rho_too_small) 
   {
     errs.set_atmo_set();
     atmo.set(pv, cv, g);
-    return;
+    return false;
   }
 
+  c.bracket   = nc.bracket;
+  c.rho_big   = nc.rho_big;
+  c.rho_small = nc.rho_small;
   
-  ROOTSTAT status;  
-  bracket = findroot_no_deriv(f, nc.bracket, acc, max_iter, status);
+  return true;
+}
+
+
+namespace {
+
+/// Electric field is only part of the MHD primitives
+void set_efield(prim_vars&, const sm_metric3&) {}
+
+void set_efield(prim_vars_mhd& pv, const sm_metric3& g)
+{
+  sm_vec3l El = g.cross_product(pv.B, pv.vel);
+  pv.E = g.raise(El);
+}
+
+}
+
+
+/**
+This performs all steps after the root finding: dealing with 
+failures of the root solver, applying the error policy, and 
+computing the remaining primitive variables from the solution.
+It is used for both MHD and pure hydro, which differ only in the
+presence of the magnetic field. For the latter, the cell has to 
+contain \f$ r^l b_l = 0 \f$ and \f$ b^i = 0 \f$.
+**/
+template<class PV, class CV>
+void c2p_policy::finalize(const c2p_mhd_cell& c, ROOTSTAT status, 
+                          PV& pv, CV& cv, const sm_metric3& g, 
+                          c2p_mhd_report& errs) const
+{
+  const froot::cache& sol{ c.sol };
   
   errs.iters = sol.calls;
   if (status != ROOTSTAT::SUCCESS) {
@@ -389,23 +475,23 @@ void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv,
       errs.set_root_conv();
     }
     else if (status == ROOTSTAT::NOT_BRACKETED) {
-      if (nc.rho_big) { 
-        errs.set_range_rho(d, d);
-        set_to_nan(pv, cv);
+      if (c.rho_big) { 
+        errs.set_range_rho(c.d, c.d);
+        pv.set_to_nan();
+        cv.set_to_nan();
         return;
       }
-      if (nc.rho_small) {
+      if (c.rho_small) {
         errs.set_atmo_set();
         atmo.set(pv, cv, g);
         return;
       }
       errs.set_root_bracket();
     }
-    set_to_nan(pv, cv);
+    pv.set_to_nan();
+    cv.set_to_nan();
     return;
   }
-  assert(bracket.contains(sol.lmu));
-
   
   if (sol.rho < atmo.rho_cut) {
     errs.set_atmo_set();
@@ -418,7 +504,8 @@ void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv,
     errs.adjust_cons = true;
     if (sol.rho >= rho_strict) {
       errs.set_range_eps(sol.eps_raw);
-      set_to_nan(pv, cv);
+      pv.set_to_nan();
+      cv.set_to_nan();
       return;
     }
   }
@@ -427,11 +514,12 @@ void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv,
   }
     
   
-  if (! eos.range_ye().contains(ye0) ) {
+  if (! eos.range_ye().contains(c.ye0) ) {
     errs.adjust_cons = true;
     if ((!ye_lenient) && (sol.rho >= rho_strict)) {
-      errs.set_range_ye(ye0);
-      set_to_nan(pv, cv);
+      errs.set_range_ye(c.ye0);
+      pv.set_to_nan();
+      cv.set_to_nan();
       return;
     }
   }
@@ -440,15 +528,16 @@ void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv,
   pv.eps    = sol.eps;
   pv.ye     = sol.ye;
   pv.press  = sol.press;
-  pv.vel    = sol.lmu * sol.x  * (ru + (rb * sol.lmu) * bu);
+  pv.vel    = sol.lmu * sol.x  * (c.ru + (c.rb * sol.lmu) * c.bu);
   pv.w_lor  = sol.w;
 
   real_t sol_v = sqrt(sol.vsqr);
   if (sol_v > v_lim) {
-    pv.rho        = d / w_lim;
+    pv.rho        = c.d / w_lim;
     if (pv.rho >= rho_strict) {
       errs.set_speed_limit(sol_v);
-      set_to_nan(pv, cv);
+      pv.set_to_nan();
+      cv.set_to_nan();
       return;
     }
     pv.vel       *= v_lim / sol_v;
@@ -461,8 +550,7 @@ void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv,
     errs.adjust_cons = true;   
   }
 
-  sm_vec3l El = g.cross_product(pv.B, pv.vel);
-  pv.E = g.raise(El);
+  set_efield(pv, g);
 
   if (errs.adjust_cons) {
     cv.from_prim(pv, g);
@@ -470,6 +558,202 @@ void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv,
 }
 
 
+void con2prim_mhd::finalize(const c2p_mhd_cell& c, ROOTSTAT status,
+                            prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                            const sm_metric3& g, report& errs) const
+{
+  const c2p_policy p{eos, atmo, rho_strict, ye_lenient, v_lim, w_lim};
+  p.finalize(c, status, pv, cv, g, errs);
+}
+
+
+/**
+The result is cached in the root function object, and the returned
+bracket contains the root as well as the point of the last evaluation.
+**/
+template<class E>
+auto con2prim_mhd::solve_root(froot& f, const E& e, 
+                              interval<real_t> bracket, 
+                              ROOTSTAT& status) const -> interval<real_t>
+{
+  if (solver == root_solver::NEWTON) {
+    froot_eos_deriv<E> fd{f, e};
+    return findroot_newton_safe(fd, bracket, acc, max_iter, status);
+  }
+  froot_eos<E> fe{f, e};
+  return findroot_no_deriv(fe, bracket, acc, max_iter, status);
+}
+
+
+/**
+The EOS interface e is only used for evaluating the master root 
+function, which is where almost all EOS calls happen. It has to
+represent the same EOS as the one stored in this object.
+
+If a valid guess for the root is provided, we first try to find the 
+root within a narrow bracket around the guess. If the root is not 
+contained in it, or the guess cannot be used safely, we use the 
+standard algorithm. 
+**/
+template<class E>
+void con2prim_mhd::recover(const E& e, real_t mu_hint, 
+                           prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                           const sm_metric3& g, report& errs) const
+{
+  c2p_mhd_cell c;
+  if (!prepare(c, pv, cv, g, errs)) return;
+  
+  froot f{eos, c.ye, c.d, c.q, c.rsqr, c.rbsqr, c.bsqr, c.sol}; 
+  
+  ROOTSTAT status{ ROOTSTAT::NOT_BRACKETED };  
+  interval<real_t> bracket;
+  
+  if (f.hint_bracket(mu_hint, bracket)) {
+    bracket = solve_root(f, e, bracket, status);
+  }
+  
+  if (status != ROOTSTAT::SUCCESS) {
+    if (!find_bracket(c, f, pv, cv, g, errs)) return;
+    bracket = solve_root(f, e, c.bracket, status);
+  }
+  assert((status != ROOTSTAT::SUCCESS) || bracket.contains(c.sol.lmu));
+  
+  finalize(c, status, pv, cv, g, errs);
+}
+
+
+/// Visitor calling the pointwise recovery with the EOS interface 
+/// suitable for a given implementation type.
+struct con2prim_mhd::recover_pointwise {
+  const con2prim_mhd& c2p;
+  real_t mu_hint;
+  prim_vars_mhd& pv;
+  cons_vars_mhd& cv;
+  const sm_metric3& g;
+  report& errs;
+
+  template<class E>
+  void operator()(const E& e) const
+  {
+    c2p.recover(c2p_eos(e, c2p.eos), mu_hint, pv, cv, g, errs);
+  }
+};
+
+
+void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                               const sm_metric3& g, report& errs) const
+{
+  (*this)(pv, cv, g, errs, NAN);
+}
+
+
+void con2prim_mhd::operator()(prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                               const sm_metric3& g, report& errs,
+                               real_t mu_hint) const
+{
+  eos_s->visit(recover_pointwise{*this, mu_hint, pv, cv, g, errs});
+}
+
+
+/**
+Computes \f$ \mu = \frac{1}{h W} \f$ from 
+\f$ h = 1 + \epsilon + \frac{P}{\rho} \f$. Returns NAN if the 
+primitives are not valid, which means no hint is used.
+**/
+real_t con2prim_mhd::root_hint(const prim_vars_mhd& pv)
+{
+  if (!(pv.rho > 0)) return NAN;
+  const real_t h{ 1.0 + pv.eps + pv.press / pv.rho };
+  return 1.0 / (h * pv.w_lor);
+}
+
+
+namespace {
+
+template<class E>
+auto get_eos_impl(const eos_thermal& eos) -> const E&
+{
+  const E* p{ eos.implementation_as<E>() };
+  if (p == nullptr) {
+    throw std::invalid_argument("con2prim_mhd_t: EOS is not of the "
+                                "type required by specialization");
+  }
+  return *p;
+}
+
+}
+
+
+template<class E>
+con2prim_mhd_t<E>::con2prim_mhd_t(eos_thermal eos_, 
+    real_t rho_strict_, bool ye_lenient_, real_t z_lim_, 
+    real_t b_lim_, const atmosphere& atmo_, real_t acc_, 
+    int max_iter_, root_solver solver_) 
+: con2prim_mhd(eos_, rho_strict_, ye_lenient_, z_lim_, b_lim_, atmo_,
+               acc_, max_iter_, solver_), 
+  eos_impl(get_eos_impl<E>(eos_))
+{}
+
+
+template<class E>
+void con2prim_mhd_t<E>::operator()(prim_vars_mhd& pv, 
+                   cons_vars_mhd& cv, const sm_metric3& g, 
+                   report& errs) const
+{
+  recover(eos_impl, NAN, pv, cv, g, errs);
+}
+
+
+template<class E>
+void con2prim_mhd_t<E>::operator()(prim_vars_mhd& pv, 
+                   cons_vars_mhd& cv, const sm_metric3& g, 
+                   report& errs, real_t mu_hint) const
+{
+  recover(eos_impl, mu_hint, pv, cv, g, errs);
+}
+
+
+template<class E>
+void con2prim_mhd_t<E>::operator()(std::size_t ncells,
+                   const prim_vars_mhd_arrays& pv,
+                   const cons_vars_mhd_arrays& cv,
+                   const sm_metric3_arrays& g,
+                   std::uint8_t* status, const real_t* mu_hint,
+                   c2p_mhd_stats* stats, std::uint16_t* iters) const
+{
+  recover_batch(eos_impl, ncells, pv, cv, g, status, mu_hint, stats, 
+                iters);
+}
+
+
+namespace EOS_Toolkit {
+template void detail::c2p_policy::finalize(const c2p_mhd_cell& c, 
+  ROOTSTAT status, prim_vars_mhd& pv, cons_vars_mhd& cv, 
+  const sm_metric3& g, c2p_mhd_report& errs) const;
+template void detail::c2p_policy::finalize(const c2p_mhd_cell& c, 
+  ROOTSTAT status, prim_vars& pv, cons_vars& cv, 
+  const sm_metric3& g, c2p_mhd_report& errs) const;
+
+template class con2prim_mhd_t<implementations::eos_idealgas>;
+template class con2prim_mhd_t<implementations::eos_hybrid>;
+
+template auto con2prim_mhd::solve_root(froot& f, 
+  const c2p_eos_generic& e, interval<real_t> bracket, 
+  ROOTSTAT& status) const -> interval<real_t>;
+template auto con2prim_mhd::solve_root(froot& f, 
+  const implementations::eos_idealgas& e, interval<real_t> bracket, 
+  ROOTSTAT& status) const -> interval<real_t>;
+template auto con2prim_mhd::solve_root(froot& f, 
+  const implementations::eos_hybrid& e, interval<real_t> bracket, 
+  ROOTSTAT& status) const -> interval<real_t>;
+template auto con2prim_mhd::solve_root(froot& f, 
+  const implementations::eos_thermal_tabulated& e, 
+  interval<real_t> bracket, ROOTSTAT& status) const 
+  -> interval<real_t>;
+template auto con2prim_mhd::solve_root(froot& f, 
+  const c2p_eos_table& e, interval<real_t> bracket, 
+  ROOTSTAT& status) const -> interval<real_t>;
+}
 
 
 
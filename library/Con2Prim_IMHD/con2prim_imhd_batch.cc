@@ -0,0 +1,259 @@
+/*! \file con2prim_imhd_batch.cc
+\brief Primitive recovery for arrays of cells
+*/
+
+#include "con2prim_imhd_lanes.h"
+#include "c2p_stats.h"
+#include "eos_thermal_static.h"
+#include "find_roots.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <exception>
+#include <memory>
+
+using namespace EOS_Toolkit;
+using namespace EOS_Toolkit::detail;
+
+namespace {
+
+/// Number of cell groups a thread processes before fetching new work.
+const long long batch_chunk_size{ 256 / c2p_lane_width };
+
+}
+
+
+/**
+Each cell is first prepared separately. The master root function is 
+then solved in lockstep for all cells of the group that require it.
+Cells for which the lockstep solver fails are solved again with the 
+selected pointwise root solver, so that error handling is the same as
+for the pointwise version. Evolved variables of failed cells are not
+written back, so that the recovery can be repeated by diagnose().
+For cells with a usable guess, the lockstep 
+solver uses a narrow bracket around the guess. If that fails, the 
+standard bracket is computed before solving again.
+**/
+template<class E>
+void con2prim_mhd::recover_group(const E& e, 
+                                 std::size_t first, int count,
+                                 const prim_vars_mhd_arrays& pv,
+                                 const cons_vars_mhd_arrays& cv,
+                                 const sm_metric3_arrays& g,
+                                 std::uint8_t* status,
+                                 const real_t* mu_hint,
+                                 c2p_mhd_stats* stats,
+                                 std::uint16_t* iters) const
+{
+  constexpr int N{ c2p_lane_width };
+  assert((count > 0) && (count <= N));
+  
+  cons_vars_mhd cvl[N];
+  prim_vars_mhd pvl[N];
+  sm_metric3 gl[N];
+  report rep[N];
+  c2p_mhd_cell cells[N];
+  interval<real_t> bracket[N];
+  bool used[N];
+  bool hinted[N];
+  ROOTSTAT rstat[N];
+  
+  froot_lanes<N, E> f(eos, e);
+  bool any_used{ false };
+  
+  for (int l = 0; l < N; ++l) {
+    used[l]   = false;
+    hinted[l] = false;
+    if (l >= count) continue;
+    
+    const std::size_t k{ first + l };
+    c2p_mhd_cell& c{ cells[l] };
+    cvl[l]  = cv.gather(k);
+    gl[l]   = g.gather(k);
+    if (!prepare(c, pvl[l], cvl[l], gl[l], rep[l])) continue;
+
+    froot fl{eos, c.ye, c.d, c.q, c.rsqr, c.rbsqr, c.bsqr, c.sol}; 
+    hinted[l] = (mu_hint != nullptr) 
+                && fl.hint_bracket(mu_hint[k], bracket[l]);
+    if (!hinted[l]) {
+      if (!find_bracket(c, fl, pvl[l], cvl[l], gl[l], rep[l])) continue;
+      bracket[l] = c.bracket;
+    }
+    
+    f.set_lane(l, c.ye, c.d, c.q, c.rsqr, c.rbsqr, c.bsqr);
+    used[l]  = true;
+    any_used = true;
+  }
+  
+  if (any_used) {
+    findroot_lockstep(f, bracket, acc, max_iter, used, rstat);
+  }
+  
+  for (int l = 0; l < count; ++l) {
+    c2p_mhd_cell& c{ cells[l] };
+    if (used[l]) {
+      bool solved{ true };
+      if (rstat[l] == ROOTSTAT::SUCCESS) {
+        f.get_lane(l, c.sol);
+      }
+      else {
+        //Count evaluations in lockstep and fallback, as pointwise
+        f.get_lane(l, c.sol);
+        const unsigned int calls_lockstep{ c.sol.calls };
+        froot fs{eos, c.ye, c.d, c.q, c.rsqr, c.rbsqr, c.bsqr, c.sol}; 
+        solved = (!hinted[l]) 
+                 || find_bracket(c, fs, pvl[l], cvl[l], gl[l], rep[l]);
+        if (solved) {
+          solve_root(fs, e, c.bracket, rstat[l]);
+          c.sol.calls += calls_lockstep;
+        }
+      }
+      if (solved) {
+        finalize(c, rstat[l], pvl[l], cvl[l], gl[l], rep[l]);
+      }
+    }
+
+    const std::size_t k{ first + l };
+    pv.scatter(k, pvl[l]);
+    if (rep[l].adjust_cons && !rep[l].failed()) {
+      cv.scatter(k, cvl[l]);
+    }
+    status[k] = rep[l].compact();
+    if (iters != nullptr) {
+      iters[k] = static_cast<std::uint16_t>(
+                   std::min<unsigned int>(rep[l].iters, 0xFFFF));
+    }
+    if (stats != nullptr) stats->add(rep[l]);
+  }
+}
+
+
+/**
+The cells are independent from each other. They are processed in 
+groups of consecutive cells, which are solved in lockstep to exploit
+SIMD instructions. Since the cost per cell varies strongly 
+(atmosphere vs. regular vs. rare cases), groups are assigned to 
+threads dynamically in chunks. Exceptions thrown while
+processing a cell cannot leave an OpenMP region, so the first one is
+stored and rethrown after all threads are done. Statistics are 
+collected per thread and merged at the end, to avoid synchronization
+per cell.
+**/
+template<class E>
+void con2prim_mhd::recover_batch(const E& e, std::size_t ncells,
+                                 const prim_vars_mhd_arrays& pv,
+                                 const cons_vars_mhd_arrays& cv,
+                                 const sm_metric3_arrays& g,
+                                 std::uint8_t* status,
+                                 const real_t* mu_hint,
+                                 c2p_mhd_stats* stats,
+                                 std::uint16_t* iters) const
+{
+  constexpr long long N{ c2p_lane_width };
+  const long long ngroups{ (static_cast<long long>(ncells) + N - 1) / N };
+  std::exception_ptr err;
+
+#pragma omp parallel
+  {
+    std::unique_ptr<c2p_mhd_stats> lstats;
+    if (stats != nullptr) {
+      lstats.reset(new c2p_mhd_stats(stats->get_max_iters()));
+    }
+
+#pragma omp for schedule(dynamic, batch_chunk_size)
+    for (long long i = 0; i < ngroups; ++i)
+    {
+      const std::size_t first{ static_cast<std::size_t>(i * N) };
+      const int count{ static_cast<int>(
+                         std::min<std::size_t>(N, ncells - first)) };
+      try {
+        recover_group(e, first, count, pv, cv, g, status, mu_hint, 
+                      lstats.get(), iters);
+      }
+      catch (...) {
+#pragma omp critical(reprimand_c2p_batch_error)
+        {
+          if (!err) err = std::current_exception();
+        }
+      }
+    }
+    
+    if (lstats) {
+#pragma omp critical(reprimand_c2p_batch_stats)
+      {
+        *stats += *lstats;
+      }
+    }
+  }
+
+  if (err) std::rethrow_exception(err);
+}
+
+
+/// Visitor calling the batched recovery with the EOS interface 
+/// suitable for a given implementation type.
+struct con2prim_mhd::recover_batched {
+  const con2prim_mhd& c2p;
+  std::size_t ncells;
+  const prim_vars_mhd_arrays& pv;
+  const cons_vars_mhd_arrays& cv;
+  const sm_metric3_arrays& g;
+  std::uint8_t* status;
+  const real_t* mu_hint;
+  c2p_mhd_stats* stats;
+  std::uint16_t* iters;
+
+  template<class E>
+  void operator()(const E& e) const
+  {
+    c2p.recover_batch(c2p_eos(e, c2p.eos), ncells, pv, cv, g, status,
+                      mu_hint, stats, iters);
+  }
+};
+
+
+void con2prim_mhd::operator()(std::size_t ncells,
+                              const prim_vars_mhd_arrays& pv,
+                              const cons_vars_mhd_arrays& cv,
+                              const sm_metric3_arrays& g,
+                              std::uint8_t* status,
+                              const real_t* mu_hint,
+                              c2p_mhd_stats* stats,
+                              std::uint16_t* iters) const
+{
+  eos_s->visit(recover_batched{*this, ncells, pv, cv, g, status, 
+                              mu_hint, stats, iters});
+}
+
+
+auto con2prim_mhd::diagnose(std::size_t i, 
+                            const cons_vars_mhd_arrays& cv,
+                            const sm_metric3_arrays& g,
+                            const real_t* mu_hint) const -> report
+{
+  cons_vars_mhd cvi{ cv.gather(i) };
+  prim_vars_mhd pvi;
+  report rep;
+  (*this)(pvi, cvi, g.gather(i), rep, 
+          (mu_hint != nullptr) ? mu_hint[i] : NAN);
+  return rep;
+}
+
+
+namespace EOS_Toolkit {
+
+template void con2prim_mhd::recover_batch(
+  const implementations::eos_idealgas& e, std::size_t ncells, 
+  const prim_vars_mhd_arrays& pv, const cons_vars_mhd_arrays& cv,
+  const sm_metric3_arrays& g, std::uint8_t* status, 
+  const real_t* mu_hint, c2p_mhd_stats* stats, 
+  std::uint16_t* iters) const;
+
+template void con2prim_mhd::recover_batch(
+  const implementations::eos_hybrid& e, std::size_t ncells, 
+  const prim_vars_mhd_arrays& pv, const cons_vars_mhd_arrays& cv,
+  const sm_metric3_arrays& g, std::uint8_t* status, 
+  const real_t* mu_hint, c2p_mhd_stats* stats, 
+  std::uint16_t* iters) const;
+
+}
@@ -0,0 +1,184 @@
+/*! \file con2prim_imhd_lanes.h
+\brief Master root function for groups of cells evaluated in lockstep.
+*/
+
+#ifndef CON2PRIM_IMHD_LANES_H
+#define CON2PRIM_IMHD_LANES_H
+
+#include "con2prim_imhd_internals.h"
+#include <algorithm>
+#include <cmath>
+
+namespace EOS_Toolkit {
+namespace detail {
+
+/// Number of cells solved in lockstep, matching the SIMD width.
+#if defined(__AVX512F__)
+constexpr int c2p_lane_width{ 8 };
+#else
+constexpr int c2p_lane_width{ 4 };
+#endif
+
+
+/// Master root function for a group of N cells (lanes).
+/** This computes the same function as froot, for N independent
+    sets of parameters at once. All parameters and intermediate
+    results are stored as arrays over lanes, so that the arithmetic
+    can be vectorized. Only the EOS calls are done lane by lane.
+    Lanes that are not active are not evaluated, and their cached
+    results are left unchanged. The arithmetic loops are free of
+    branches, but vectorizing the square root requires compiling
+    with -fno-math-errno (set by the build system), and the loops are
+    only vectorized at -O3 or with -ftree-vectorize. The EOS interface
+    E is the same as for froot::eval().
+**/
+template<int N, class E>
+class froot_lanes {
+  using range   = eos_thermal::range;
+
+  const E& eos;             ///< The EOS interface.
+  const real_t h0;          ///< Lower bound for enthalpy, \f$ h_0 \f$
+  const range rho_range;    ///< Valid density interval of the EOS.
+  real_t d[N];              ///< \f$ d = \frac{D}{\sqrt{\det(g_{ij})}} \f$
+  real_t qtot[N];           ///< \f$ q = \frac{\tau}{D}  \f$
+  real_t rsqr[N];           ///< \f$ r^2 = \frac{ S_i S^i}{D^2} \f$
+  real_t rbsqr[N];          ///< \f$ (r^l b_l)^2 \f$
+  real_t bsqr[N];           ///< \f$ b^2 = \frac{B^2}{D} \f$
+  real_t brosqr[N];         ///< \f$ b^2 r^2 - (r^lb_l)^2 \f$
+  real_t winf[N];           ///< Upper bound for Lorentz factor
+  real_t vsqrinf[N];        ///< Upper bound for squared velocity
+
+  public:
+
+  using value_t = real_t;
+
+  ///Intermediate results of last evaluation, for each lane.
+  struct cache {
+    real_t ye[N];
+    real_t lmu[N];
+    real_t x[N];
+    real_t rho[N];
+    real_t rho_raw[N];
+    real_t eps[N];
+    real_t eps_raw[N];
+    real_t press[N];
+    real_t vsqr[N];
+    real_t w[N];
+    unsigned int calls[N];
+  } last;
+
+  /// Constructor. All lanes are set to a harmless dummy state.
+  froot_lanes(const eos_thermal& eos_, const E& e)
+  : eos(e), h0(eos_.minimal_h()), rho_range(eos_.range_rho())
+  {
+    for (int l = 0; l < N; ++l) {
+      set_lane(l, eos_.range_ye().min(), rho_range.max(), 0, 0, 0, 0);
+      last.rho[l]   = rho_range.max();
+      last.eps[l]   = 0;
+      last.press[l] = 0;
+      last.w[l]     = 1;
+    }
+  }
+
+  /// Set the parameters for one lane, same as froot constructor.
+  void set_lane(int l, real_t valid_ye, real_t d_, real_t qtot_,
+                real_t rsqr_, real_t rbsqr_, real_t bsqr_)
+  {
+    d[l]      = d_;
+    qtot[l]   = qtot_;
+    rsqr[l]   = rsqr_;
+    rbsqr[l]  = rbsqr_;
+    bsqr[l]   = bsqr_;
+    brosqr[l] = rsqr_ * bsqr_ - rbsqr_;
+
+    real_t zsqrinf = rsqr_ / (h0*h0);
+    real_t wsqrinf = 1 + zsqrinf;
+    winf[l]    = std::sqrt(wsqrinf);
+    vsqrinf[l] = zsqrinf / wsqrinf;
+
+    last.ye[l]    = valid_ye;
+    last.calls[l] = 0;
+  }
+
+  /// Copy the results of the last evaluation of one lane.
+  void get_lane(int l, froot::cache& c) const
+  {
+    c.ye      = last.ye[l];
+    c.lmu     = last.lmu[l];
+    c.x       = last.x[l];
+    c.rho     = last.rho[l];
+    c.rho_raw = last.rho_raw[l];
+    c.eps     = last.eps[l];
+    c.eps_raw = last.eps_raw[l];
+    c.press   = last.press[l];
+    c.vsqr    = last.vsqr[l];
+    c.w       = last.w[l];
+    c.calls   = last.calls[l];
+  }
+
+  /**\brief Evaluate the root function for all active lanes
+
+  This uses the same formulas as froot::operator(). The resulting
+  values for inactive lanes are meaningless.
+  **/
+  void operator()(const real_t (&mu)[N], real_t (&f)[N],
+                  const bool (&active)[N])
+  {
+    real_t x[N], rfsqr[N], qf[N], vsqr[N], w[N], rho_raw[N],
+           rho[N], eps_raw[N];
+
+    for (int l = 0; l < N; ++l) {
+      x[l]           = 1 / (1 + mu[l] * bsqr[l]);
+      rfsqr[l]       = x[l] * (rsqr[l] * x[l]
+                               + mu[l] * (x[l] + 1.0) * rbsqr[l]);
+      const real_t mux{ mu[l] * x[l] };
+      qf[l]          = qtot[l] - (bsqr[l] + mux*mux*brosqr[l]) / 2;
+      const real_t v2{ rfsqr[l] * mu[l]*mu[l] };
+      vsqr[l]        = std::min(v2, vsqrinf[l]);
+      //Computed unconditionally (argument is positive) and selected, 
+      //so the loop has no branches
+      const real_t wv{ 1 / std::sqrt(1 - vsqr[l]) };
+      w[l]           = (v2 >= vsqrinf[l]) ? winf[l] : wv;
+      rho_raw[l]     = d[l] / w[l];
+      rho[l]         = std::min(std::max(rho_range.min(), rho_raw[l]),
+                                rho_range.max());
+      eps_raw[l]     = w[l] * (qf[l] - mu[l] * rfsqr[l]
+                               * (1.0 - mu[l] * w[l] / (1 + w[l])));
+    }
+
+    for (int l = 0; l < N; ++l) {
+      if (!active[l]) continue;
+      last.lmu[l]     = mu[l];
+      last.x[l]       = x[l];
+      last.vsqr[l]    = vsqr[l];
+      last.w[l]       = w[l];
+      last.rho_raw[l] = rho_raw[l];
+      last.rho[l]     = rho[l];
+      last.eps_raw[l] = eps_raw[l];
+      const auto pl   = eos.press_limited(rho[l], eps_raw[l], 
+                                          last.ye[l]);
+      last.eps[l]     = pl.eps;
+      last.press[l]   = pl.press;
+      ++last.calls[l];
+    }
+
+    for (int l = 0; l < N; ++l) {
+      const real_t a{ last.press[l] / (rho[l] * (1. + last.eps[l])) };
+      const real_t h{ (1 + last.eps[l]) * (1 + a) };
+      const real_t hbw_raw{ (1 + a) * (1 + qf[l] - mu[l] * rfsqr[l]) };
+      const real_t hbw{ std::max(hbw_raw, h / w[l]) };
+      f[l] = mu[l] - 1 / (hbw + rfsqr[l] * mu[l]);
+    }
+  }
+
+  /// The convergence criterion for root finding, same as froot.
+  bool stopif(int l, real_t mu, real_t dmu, real_t acc) const
+  {
+    return std::fabs(dmu) * last.w[l] * last.w[l] < mu * acc;
+  }
+};
+
+}
+}
+
+#endif
@@ -6,12 +6,14 @@
 #define CON2PRIM_MHD_ERROR_H
 
 #include <string>
+#include <cstdint>
 #include "config.h"
 
 namespace EOS_Toolkit {
 
 class con2prim_mhd;
-namespace detail {class froot;}
+class con2prim_hydro;
+namespace detail {class froot; struct c2p_policy;}
 
 ///Struct to represent the outcome of a con2prim call.
 /**
@@ -45,6 +47,17 @@ struct c2p_mhd_report  {
     ERR_CODE_NOT_SET
   };
   
+  /**\brief Layout of compact outcome representation
+  
+  The compact form stores the outcome in a single byte. The lower 
+  bits contain the err_code, the upper bits flags.
+  **/
+  enum compact_bits : std::uint8_t {
+    COMPACT_ERR_MASK    = 0x3F,  ///<Bits containing err_code
+    COMPACT_ADJUST_CONS = 0x40,  ///<Set if adjust_cons is true
+    COMPACT_SET_ATMO    = 0x80   ///<Set if set_atmo is true
+  };
+  
   ///Default constructor, resulting object invalid.
   c2p_mhd_report() = default;
   
@@ -66,6 +79,38 @@ struct c2p_mhd_report  {
   **/
   bool failed() const {return status != SUCCESS;}        
   
+  /// Outcome (status and flags) encoded in a single byte
+  std::uint8_t compact() const 
+  {
+    return static_cast<std::uint8_t>(status) 
+           | (adjust_cons ? COMPACT_ADJUST_CONS : 0)
+           | (set_atmo ? COMPACT_SET_ATMO : 0);
+  }
+  
+  /// Obtain err_code from compact outcome, see compact()
+  static err_code status_of(std::uint8_t c) 
+  {
+    return static_cast<err_code>(c & COMPACT_ERR_MASK);
+  }
+  
+  /// Whether compact outcome represents failure, see compact()
+  static bool failed(std::uint8_t c) 
+  {
+    return status_of(c) != SUCCESS;
+  }
+  
+  /// Whether compact outcome has adjust_cons set, see compact()
+  static bool adjust_cons_of(std::uint8_t c) 
+  {
+    return (c & COMPACT_ADJUST_CONS) != 0;
+  }
+  
+  /// Whether compact outcome has set_atmo set, see compact()
+  static bool set_atmo_of(std::uint8_t c) 
+  {
+    return (c & COMPACT_SET_ATMO) != 0;
+  }
+  
   
   /// SUCCESS or reason for failure. 
   err_code status{ERR_CODE_NOT_SET};
@@ -155,7 +200,9 @@ struct c2p_mhd_report  {
   
   
   friend class con2prim_mhd;
+  friend class con2prim_hydro;
   friend class detail::froot;
+  friend struct detail::c2p_policy;
 };
 
 }
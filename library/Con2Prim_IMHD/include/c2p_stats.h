@@ -0,0 +1,126 @@
+/*! \file c2p_stats.h
+\brief Class definitions for aggregated statistics of primitive recovery.
+*/
+
+#ifndef C2P_STATS_H
+#define C2P_STATS_H
+
+#include <string>
+#include <vector>
+#include "config.h"
+#include "c2p_report.h"
+#include "datastore.h"
+
+namespace EOS_Toolkit {
+
+/**\brief Aggregated statistics of primitive recovery outcomes
+
+This collects the outcome of many primitive recoveries: the number of
+calls per \ref c2p_mhd_report::err_code, how often the atmosphere was
+enforced or the evolved variables adjusted, and a histogram of the
+number of root function evaluations.
+
+Collecting is opt-in: pass the report of each recovery to add().
+Objects are not thread-safe. Each thread should use its own
+collector, and the results combined using operator+=(). The batched
+recovery does this internally.
+**/
+class c2p_mhd_stats {
+  public:
+
+  using report  = c2p_mhd_report;
+  using count_t = unsigned long long;
+
+  /**\brief Constructor
+
+  @param max_iters_ Iteration counts above this are collected in
+                    the last bin of the histogram.
+  **/
+  explicit c2p_mhd_stats(unsigned int max_iters_ = 100);
+
+  /// Add outcome of a single recovery.
+  void add(const report& rep)
+  {
+    const unsigned int k{ (rep.status < report::ERR_CODE_NOT_SET)
+                          ? rep.status : report::ERR_CODE_NOT_SET };
+    ++by_status[k];
+    if (rep.set_atmo) ++atmo;
+    if (rep.adjust_cons) ++adjust;
+    ++hist_iters[(rep.iters < max_iters) ? rep.iters : max_iters];
+    sum_iters += rep.iters;
+  }
+
+  /**\brief Add statistics collected elsewhere, e.g. by another thread.
+
+  \throws std::invalid_argument if histogram sizes differ.
+  **/
+  c2p_mhd_stats& operator+=(const c2p_mhd_stats& o);
+
+  /// Reset all counters to zero.
+  void clear();
+
+  /// Total number of recoveries
+  count_t num_calls() const;
+
+  /// Number of recoveries with given outcome
+  count_t num_status(report::err_code s) const {return by_status.at(s);}
+
+  /// Number of failed recoveries
+  count_t num_failed() const;
+
+  /// Number of recoveries which enforced artificial atmosphere
+  count_t num_atmo() const {return atmo;}
+
+  /// Number of recoveries which adjusted the evolved variables
+  count_t num_adjust() const {return adjust;}
+
+  /// Total number of root function evaluations
+  count_t total_iters() const {return sum_iters;}
+
+  /// Average number of root function evaluations per recovery
+  real_t mean_iters() const;
+
+  /// Iteration counts collected in last bin of the histogram.
+  unsigned int get_max_iters() const {return max_iters;}
+
+  /**\brief Histogram of root function evaluations
+
+  Element i contains the number of recoveries with i evaluations,
+  except for the last element, which contains all with more than
+  get_max_iters() - 1 evaluations.
+  **/
+  const std::vector<count_t>& iters_histogram() const
+  {
+    return hist_iters;
+  }
+
+  /// Name of outcome, as used by save()
+  static std::string status_name(report::err_code s);
+
+  /**\brief Save to a datastore
+
+  Counters are stored as double precision, which is exact below
+  \f$ 2^{53} \f$.
+  **/
+  void save(datasink g) const;
+
+  private:
+
+  unsigned int max_iters;
+  std::vector<count_t> by_status;
+  std::vector<count_t> hist_iters;
+  count_t atmo{0};
+  count_t adjust{0};
+  count_t sum_iters{0};
+};
+
+/**\brief Save primitive recovery statistics to a (new) HDF5 file
+
+@param fname Path of file to create.
+@param s Statistics to save
+**/
+void save_c2p_mhd_stats(std::string fname, const c2p_mhd_stats& s);
+
+}
+
+#endif
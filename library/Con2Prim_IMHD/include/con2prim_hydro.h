@@ -0,0 +1,108 @@
+/*! \file con2prim_hydro.h
+\brief Class definitions for primitive recovery without magnetic field.
+*/
+
+#ifndef CON2PRIM_HYDRO_H
+#define CON2PRIM_HYDRO_H
+
+#include "smtensor.h"
+#include "hydro_prim.h"
+#include "hydro_cons.h"
+#include "hydro_atmo.h"
+#include "c2p_report.h"
+#include "eos_thermal.h"
+#include <memory>
+
+namespace EOS_Toolkit {
+
+class eos_thermal_static;
+
+/**\brief Class representing conservative to primitive conversion
+          for pure hydrodynamics
+
+This is a specialization of con2prim_mhd for vanishing magnetic
+field. It works on hydrodynamic variables directly and uses the
+master root function simplified for \f$ b=0 \f$. The error policy,
+artificial atmosphere, and report are the same as for con2prim_mhd.
+The result agrees with con2prim_mhd applied to the same variables
+with zero magnetic field, within the prescribed accuracy.
+**/
+class con2prim_hydro {
+  public:
+
+  using range = eos_thermal::range;
+  using report = c2p_mhd_report;
+
+
+  /**\brief Constructor
+  @param eos_          The EOS
+  @param  rho_strict_  Density above which most corrections
+                       are forbidden (strict regime)
+  @param ye_lenient_   Whether to allow restricting the electron
+                       fraction to valid range also in the strict
+                       regime
+  @param z_lim_        Speed limit in terms of \f$ z = W v \f$
+  @param atmo_         Specifies artificial atmosphere
+  @param acc_          Required accuracy \f$ \Delta \f$ (see article).
+  @param max_iter_     Maximum allowed iterations for root finding.
+  **/
+  con2prim_hydro(eos_thermal eos_, real_t rho_strict_,
+    bool ye_lenient_, real_t z_lim_, const atmosphere& atmo_,
+    real_t acc_, int max_iter_);
+
+  /**\brief Convert from conserved to primitive variables
+
+  @param pv  Recovered primitive variables will be stored here
+  @param cv  Evolved variables for which to recover primitives. If
+             corrections are applied, this contains the corrected values
+             after the call.
+  @param g   The 3-metric
+  @param errs Reports the outcome (validity, corrections, etc).
+
+  The meaning of the outcome is the same as for
+  con2prim_mhd::operator()().
+  **/
+  void operator()(prim_vars& pv, cons_vars& cv,
+                  const sm_metric3& g, report& errs) const;
+
+  /// Get prescribed accuracy
+  real_t get_acc() const {return acc;}
+
+  /// Get prescribed limit on z
+  real_t get_z_lim() const {return z_lim;}
+
+  /// Get prescribed limit on v
+  real_t get_v_lim() const {return v_lim;}
+
+  /// Get prescribed atmosphere
+  const atmosphere& get_atmo() const {return atmo;}
+
+  private:
+
+  const eos_thermal eos;
+  const real_t rho_strict;
+  const bool ye_lenient;
+  real_t v_lim;
+  real_t w_lim;
+  const real_t z_lim;
+  const atmosphere atmo;
+  const real_t acc;
+  const int max_iter;
+  /// EOS with implementation type resolved for static dispatch
+  std::shared_ptr<const eos_thermal_static> eos_s;
+
+  struct recover_pointwise;
+
+  /// Set primitives and conserved to NaN
+  static void set_to_nan(prim_vars& pv, cons_vars& cv);
+
+  /// Recovery using given EOS interface for root finding.
+  template<class E>
+  void recover(const E& e, prim_vars& pv, cons_vars& cv, 
+               const sm_metric3& g, report& errs) const;
+};
+
+}
+
+
+#endif
@@ -9,13 +9,26 @@
 #include "hydro_prim.h"
 #include "hydro_cons.h"
 #include "hydro_atmo.h"
+#include "hydro_arrays.h"
 #include "c2p_report.h"
 #include "eos_thermal.h"
+#include <memory>
 #include <string>
+#include <cstddef>
+#include <cstdint>
 
 namespace EOS_Toolkit {
 
+enum class ROOTSTAT;
+class c2p_mhd_stats;
+class eos_thermal_static;
 
+namespace implementations {
+class eos_idealgas;
+class eos_hybrid;
+}
+
+namespace detail {struct c2p_mhd_cell; class froot;}
 
 /**\brief Class representing conservative to primitive conversion 
           for ideal MHD
@@ -29,6 +42,13 @@ class con2prim_mhd {
   using range = eos_thermal::range;
   using report = c2p_mhd_report;
   
+  /// Available methods for finding the root of the master function
+  enum class root_solver {
+    TOMS748,  ///< Derivative-free TOMS748 algorithm
+    NEWTON,   ///< Newton method using derivative, safeguarded
+    AUTO      ///< NEWTON for ideal gas EOS, else TOMS748 (default)
+  };
+  
 
   /**\brief Constructor
   @param eos_          The EOS
@@ -42,10 +62,23 @@ class con2prim_mhd {
   @param atmo_         Specifies artificial atmosphere
   @param acc_          Required accuracy \f$ \Delta \f$ (see article).
   @param max_iter_     Maximum allowed iterations for root finding.
+  @param solver_       Method for finding root of master function.
+  
+  The Newton method requires derivatives of the pressure from the
+  EOS. Whether it is faster than TOMS748 depends on the relative cost
+  of those. 
+
+  The EOS implementation type is determined here, using 
+  eos_thermal_static. For the ideal gas, hybrid, and both tabulated 
+  EOS types (eos_thermal_table and eos_thermal_tabulated), the root 
+  finding then calls the EOS implementation directly, without 
+  virtual function calls. Other EOS types are called through the 
+  generic interface.
   **/
   con2prim_mhd(eos_thermal eos_, real_t rho_strict_, bool ye_lenient_,         
     real_t z_lim_, real_t b_lim_, const atmosphere& atmo_,  
-    real_t acc_, int max_iter_);
+    real_t acc_, int max_iter_, 
+    root_solver solver_ = root_solver::AUTO);
 
   /**\brief Convert from conserved to primitive variables
   
@@ -69,6 +102,103 @@ class con2prim_mhd {
   void operator()(prim_vars_mhd& pv, cons_vars_mhd& cv, 
                   const sm_metric3& g, report& errs) const;
 
+  /**\brief Convert from conserved to primitive variables, using a 
+  guess for the solution
+  
+  @param pv  Recovered primitive variables will be stored here
+  @param cv  Evolved variables, see other overload.
+  @param g   The 3-metric
+  @param errs Reports the outcome (validity, corrections, etc).
+  @param mu_hint Guess for the root \f$ \mu = \frac{1}{h W} \f$ of 
+                 the master function, e.g. from the previous timestep
+                 (see root_hint()). NAN means no guess.
+  
+  \rst
+  The result is the same as without guess, within the prescribed 
+  accuracy. If the solution is close to the guess, the root is found
+  using a narrow initial bracket, requiring fewer EOS evaluations. 
+  Otherwise, the standard algorithm is used, and the additional cost 
+  is two evaluations of the master function. The reported iteration 
+  count includes those.
+  \endrst
+  **/
+  void operator()(prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                  const sm_metric3& g, report& errs, 
+                  real_t mu_hint) const;
+
+  /**\brief Compute guess for primitive recovery from primitives
+  
+  @param pv Primitive variables, e.g. from previous timestep
+  @return Guess \f$ \mu = \frac{1}{h W} \f$ suitable for the 
+          mu_hint parameter of the recovery.
+  **/
+  static real_t root_hint(const prim_vars_mhd& pv);
+
+  /**\brief Convert from conserved to primitive variables for many 
+  cells at once.
+  
+  @param ncells Number of cells to process
+  @param pv     Arrays for storing the recovered primitive variables
+  @param cv     Arrays with evolved variables. For cells where 
+                corrections are applied, the corrected values are 
+                written back. For failed cells, they are left 
+                unchanged.
+  @param g      Arrays with the 3-metric components
+  @param status Array for storing the outcome per cell, in the 
+                compact form described in c2p_mhd_report::compact()
+  @param mu_hint Optional array with guesses for the root of the 
+                 master function, see pointwise version. NAN entries
+                 mean no guess for that cell.
+  @param stats  Optional statistics collector. If given, the outcome
+                of all cells is added to it. 
+  @param iters  Optional array for storing the number of root 
+                function evaluations per cell.
+  
+  \rst
+  The result for each cell agrees with the pointwise version within 
+  the prescribed accuracy, and the outcome is the same except for 
+  cells exactly at a threshold of the error policy, such as the 
+  speed limit. Groups of 
+  consecutive cells are solved in lockstep to make use of SIMD 
+  instructions. Cells are distributed among threads if the library was built 
+  with OpenMP support, using the number of threads set by the OpenMP 
+  runtime. This function must not be called from within a parallel 
+  region if nested parallelism is not desired. 
+  
+  Instead of a full report, only a single byte per cell is written.
+  Since the evolved variables of failed cells are not modified, the 
+  detailed report for those can be obtained afterwards using 
+  diagnose(). When collecting statistics, each thread uses a private 
+  collector, which are merged at the end.
+  \endrst
+  **/
+  void operator()(std::size_t ncells, const prim_vars_mhd_arrays& pv, 
+                  const cons_vars_mhd_arrays& cv, 
+                  const sm_metric3_arrays& g, 
+                  std::uint8_t* status, 
+                  const real_t* mu_hint = nullptr,
+                  c2p_mhd_stats* stats = nullptr,
+                  std::uint16_t* iters = nullptr) const;
+
+  /**\brief Obtain the detailed report for a cell of a batched 
+  recovery
+  
+  @param i      Index of the cell
+  @param cv     Arrays with evolved variables passed to batched 
+                recovery
+  @param g      Arrays with the 3-metric components
+  @param mu_hint Optional array with guesses passed to batched 
+                 recovery.
+  @return Report of pointwise recovery for the cell.
+  
+  This re-runs the recovery for the cell, without modifying the 
+  arrays. It is meant for failed cells, for which the evolved 
+  variables are unchanged after the batched recovery.
+  **/
+  report diagnose(std::size_t i, const cons_vars_mhd_arrays& cv, 
+                  const sm_metric3_arrays& g, 
+                  const real_t* mu_hint = nullptr) const;
+
   /// Get prescribed accuracy
   real_t get_acc() const {return acc;}
 
@@ -83,6 +213,9 @@ class con2prim_mhd {
   
   /// Get prescribed atmosphere 
   const atmosphere& get_atmo() const {return atmo;}
+
+  /// Get method used for root finding (never AUTO)
+  root_solver get_root_solver() const {return solver;}
   
   private:
   
@@ -96,13 +229,129 @@ class con2prim_mhd {
   const atmosphere atmo;         
   const real_t acc;              
   const int max_iter;            
+  const root_solver solver;
+  /// EOS with implementation type resolved for static dispatch
+  std::shared_ptr<const eos_thermal_static> eos_s;
+
+  struct recover_pointwise;
+  struct recover_batched;
 
 
   /// Set primitives and conserved to NaN
   static void set_to_nan(prim_vars_mhd& pv, cons_vars_mhd& cv);
 
+  /// Steps before root finding. Returns if recovery continues.
+  bool prepare(detail::c2p_mhd_cell& c, prim_vars_mhd& pv, 
+               cons_vars_mhd& cv, const sm_metric3& g, 
+               report& errs) const;
+
+  /// Find root bracket. Returns if root finding is needed.
+  bool find_bracket(detail::c2p_mhd_cell& c, const detail::froot& f,
+                    prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                    const sm_metric3& g, report& errs) const;
+
+  /// Steps after root finding.
+  void finalize(const detail::c2p_mhd_cell& c, ROOTSTAT status,
+                prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                const sm_metric3& g, report& errs) const;
+
+  /// Convert a group of consecutive cells, solving in lockstep.
+  template<class E>
+  void recover_group(const E& e, std::size_t first, int count, 
+                     const prim_vars_mhd_arrays& pv, 
+                     const cons_vars_mhd_arrays& cv, 
+                     const sm_metric3_arrays& g, 
+                     std::uint8_t* status, 
+                     const real_t* mu_hint, 
+                     c2p_mhd_stats* stats, 
+                     std::uint16_t* iters) const;
+  
+  protected:
+  
+  /// Find root of master function using selected method.
+  template<class E>
+  auto solve_root(detail::froot& f, const E& e, 
+                  interval<real_t> bracket, 
+                  ROOTSTAT& status) const -> interval<real_t>;
+
+  /// Pointwise recovery using given EOS interface for root finding.
+  template<class E>
+  void recover(const E& e, real_t mu_hint, prim_vars_mhd& pv, 
+               cons_vars_mhd& cv, const sm_metric3& g, 
+               report& errs) const;
+  
+  /// Batched recovery using given EOS interface for root finding.
+  template<class E>
+  void recover_batch(const E& e, std::size_t ncells, 
+                     const prim_vars_mhd_arrays& pv, 
+                     const cons_vars_mhd_arrays& cv, 
+                     const sm_metric3_arrays& g, 
+                     std::uint8_t* status, 
+                     const real_t* mu_hint, 
+                     c2p_mhd_stats* stats, 
+                     std::uint16_t* iters) const;
+};
+
+
+/**\brief Primitive recovery specialized to a given EOS implementation
+
+This works exactly like con2prim_mhd, but requires the EOS to be of
+the given implementation type. It is only kept for API compatibility.
+The generic con2prim_mhd already calls the EOS implementation 
+directly inside the root finding for all EOS types provided by the 
+library (see eos_thermal_static), so there is no performance 
+benefit.
+
+@tparam E EOS implementation type. Only 
+          implementations::eos_idealgas and 
+          implementations::eos_hybrid are supported.
+**/
+template<class E>
+class con2prim_mhd_t : public con2prim_mhd {
+  public:
+
+  /**\brief Constructor
+  
+  Same parameters as con2prim_mhd::con2prim_mhd()
+  
+  \throws std::invalid_argument if the EOS is not of type E.
+  **/
+  con2prim_mhd_t(eos_thermal eos_, real_t rho_strict_, 
+    bool ye_lenient_, real_t z_lim_, real_t b_lim_, 
+    const atmosphere& atmo_, real_t acc_, int max_iter_, 
+    root_solver solver_ = root_solver::AUTO);
+
+  /// Same as con2prim_mhd::operator()()
+  void operator()(prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                  const sm_metric3& g, report& errs) const;
+
+  /// Same as con2prim_mhd::operator()() with guess for solution
+  void operator()(prim_vars_mhd& pv, cons_vars_mhd& cv, 
+                  const sm_metric3& g, report& errs, 
+                  real_t mu_hint) const;
+
+  /// Same as batched con2prim_mhd::operator()()
+  void operator()(std::size_t ncells, const prim_vars_mhd_arrays& pv, 
+                  const cons_vars_mhd_arrays& cv, 
+                  const sm_metric3_arrays& g, 
+                  std::uint8_t* status, 
+                  const real_t* mu_hint = nullptr,
+                  c2p_mhd_stats* stats = nullptr,
+                  std::uint16_t* iters = nullptr) const;
+
+  private:
+  
+  const E& eos_impl;  ///< Owned by the EOS stored in base class
 };
 
+/// Primitive recovery specialized to ideal gas EOS
+using con2prim_mhd_idealgas = 
+  con2prim_mhd_t<implementations::eos_idealgas>;
+
+/// Primitive recovery specialized to hybrid EOS
+using con2prim_mhd_hybrid = 
+  con2prim_mhd_t<implementations::eos_hybrid>;
+
 }
 
 
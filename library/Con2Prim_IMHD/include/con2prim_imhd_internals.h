@@ -6,6 +6,13 @@
 #define CON2PRIM_IMHD_IMPL_H
 
 #include "con2prim_imhd.h"
+#include "eos_idealgas_impl.h"
+#include "eos_hybrid_impl.h"
+#include "eos_thermal_table_impl.h"
+#include "eos_thermal_tabulated_impl.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
 
 namespace EOS_Toolkit {
 namespace detail {
@@ -13,6 +20,164 @@ namespace detail {
 class rarecase;
 class f_rare;
 
+/// Adapter providing the EOS interface needed by the root function.
+/** The root function can also be evaluated using concrete EOS 
+    implementations, which provide the same interface without virtual
+    function calls.
+**/
+struct c2p_eos_generic {
+  const eos_thermal& eos;   ///< The EOS.
+
+  /// Valid range for specific energy
+  auto range_eps(real_t rho, real_t ye) const -> eos_thermal::range
+  {
+    return eos.range_eps(rho, ye);
+  }
+
+  /// Pressure, assuming valid input
+  real_t press(real_t rho, real_t eps, real_t ye) const
+  {
+    return eos.at_rho_eps_ye(rho, eps, ye).press();
+  }
+
+  /// Limited specific energy and pressure, assuming valid rho, ye
+  auto press_limited(real_t rho, real_t eps, real_t ye) const 
+  -> eos_thermal::press_limited_t
+  {
+    return eos.press_limited(rho, eps, ye);
+  }
+
+  /// Limited specific energy, pressure, and pressure derivatives, 
+  /// assuming valid rho, ye
+  void press_derivs_limited(real_t rho, real_t eps_raw, real_t ye, 
+                            real_t& eps, real_t& p, real_t& dp_drho, 
+                            real_t& dp_deps) const
+  {
+    eps           = eos.range_eps(rho, ye).limit_to(eps_raw);
+    const auto s  = eos.at_rho_eps_ye(rho, eps, ye);
+    p             = s.press();
+    dp_drho       = s.dpress_drho();
+    dp_deps       = s.dpress_deps();
+  }
+};
+
+/// Adapter for EOS tabulated in terms of temperature.
+/** This calls the implementation directly. Where the pressure is 
+    needed at given specific energy, the thermal variable is computed
+    first.
+**/
+struct c2p_eos_table {
+  const implementations::eos_thermal_table& eos;   ///< The EOS.
+
+  /// Valid range for specific energy
+  auto range_eps(real_t rho, real_t ye) const -> eos_thermal::range
+  {
+    return eos.range_eps(rho, ye);
+  }
+
+  /// Limited specific energy and pressure, assuming valid rho, ye
+  auto press_limited(real_t rho, real_t eps, real_t ye) const 
+  -> eos_thermal::press_limited_t
+  {
+    return eos.press_limited(rho, eps, ye);
+  }
+
+  /// Limited specific energy, pressure, and pressure derivatives, 
+  /// assuming valid rho, ye
+  void press_derivs_limited(real_t rho, real_t eps_raw, real_t ye, 
+                            real_t& eps, real_t& p, real_t& dp_drho, 
+                            real_t& dp_deps) const
+  {
+    eps            = eos.range_eps(rho, ye).limit_to(eps_raw);
+    const real_t th{ eos.therm_from_rho_eps_ye(rho, eps, ye) };
+    p              = eos.press(rho, th, ye);
+    dp_drho        = eos.dpress_drho(rho, th, ye);
+    dp_deps        = eos.dpress_deps(rho, th, ye);
+  }
+};
+
+/// EOS interface used for root finding with EOS implementations of 
+/// unknown type.
+inline auto c2p_eos(const implementations::eos_thermal_impl&, 
+                    const eos_thermal& eos) -> c2p_eos_generic
+{
+  return {eos};
+}
+
+/// EOS interface used for root finding with ideal gas EOS
+inline auto c2p_eos(const implementations::eos_idealgas& e, 
+                    const eos_thermal&) 
+-> const implementations::eos_idealgas&
+{
+  return e;
+}
+
+/// EOS interface used for root finding with hybrid EOS
+inline auto c2p_eos(const implementations::eos_hybrid& e, 
+                    const eos_thermal&) 
+-> const implementations::eos_hybrid&
+{
+  return e;
+}
+
+/// EOS interface used for root finding with EOS tabulated in terms
+/// of temperature
+inline auto c2p_eos(const implementations::eos_thermal_table& e, 
+                    const eos_thermal&) -> c2p_eos_table
+{
+  return {e};
+}
+
+/// EOS interface used for root finding with EOS tabulated in terms
+/// of specific energy
+inline auto c2p_eos(const implementations::eos_thermal_tabulated& e, 
+                    const eos_thermal&) 
+-> const implementations::eos_thermal_tabulated&
+{
+  return e;
+}
+
+/// Limited specific energy, pressure, and pressure derivatives for 
+/// concrete EOS implementations.
+template<class E>
+void press_derivs_limited(const E& e, real_t rho, real_t eps_raw, 
+                          real_t ye, real_t& eps, real_t& p, 
+                          real_t& dp_drho, real_t& dp_deps)
+{
+  eps     = e.range_eps(rho, ye).limit_to(eps_raw);
+  p       = e.press(rho, eps, ye);
+  dp_drho = e.dpress_drho(rho, eps, ye);
+  dp_deps = e.dpress_deps(rho, eps, ye);
+}
+
+/// Limited specific energy, pressure, and pressure derivatives for 
+/// generic EOS, using only one EOS state.
+inline void press_derivs_limited(const c2p_eos_generic& e, real_t rho, 
+                                 real_t eps_raw, real_t ye, real_t& eps,
+                                 real_t& p, real_t& dp_drho, 
+                                 real_t& dp_deps)
+{
+  e.press_derivs_limited(rho, eps_raw, ye, eps, p, dp_drho, dp_deps);
+}
+
+/// Limited specific energy, pressure, and pressure derivatives for 
+/// EOS tabulated in terms of temperature, computing the thermal 
+/// variable only once.
+inline void press_derivs_limited(const c2p_eos_table& e, real_t rho, 
+                                 real_t eps_raw, real_t ye, real_t& eps,
+                                 real_t& p, real_t& dp_drho, 
+                                 real_t& dp_deps)
+{
+  e.press_derivs_limited(rho, eps_raw, ye, eps, p, dp_drho, dp_deps);
+}
+
+/// Limited specific energy, pressure, and pressure derivatives for 
+/// the hybrid EOS, using only one evaluation of the cold EOS.
+void press_derivs_limited(const implementations::eos_hybrid& e, 
+                          real_t rho, real_t eps_raw, real_t ye, 
+                          real_t& eps, real_t& p, real_t& dp_drho, 
+                          real_t& dp_deps);
+
 /// Function object representing the root function.
 /** This contains all the fixed parameters defining the function.
     It also remembers intermediate results from the last evaluation,
@@ -24,7 +189,7 @@ class froot {
   using range   = eos_thermal::range;
   using report  = c2p_mhd_report;
 
-  const eos_thermal eos;    ///< The EOS.
+  const eos_thermal& eos;   ///< The EOS.
   const real_t h0;         ///< Lower bound for enthalpy, \f$ h_0 \f$
   const range rho_range;    ///< Valid density interval of the EOS. 
   const real_t d;          ///< \f$ d = \frac{D}{\sqrt{\det(g_{ij})}} \f$
@@ -91,11 +256,25 @@ class froot {
   /// The root function
   real_t operator()(real_t mu);
 
+  /// The root function, using given EOS interface
+  template<class E>
+  real_t eval(const E& e, real_t mu);
+
+  /// The root function and its derivative, using given EOS interface
+  template<class E>
+  auto eval_deriv(const E& e, real_t mu) -> std::pair<real_t, real_t>;
+
   /// The convergence criterion for root finding.
   bool stopif(real_t mu, real_t dmu, real_t acc) const;
 
   /// Initial guess for root finding
   auto initial_bracket(report& errs) const -> interval<real_t>;
+
+  /// Relative half-width of bracket around hint, for small velocities
+  static constexpr real_t hint_width{ 1e-2 };
+  
+  /// Narrow bracket around a guess for the root, if safe to use.
+  bool hint_bracket(real_t mu_hint, interval<real_t>& b) const;
   
   private:
   
@@ -104,6 +283,311 @@ class froot {
 
 };
 
+/**
+This implements the master root function as defined in the 
+article: https://doi.org/10.1103/PhysRevD.103.023018
+
+The EOS is provided by an object e with a method 
+press_limited(rho, eps, ye), which is either a c2p_eos_generic adapter
+or a concrete EOS implementation. Density and electron fraction are 
+always inside the valid range of the EOS. 
+**/
+template<class E>
+real_t froot::eval(const E& e, const real_t mu) 
+{
+  cache& c{last};
+  
+  c.lmu               = mu;
+  c.x                 = x_from_mu(mu);
+  const real_t rfsqr  = rfsqr_from_mu_x(mu, c.x);
+  const real_t qf     = qf_from_mu_x(mu, c.x);
+  c.vsqr              = rfsqr * mu*mu;
+  
+  
+  if (c.vsqr >= vsqrinf) {
+    c.vsqr = vsqrinf;
+    c.w    = winf;
+  } else {
+    c.w    = 1 / std::sqrt(1 - c.vsqr);
+  }
+
+  c.rho_raw     = d / c.w;
+  c.rho         = rho_range.limit_to(c.rho_raw);
+
+  c.eps_raw     = get_eps_raw(mu, qf, rfsqr, c.w);
+  const auto pl = e.press_limited(c.rho, c.eps_raw, c.ye);
+  c.eps         = pl.eps;
+  c.press       = pl.press;
+  ++c.calls;
+
+
+  const real_t a        = c.press / (c.rho * (1. + c.eps));
+
+  const real_t h        = (1 + c.eps) * (1 + a);
+  
+  const real_t hbw_raw  = (1 + a) * (1 + qf - mu * rfsqr);
+  const real_t hbw      = std::max(hbw_raw, h / c.w);     
+  const real_t newmu    = 1 / (hbw + rfsqr * mu);
+  
+  return mu - newmu; 
+}
+
+/**
+This computes the master root function together with its derivative
+with respect to \f$ \mu \f$, using the chain rule through all 
+intermediate quantities. The limited specific energy and the pressure
+derivatives are obtained together via press_derivs_limited(), which 
+requires the EOS interface to additionally provide 
+dpress_drho(rho, eps, ye) and dpress_deps(rho, eps, ye).
+
+Where density, specific energy, or velocity are limited to their 
+allowed ranges, the limited quantity is treated as constant. The 
+derivative is then only approximate, which is acceptable for a
+safeguarded Newton method. The cached intermediate results are the 
+same as for eval().
+**/
+template<class E>
+auto froot::eval_deriv(const E& e, const real_t mu) 
+-> std::pair<real_t, real_t>
+{
+  cache& c{last};
+  
+  c.lmu               = mu;
+  c.x                 = x_from_mu(mu);
+  const real_t dx     = -bsqr * c.x * c.x;
+  const real_t rfsqr  = rfsqr_from_mu_x(mu, c.x);
+  const real_t drfsqr = dx * (2 * rsqr * c.x + mu * (2 * c.x + 1) * rbsqr)
+                        + c.x * (c.x + 1) * rbsqr;
+  const real_t qf     = qf_from_mu_x(mu, c.x);
+  const real_t dqf    = -mu * c.x * (c.x + mu * dx) * brosqr;
+  c.vsqr              = rfsqr * mu*mu;
+  
+  real_t dw{ 0 };
+  if (c.vsqr >= vsqrinf) {
+    c.vsqr = vsqrinf;
+    c.w    = winf;
+  } else {
+    c.w    = 1 / std::sqrt(1 - c.vsqr);
+    dw     = c.w * c.w * c.w * (drfsqr * mu*mu + 2 * mu * rfsqr) / 2;
+  }
+
+  c.rho_raw     = d / c.w;
+  c.rho         = rho_range.limit_to(c.rho_raw);
+  const real_t drho{ (c.rho == c.rho_raw) ? -c.rho * dw / c.w : 0 };
+
+  const real_t g      = mu * c.w / (1 + c.w);
+  const real_t dg     = (c.w + mu * dw / (1 + c.w)) / (1 + c.w);
+  const real_t ef     = qf - mu * rfsqr * (1.0 - g);
+  const real_t def    = dqf - (rfsqr + mu * drfsqr) * (1.0 - g) 
+                        + mu * rfsqr * dg;
+  c.eps_raw     = c.w * ef;
+  real_t dp_drho, dp_deps;
+  press_derivs_limited(e, c.rho, c.eps_raw, c.ye, c.eps, c.press, 
+                       dp_drho, dp_deps);
+  const real_t deps{ (c.eps == c.eps_raw) ? dw * ef + c.w * def : 0 };
+  const real_t dpress = dp_drho * drho + dp_deps * deps;
+  ++c.calls;
+
+  const real_t rhoe     = c.rho * (1. + c.eps);
+  const real_t a        = c.press / rhoe;
+  const real_t da       = (dpress - a * (drho * (1. + c.eps) 
+                                         + c.rho * deps)) / rhoe;
+
+  const real_t h        = (1 + c.eps) * (1 + a);
+  const real_t dh       = deps * (1 + a) + (1 + c.eps) * da;
+  
+  const real_t hbw_raw  = (1 + a) * (1 + qf - mu * rfsqr);
+  real_t hbw{ hbw_raw };
+  real_t dhbw{ da * (1 + qf - mu * rfsqr) 
+               + (1 + a) * (dqf - rfsqr - mu * drfsqr) };
+  if (hbw_raw < h / c.w) {
+    hbw  = h / c.w;
+    dhbw = (dh - hbw * dw) / c.w;
+  }
+  
+  const real_t newmu    = 1 / (hbw + rfsqr * mu);
+  const real_t dnewmu   = -newmu * newmu * (dhbw + drfsqr * mu + rfsqr);
+  
+  return {mu - newmu, 1 - dnewmu}; 
+}
+
+/// Root function evaluated with a given EOS interface.
+/** The root function F is either froot or froot_hydro. **/
+template<class E, class F=froot>
+class froot_eos {
+  F& f;         ///< Root function
+  const E& e;   ///< The EOS interface
+  
+  public:
+  using value_t = real_t; 
+  
+  froot_eos(F& f_, const E& e_) : f(f_), e(e_) {}
+  
+  /// The root function
+  real_t operator()(real_t mu) {return f.eval(e, mu);}
+
+  /// The convergence criterion for root finding.
+  bool stopif(real_t mu, real_t dmu, real_t acc) const 
+  {
+    return f.stopif(mu, dmu, acc);
+  }
+};
+
+
+/// Master root function specialized to vanishing magnetic field.
+/** This computes the same function as froot for \f$ b=0 \f$, where
+    \f$ x=1 \f$ and fluid momentum and energy are the total ones.
+    The intermediate results are stored in the same format as for
+    froot.
+**/
+class froot_hydro {
+  using range   = eos_thermal::range;
+
+  const eos_thermal& eos;   ///< The EOS.
+  const real_t h0;          ///< Lower bound for enthalpy, \f$ h_0 \f$
+  const range rho_range;    ///< Valid density interval of the EOS. 
+  const real_t d;           ///< \f$ d = \frac{D}{\sqrt{\det(g_{ij})}} \f$
+  const real_t qtot;        ///< \f$ q = \frac{\tau}{D}  \f$
+  const real_t rsqr;        ///< \f$ r^2 = \frac{ S_i S^i}{D^2} \f$
+  real_t winf;              ///< Upper bound for Lorentz factor
+  real_t vsqrinf;           ///< Upper bound for squared velocity 
+
+  public:
+  
+  using value_t = real_t; 
+  using cache   = froot::cache;
+  
+  /// Constructor
+  froot_hydro(
+    const eos_thermal& eos_,       ///< The EOS
+    real_t valid_ye,               ///< Electron fraction
+    real_t d_,                     ///< \f$ d = \frac{D}{\sqrt{\det(g_{ij})}} \f$
+    real_t qtot_,                  ///< \f$ q = \frac{\tau}{D} \f$
+    real_t rsqr_,                  ///< \f$ r^2 = \frac{ S_i S^i}{D^2} \f$
+    cache& last_                   ///< cache for intermediate results
+  );
+
+  /// The root function
+  real_t operator()(real_t mu);
+
+  /// The root function, using given EOS interface
+  template<class E>
+  real_t eval(const E& e, real_t mu);
+
+  /// The convergence criterion for root finding.
+  bool stopif(real_t mu, real_t dmu, real_t acc) const;
+
+  /// Initial bracket for root finding
+  auto initial_bracket() const -> interval<real_t>;
+  
+  /// Whether density might leave the EOS range while root finding
+  bool rho_may_leave_range() const;
+
+  private:
+  
+  cache& last;
+};
+
+/**
+This is froot::eval() simplified for \f$ b=0 \f$, where
+\f$ \bar{r}^2 = r^2 \f$ and \f$ \bar{q} = q \f$.
+**/
+template<class E>
+real_t froot_hydro::eval(const E& e, const real_t mu)
+{
+  cache& c{last};
+
+  c.lmu         = mu;
+  c.vsqr        = rsqr * mu*mu;
+
+  if (c.vsqr >= vsqrinf) {
+    c.vsqr = vsqrinf;
+    c.w    = winf;
+  } else {
+    c.w    = 1 / std::sqrt(1 - c.vsqr);
+  }
+
+  c.rho_raw     = d / c.w;
+  c.rho         = rho_range.limit_to(c.rho_raw);
+
+  c.eps_raw     = c.w * (qtot - mu * rsqr * (1.0 - mu * c.w / (1 + c.w)));
+  const auto pl = e.press_limited(c.rho, c.eps_raw, c.ye);
+  c.eps         = pl.eps;
+  c.press       = pl.press;
+  ++c.calls;
+
+  const real_t a        = c.press / (c.rho * (1. + c.eps));
+  const real_t h        = (1 + c.eps) * (1 + a);
+  const real_t hbw_raw  = (1 + a) * (1 + qtot - mu * rsqr);
+  const real_t hbw      = std::max(hbw_raw, h / c.w);
+  const real_t newmu    = 1 / (hbw + rsqr * mu);
+
+  return mu - newmu;
+}
+
+
+/// Root function and derivative evaluated with a given EOS interface.
+template<class E>
+class froot_eos_deriv {
+  froot& f;     ///< Root function
+  const E& e;   ///< The EOS interface
+  
+  public:
+  using value_t = real_t; 
+  
+  froot_eos_deriv(froot& f_, const E& e_) : f(f_), e(e_) {}
+  
+  /// The root function and its derivative
+  auto operator()(real_t mu) -> std::pair<real_t, real_t>
+  {
+    return f.eval_deriv(e, mu);
+  }
+
+  /// The convergence criterion for root finding.
+  bool stopif(real_t mu, real_t dmu, real_t acc) const 
+  {
+    return f.stopif(mu, dmu, acc);
+  }
+};
+
+
+/// Intermediate results of the primitive recovery for one cell.
+/** This contains everything that is needed to finish the recovery
+    after the root of the master function has been found. 
+**/
+struct c2p_mhd_cell {
+  real_t d;             ///< \f$ d = \frac{D}{\sqrt{\det(g_{ij})}} \f$
+  real_t q;             ///< \f$ q = \frac{\tau}{D}  \f$
+  real_t rsqr;          ///< \f$ r^2 = \frac{ S_i S^i}{D^2} \f$
+  real_t rb;            ///< \f$ r^l b_l \f$
+  real_t rbsqr;         ///< \f$ (r^l b_l)^2 \f$
+  real_t bsqr;          ///< \f$ b^2 = \frac{B^2}{D} \f$
+  real_t ye0;           ///< Electron fraction from evolved variables
+  real_t ye;            ///< Electron fraction limited to EOS range
+  sm_vec3u ru;          ///< \f$ r^i \f$
+  sm_vec3u bu;          ///< \f$ b^i \f$
+  interval<real_t> bracket;  ///< Root bracket for master function
+  bool rho_big{false};       ///< Density possibly too large
+  bool rho_small{false};     ///< Density possibly too small
+  froot::cache sol{};        ///< Solution of master function
+};
+
+/// Error policy and artificial atmosphere used after root finding.
+struct c2p_policy {
+  const eos_thermal& eos;   ///< The EOS
+  const atmosphere& atmo;   ///< Artificial atmosphere
+  real_t rho_strict;        ///< Density where strict regime begins
+  bool ye_lenient;          ///< Allow limiting \f$ Y_e \f$ in strict regime
+  real_t v_lim;             ///< Speed limit
+  real_t w_lim;             ///< Lorentz factor at speed limit
+
+  /// Steps after root finding, shared by MHD and pure hydro recovery.
+  template<class PV, class CV>
+  void finalize(const c2p_mhd_cell& c, ROOTSTAT status, PV& pv, 
+                CV& cv, const sm_metric3& g, 
+                c2p_mhd_report& errs) const;
+};
+
 ///Class representing the auxiliary root function 
 class f_upper {
   public:
@@ -0,0 +1,646 @@
+#ifndef FIND_ROOTS_H
+#define FIND_ROOTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "intervals.h"
+
+
+namespace EOS_Toolkit {
+
+
+enum class ROOTSTAT {
+  SUCCESS, 
+  NOT_CONVERGED, 
+  NOT_BRACKETED
+};
+
+
+/// Statistics collected while finding a root.
+struct root_stats {
+  unsigned int calls{0};      ///< Function evaluations (all steps)
+  unsigned int secant{0};     ///< Secant steps
+  unsigned int quadratic{0};  ///< Quadratic interpolation steps
+  unsigned int cubic{0};      ///< Inverse cubic interpolation steps
+  unsigned int newton{0};     ///< Newton steps
+  unsigned int bisect{0};     ///< Bisection steps
+};
+
+
+namespace detail {
+
+/**\brief Helper functions for the TOMS748 algorithm
+
+This follows G. E. Alefeld, F. A. Potra and Yixun Shi, 
+"Algorithm 748: Enclosing Zeros of Continuous Functions", 
+ACM Trans. Math. Software 21 (1995), and the implementation in
+boost::math::tools::toms748_solve, which we used before. The steps
+are identical to the latter, such that iteration counts agree.
+**/
+template<class T>
+struct toms748 {
+  
+  /// Division that returns r instead of overflowing
+  static T safe_div(T num, T denom, T r)
+  {
+    if ((std::fabs(denom) < 1) 
+        && (std::fabs(denom * std::numeric_limits<T>::max()) 
+            <= std::fabs(num))) 
+    {
+      return r;
+    }
+    return num / denom;
+  }
+
+  /// Secant step, or bisection if too close to boundary
+  static T secant(T a, T b, T fa, T fb)
+  {
+    const T tol{ std::numeric_limits<T>::epsilon() * 5 };
+    const T c{ a - (fa / (fb - fa)) * (b - a) };
+    if ((c <= a + std::fabs(a) * tol) || (c >= b - std::fabs(b) * tol)) {
+      return (a + b) / 2;
+    }
+    return c;
+  }
+
+  /// Quadratic interpolation using given number of Newton steps
+  static T quadratic(T a, T b, T d, T fa, T fb, T fd, unsigned count)
+  {
+    const T big{ std::numeric_limits<T>::max() };
+    const T B{ safe_div(fb - fa, b - a, big) };
+    T A{ safe_div(fd - fb, d - b, big) };
+    A = safe_div(A - B, d - a, T(0));
+
+    if (A == 0) return secant(a, b, fa, fb);
+    
+    T c{ ((A < 0) == (fa < 0)) ? a : b };
+    
+    for (unsigned i = 1; i <= count; ++i) {
+      c -= safe_div(fa + (B + A * (c - b)) * (c - a), 
+                    B + A * (2 * c - a - b), 1 + c - a);
+    }
+    if ((c <= a) || (c >= b)) c = secant(a, b, fa, fb);
+    return c;
+  }
+
+  /// Inverse cubic interpolation
+  static T cubic(T a, T b, T d, T e, T fa, T fb, T fd, T fe)
+  {
+    const T q11{ (d - e) * fd / (fe - fd) };
+    const T q21{ (b - d) * fb / (fd - fb) };
+    const T q31{ (a - b) * fa / (fb - fa) };
+    const T d21{ (b - d) * fd / (fd - fb) };
+    const T d31{ (a - b) * fb / (fb - fa) };
+    const T q22{ (d21 - q11) * fb / (fe - fb) };
+    const T q32{ (d31 - q21) * fa / (fd - fa) };
+    const T d32{ (d31 - q21) * fd / (fd - fa) };
+    const T q33{ (d32 - q22) * fa / (fe - fa) };
+    T c{ q31 + q32 + q33 + a };
+
+    if ((c <= a) || (c >= b)) c = quadratic(a, b, d, fa, fb, fd, 3);
+    return c;
+  }
+  
+  /// Whether points are too close for cubic interpolation
+  static bool degenerate(T fa, T fb, T fd, T fe)
+  {
+    const T min_diff{ std::numeric_limits<T>::min() * 32 };
+    return (std::fabs(fa - fb) < min_diff) 
+           || (std::fabs(fa - fd) < min_diff) 
+           || (std::fabs(fa - fe) < min_diff) 
+           || (std::fabs(fb - fd) < min_diff) 
+           || (std::fabs(fb - fe) < min_diff) 
+           || (std::fabs(fd - fe) < min_diff);
+  }
+
+  /**\brief Evaluate function at c and shrink bracket [a,b] 
+  
+  The point removed from the bracket is stored in d.
+  **/
+  template<class F>
+  static void bracket(F& f, T& a, T& b, T c, T& fa, T& fb, T& d, T& fd,
+                      root_stats& st)
+  {
+    const T tol{ std::numeric_limits<T>::epsilon() * 2 };
+    
+    if ((b - a) < 2 * tol * a) {
+      c = a + (b - a) / 2;
+    }
+    else if (c <= a + std::fabs(a) * tol) {
+      c = a + std::fabs(a) * tol;
+    }
+    else if (c >= b - std::fabs(b) * tol) {
+      c = b - std::fabs(b) * tol;
+    }
+    
+    const T fc{ f(c) };
+    ++st.calls;
+    
+    if (fc == 0) {
+      a  = c;
+      fa = 0;
+      d  = 0;
+      fd = 0;
+      return;
+    }
+    
+    if ((fa < 0) != (fc < 0)) {
+      d  = b;
+      fd = fb;
+      b  = c;
+      fb = fc;
+    }
+    else {
+      d  = a;
+      fd = fa;
+      a  = c;
+      fa = fc;
+    }
+  }
+
+  /**\brief TOMS748 iteration for bracket [a,b] with known function 
+  values of opposite sign.
+  
+  Stops when f(a) is zero, `f.stopif(a, b-a, tol)` is satisfied, or 
+  the given number of calls is exhausted. 
+  
+  @return Whether the iteration converged.
+  **/
+  template<class F>
+  static bool solve(F& f, T& a, T& b, T& fa, T& fb, T tol, 
+                    unsigned int count, root_stats& st)
+  {
+    auto done = [&] () {
+      return (fa == 0) || f.stopif(a, b - a, tol);
+    };
+    
+    if (done()) return true;
+    if (count == 0) return false;
+    
+    T d, fd, e, fe;
+    fe = e = fd = 1e5F;
+
+    T c{ secant(a, b, fa, fb) };
+    ++st.secant;
+    bracket(f, a, b, c, fa, fb, d, fd, st);
+    if (done()) return true;
+    if (--count == 0) return false;
+    
+    c  = quadratic(a, b, d, fa, fb, fd, 2);
+    ++st.quadratic;
+    e  = d; 
+    fe = fd;
+    bracket(f, a, b, c, fa, fb, d, fd, st);
+    if (done()) return true;
+    if (--count == 0) return false;
+    
+    while (true) {
+      const T a0{ a };
+      const T b0{ b };
+      
+      if (degenerate(fa, fb, fd, fe)) {
+        c = quadratic(a, b, d, fa, fb, fd, 2);
+        ++st.quadratic;
+      }
+      else {
+        c = cubic(a, b, d, e, fa, fb, fd, fe);
+        ++st.cubic;
+      }
+      e  = d; 
+      fe = fd;
+      bracket(f, a, b, c, fa, fb, d, fd, st);
+      if (done()) return true;
+      if (--count == 0) return false;
+      
+      if (degenerate(fa, fb, fd, fe)) {
+        c = quadratic(a, b, d, fa, fb, fd, 3);
+        ++st.quadratic;
+      }
+      else {
+        c = cubic(a, b, d, e, fa, fb, fd, fe);
+        ++st.cubic;
+      }
+      bracket(f, a, b, c, fa, fb, d, fd, st);
+      if (done()) return true;
+      if (--count == 0) return false;
+
+      //Double-length secant step
+      const bool left{ std::fabs(fa) < std::fabs(fb) };
+      const T u{ left ? a : b };
+      const T fu{ left ? fa : fb };
+      c = u - 2 * (fu / (fb - fa)) * (b - a);
+      if (std::fabs(c - u) > (b - a) / 2) c = a + (b - a) / 2;
+      ++st.secant;
+      e  = d; 
+      fe = fd;
+      bracket(f, a, b, c, fa, fb, d, fd, st);
+      if (done()) return true;
+      if (--count == 0) return false;
+      
+      //Bisection if not converging fast enough
+      if ((b - a) < (b0 - a0) / 2) continue;
+      
+      e  = d; 
+      fe = fd;
+      ++st.bisect;
+      bracket(f, a, b, a + (b - a) / 2, fa, fb, d, fd, st);
+      if (done()) return true;
+      if (--count == 0) return false;
+    }
+  }
+};
+
+}
+
+
+
+/**\brief Find root using Newton-Raphson method
+
+The function object has to return the function value and derivative
+as a pair. The iteration stops once the step size is below the 
+relative accuracy given by the number of binary digits. Steps leaving
+the bracket are replaced by bisection.
+**/
+template<class F, class T = typename F::value_t> 
+auto findroot_using_deriv(F& f, 
+      interval<T> bracket, ROOTSTAT& errs, 
+      int digits, unsigned int max_calls=20) -> T
+{
+  if (max_calls < 4) {
+    throw std::range_error("Root finding call limit set too low for "
+                           "meaningful results");
+  }
+  
+  T a{ bracket.min() };
+  T b{ bracket.max() };
+  T fa{ f(a).first }; 
+  T fb{ f(b).first }; 
+    
+  if (fa * fb >= 0) {
+    if (fb == 0) {
+      errs = ROOTSTAT::SUCCESS;
+      return b;
+    }
+    if (fa == 0) {
+      errs = ROOTSTAT::SUCCESS;
+      return a;
+    }    
+    errs = ROOTSTAT::NOT_BRACKETED;
+    return std::numeric_limits<T>::quiet_NaN();    
+  }
+
+  //Newton-Raphson with the same safeguards and step sequence as 
+  //boost::math::tools::newton_raphson_iterate, which we used before,
+  //except for the handling of vanishing derivatives.
+  const T factor{ std::ldexp(T(1), 1 - digits) };
+  T x{ (a * fb - b * fa) / (fb - fa) };
+  T dx{ std::numeric_limits<T>::max() };
+  T dx1{ dx };
+  T dx2{ dx };
+  
+  for (unsigned int calls = 2; calls < max_calls; ++calls) {
+    dx2 = dx1;
+    dx1 = dx;
+    const auto r = f(x);
+    const T fx{ r.first };
+    const T dfx{ r.second };
+
+    if (fx == 0) {
+      errs = ROOTSTAT::SUCCESS;
+      return x;
+    }
+    
+    if (dfx == 0) {
+      //Step towards the bracket end where the sign changes
+      dx = ((fx < 0) == (fa < 0)) ? x - b : x - a;
+    }
+    else {
+      dx = fx / dfx;
+    }
+    
+    if (std::fabs(2 * dx) > std::fabs(dx2)) {
+      //Last two steps did not converge, bisect towards the root
+      const T shift{ (dx > 0) ? (x - a) / 2 : (x - b) / 2 };
+      dx  = ((x != 0) && (std::fabs(shift) > std::fabs(x))) 
+            ? std::copysign(std::fabs(x) * T(1.1F), dx) : shift;
+      dx1 = 3 * dx;
+      dx2 = 3 * dx;
+    }
+    
+    const T x0{ x };
+    x -= dx;
+    if (x <= a) {
+      dx = (x0 - a) / 2;
+      x  = x0 - dx;
+      if ((x == a) || (x == b)) {
+        errs = ROOTSTAT::SUCCESS;
+        return x;
+      }
+    }
+    else if (x >= b) {
+      dx = (x0 - b) / 2;
+      x  = x0 - dx;
+      if ((x == a) || (x == b)) {
+        errs = ROOTSTAT::SUCCESS;
+        return x;
+      }
+    }
+    
+    if (dx > 0) b = x0;
+    else        a = x0;
+    
+    if (std::fabs(dx) <= std::fabs(x * factor)) {
+      errs = ROOTSTAT::SUCCESS;
+      return x;
+    }
+  }
+
+  errs = ROOTSTAT::NOT_CONVERGED;
+  return x;  
+}
+
+template<class F, class T = typename F::value_t> 
+auto findroot_using_deriv(F& f, ROOTSTAT& errs, 
+      int digits, unsigned int max_calls=20) -> T
+{
+  return findroot_using_deriv(f, f.initial_bracket(), 
+                              errs, digits, max_calls);
+}
+
+
+/**\brief Find root without using derivatives
+
+This uses the TOMS748 algorithm. The function object has to provide 
+a convergence criterion `f.stopif(x, dx, tol)`, which is applied to
+the current bracket. The returned interval is the final bracket. 
+Optionally, statistics about the steps taken are stored in stats.
+**/
+template<class F, class T = typename  F::value_t> 
+auto findroot_no_deriv(F& f, interval<T> bracket, T tol, 
+       unsigned int max_calls, ROOTSTAT& errs, 
+       root_stats* stats=nullptr) -> interval<T>
+{
+  if (max_calls < 10) {
+    throw std::range_error("Root finding call limit set too low for "
+                      "meaningful results");
+  }
+  
+  root_stats st;
+  T a{ bracket.min() };
+  T b{ bracket.max() };
+  T fa{ f(a) }; 
+  T fb{ f(b) }; 
+  st.calls = 2;
+    
+  if (fa * fb >= 0) {
+    if (stats != nullptr) *stats = st;
+    if (fb==0) {
+      errs = ROOTSTAT::SUCCESS;
+      return {b,b};
+    }
+    if (fa==0) {
+      errs = ROOTSTAT::SUCCESS;
+      return {a,a};
+    }
+    errs = ROOTSTAT::NOT_BRACKETED;
+    return {std::numeric_limits<T>::lowest(),
+            std::numeric_limits<T>::max()};    
+  }
+  
+  const bool conv{ 
+    detail::toms748<T>::solve(f, a, b, fa, fb, tol, max_calls - 2, st) 
+  };
+  
+  if (fa == 0) b = a;
+  else if (fb == 0) a = b;
+  
+  errs = conv ? ROOTSTAT::SUCCESS : ROOTSTAT::NOT_CONVERGED;
+  if (stats != nullptr) *stats = st;
+  
+  return {a, b};
+}
+
+template<class F, class T = typename  F::value_t> 
+auto findroot_no_deriv(F& f, T tol, 
+       unsigned int max_calls, ROOTSTAT& errs) -> interval<T>
+{
+  return findroot_no_deriv(f, f.initial_bracket(), 
+                           tol, max_calls, errs);
+}
+
+
+
+/**\brief Find root using Newton's method, safeguarded by bisection
+
+The function object has to return the function value and derivative
+as a pair, and provide a convergence criterion `f.stopif(x, dx, tol)`
+analogous to the one used by findroot_no_deriv(). 
+
+The root bracket is updated after each step. If a Newton step would 
+leave the bracket, or does not reduce the step size fast enough, a 
+secant step between the bracket boundaries is used instead, or a 
+bisection step if the previous step was already such a fallback. 
+Convergence is tested for the size of the Newton step, which 
+estimates the error of the last evaluation, as long as it stays
+inside the bracket.
+The returned interval contains the last point where the function was
+evaluated. Optionally, statistics about the steps taken are stored in 
+stats.
+**/
+template<class F, class T = typename  F::value_t> 
+auto findroot_newton_safe(F& f, interval<T> bracket, T tol, 
+       unsigned int max_calls, ROOTSTAT& errs, 
+       root_stats* stats=nullptr) -> interval<T>
+{
+  if (max_calls < 10) {
+    throw std::range_error("Root finding call limit set too low for "
+                      "meaningful results");
+  }
+  
+  root_stats st;
+  T a{ bracket.min() };
+  T b{ bracket.max() };
+  const auto ra = f(a); 
+  const auto rb = f(b); 
+  T fa{ ra.first }; 
+  T fb{ rb.first }; 
+  st.calls = 2;
+    
+  if (fa * fb >= 0) {
+    if (stats != nullptr) *stats = st;
+    if (fb==0) {
+      errs = ROOTSTAT::SUCCESS;
+      return {b,b};
+    }
+    if (fa==0) {
+      errs = ROOTSTAT::SUCCESS;
+      return {a,a};
+    }
+    errs = ROOTSTAT::NOT_BRACKETED;
+    return {std::numeric_limits<T>::lowest(),
+            std::numeric_limits<T>::max()};    
+  }
+  
+  //Start with Newton step from the boundary closer to the root, or 
+  //secant step if that fails.
+  T x{ (std::fabs(fa) < std::fabs(fb)) ? a - fa / ra.second 
+                                       : b - fb / rb.second };
+  if (!((x > a) && (x < b))) x = (a * fb - b * fa) / (fb - fa);
+  if (!((x > a) && (x < b))) x = (a + b) / 2;
+  T dx{ b - a };
+  bool fallback{ false };
+  
+  for (unsigned int calls = 2; calls < max_calls; ++calls) {
+    const auto r  = f(x);
+    ++st.calls;
+    const T fx{ r.first };
+    const T dfx{ r.second };
+    
+    if (fx == 0) {
+      if (stats != nullptr) *stats = st;
+      errs = ROOTSTAT::SUCCESS;
+      return {x,x};
+    }
+    
+    if ((fx < 0) == (fa < 0)) {
+      a  = x; 
+      fa = fx;
+    }
+    else {
+      b  = x;
+      fb = fx;
+    }
+    
+    const T dx_old{ dx };
+    dx = fx / dfx;
+    const T xn{ x - dx };
+    
+    const bool inside{ (xn > a) && (xn < b) };
+    if (inside && f.stopif(x, dx, tol)) {
+      if (stats != nullptr) *stats = st;
+      errs = ROOTSTAT::SUCCESS;
+      return {std::min(x, xn), std::max(x, xn)};
+    }
+    
+    if (inside && (std::fabs(2 * dx) <= std::fabs(dx_old))) {
+      ++st.newton;
+      x = xn;
+      fallback = false;
+    }
+    else {
+      if (f.stopif(a, b - a, tol)) {
+        if (stats != nullptr) *stats = st;
+        errs = ROOTSTAT::SUCCESS;
+        return {a, b};
+      }
+      ++st.bisect;
+      dx = (b - a) / 2;
+      x  = a + dx;
+      if (!fallback) {
+        const T xs{ (a * fb - b * fa) / (fb - fa) };
+        if ((xs > a) && (xs < b)) x = xs; 
+      }
+      fallback = true;
+    }
+  }
+  
+  if (stats != nullptr) *stats = st;
+  errs = ROOTSTAT::NOT_CONVERGED;
+  return {a, b};
+}
+
+
+
+/**\brief Find roots of several independent functions in lockstep
+
+The function object evaluates N functions (lanes) at once. It has 
+to provide a method `f(x, y, active)` evaluating all lanes marked 
+as active, and a convergence criterion `f.stopif(lane, l, r-l, tol)`
+analogous to the one used by findroot_no_deriv(). 
+
+We use the Illinois variant of regula falsi. Unlike TOMS748, each 
+step performs the same arithmetic operations for all lanes, which 
+allows vectorization across lanes. Lanes are removed from the 
+iteration once converged. Unused lanes are ignored.
+**/
+template<int N, class F, class T = typename F::value_t> 
+void findroot_lockstep(F& f, const interval<T> (&bracket)[N], T tol, 
+       unsigned int max_calls, const bool (&used)[N], 
+       ROOTSTAT (&errs)[N])
+{
+  if (max_calls < 10) {
+    throw std::range_error("Root finding call limit set too low for "
+                      "meaningful results");
+  }
+  
+  T a[N], b[N], fa[N], fb[N], x[N], fx[N];
+  int side[N];
+  bool active[N];
+  
+  for (int l = 0; l < N; ++l) {
+    a[l]      = bracket[l].min();
+    b[l]      = bracket[l].max();
+    side[l]   = 0;
+    active[l] = used[l];
+  }
+  
+  f(a, fa, active);
+  f(b, fb, active);
+  unsigned int calls{ 2 };
+  
+  int nactive{ 0 };
+  for (int l = 0; l < N; ++l) {
+    if (!active[l]) continue;
+    if (fa[l] * fb[l] >= 0) {
+      errs[l]   = ((fb[l] == 0) || (fa[l] == 0)) 
+                  ? ROOTSTAT::SUCCESS : ROOTSTAT::NOT_BRACKETED;
+      active[l] = false;
+    }
+    else ++nactive;
+  }
+
+  while (nactive > 0) {
+    if (calls >= max_calls) {
+      for (int l = 0; l < N; ++l) {
+        if (active[l]) errs[l] = ROOTSTAT::NOT_CONVERGED;
+      }
+      return;
+    }
+    
+    for (int l = 0; l < N; ++l) {
+      const T xs{ (a[l] * fb[l] - b[l] * fa[l]) / (fb[l] - fa[l]) };
+      x[l] = ((xs > a[l]) && (xs < b[l])) ? xs : (a[l] + b[l]) / 2;
+    }
+    
+    f(x, fx, active);
+    ++calls;
+    
+    for (int l = 0; l < N; ++l) {
+      if (!active[l]) continue;
+      if ((fx[l] < 0) == (fb[l] < 0)) {
+        b[l]  = x[l]; 
+        fb[l] = fx[l];
+        if (side[l] < 0) fa[l] /= 2;
+        side[l] = -1;
+      }
+      else {
+        a[l]  = x[l]; 
+        fa[l] = fx[l];
+        if (side[l] > 0) fb[l] /= 2;
+        side[l] = 1;
+      }
+      if ((fx[l] == 0) || f.stopif(l, a[l], b[l] - a[l], tol)) {
+        errs[l]   = ROOTSTAT::SUCCESS;
+        active[l] = false;
+        --nactive;
+      }
+    }
+  }
+}
+
+}
+
+#endif
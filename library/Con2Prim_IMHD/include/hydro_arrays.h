@@ -0,0 +1,103 @@
+/*! \file hydro_arrays.h
+\brief Structure-of-arrays views on grid data used for batched
+primitive recovery.
+*/
+
+#ifndef HYDRO_ARRAYS_H
+#define HYDRO_ARRAYS_H
+
+#include <cstddef>
+#include "smtensor.h"
+#include "hydro_prim.h"
+#include "hydro_cons.h"
+
+namespace EOS_Toolkit {
+
+/**\brief Non-owning view on ideal MHD primitive variables stored as
+separate arrays (one per component).
+
+All pointers have to refer to arrays with at least as many elements
+as the number of cells processed. The arrays are not owned, and
+never deallocated.
+**/
+struct prim_vars_mhd_arrays {
+  real_t* rho;      ///< Rest mass density \f$ \rho \f$
+  real_t* eps;      ///< Specific internal energy \f$ \epsilon \f$
+  real_t* ye;       ///< Electron fraction \f$ Y_e \f$
+  real_t* press;    ///< Pressure \f$ P \f$
+  real_t* vel[3];   ///< 3-velocity components \f$ v^i \f$
+  real_t* w_lor;    ///< Lorentz factor \f$ W \f$
+  real_t* E[3];     ///< Electric field components \f$ E^i \f$
+  real_t* B[3];     ///< Magnetic field components \f$ B^i \f$
+
+  /// Copy primitives into cell i
+  void scatter(std::size_t i, const prim_vars_mhd& pv) const
+  {
+    rho[i]   = pv.rho;
+    eps[i]   = pv.eps;
+    ye[i]    = pv.ye;
+    press[i] = pv.press;
+    w_lor[i] = pv.w_lor;
+    for (int d=0; d<3; ++d) {
+      vel[d][i] = pv.vel(d);
+      E[d][i]   = pv.E(d);
+      B[d][i]   = pv.B(d);
+    }
+  }
+};
+
+/**\brief Non-owning view on ideal MHD conserved variables stored as
+separate arrays (one per component).
+
+The magnetic field is never modified by the primitive recovery.
+All other arrays are overwritten for cells where the evolved
+variables had to be corrected.
+**/
+struct cons_vars_mhd_arrays {
+  real_t* dens;             ///< Conserved density \f$ D \f$
+  real_t* tau;              ///< Conserved energy \f$ \tau \f$
+  real_t* tracer_ye;        ///< Electron fraction tracer \f$ Y_e^T \f$
+  real_t* scon[3];          ///< Conserved momentum \f$ S_i \f$
+  const real_t* bcons[3];   ///< Densitized magnetic field
+
+  /// Obtain evolved variables at cell i
+  auto gather(std::size_t i) const -> cons_vars_mhd
+  {
+    return {dens[i], tau[i], tracer_ye[i],
+            sm_vec3l{scon[0][i], scon[1][i], scon[2][i]},
+            sm_vec3u{bcons[0][i], bcons[1][i], bcons[2][i]}};
+  }
+
+  /// Copy evolved variables (except magnetic field) into cell i
+  void scatter(std::size_t i, const cons_vars_mhd& cv) const
+  {
+    dens[i]      = cv.dens;
+    tau[i]       = cv.tau;
+    tracer_ye[i] = cv.tracer_ye;
+    for (int d=0; d<3; ++d) {
+      scon[d][i] = cv.scon(d);
+    }
+  }
+};
+
+/**\brief Non-owning view on the components of the 3-metric
+stored as separate arrays.
+**/
+struct sm_metric3_arrays {
+  const real_t* gxx;  ///< Component \f$ g_{xx} \f$
+  const real_t* gxy;  ///< Component \f$ g_{xy} \f$
+  const real_t* gxz;  ///< Component \f$ g_{xz} \f$
+  const real_t* gyy;  ///< Component \f$ g_{yy} \f$
+  const real_t* gyz;  ///< Component \f$ g_{yz} \f$
+  const real_t* gzz;  ///< Component \f$ g_{zz} \f$
+
+  /// Obtain metric (including inverse and determinant) at cell i
+  auto gather(std::size_t i) const -> sm_metric3
+  {
+    return sm_metric3{sm_symt3l{gxx[i], gxy[i], gyy[i],
+                                gxz[i], gyz[i], gzz[i]}};
+  }
+};
+
+}
+#endif
@@ -17,7 +17,8 @@ eos_barotr_gpoly::eos_barotr_gpoly(real_t n_, real_t rmd_p_,
                                    units units_) 
 : eos_barotr_impl{units_},
   rgrho(0, rho_max_), n(n_), rmd_p(rmd_p_), np1(n + 1), 
-  gamma(1.0 + 1.0 / n), invn(1.0 / n), sed0(sed0_), h0(1.0 + sed0_)
+  gamma(1.0 + 1.0 / n), invn(1.0 / n), sed0(sed0_), h0(1.0 + sed0_),
+  pow_invn(invn), pow_n(n), pow_np1(np1)
 {
   if (h0 <= 0) {
     throw std::runtime_error("eos_barotr_gpoly: invalid energy offset "
@@ -32,7 +33,7 @@ eos_barotr_gpoly::eos_barotr_gpoly(real_t n_, real_t rmd_p_,
 */
 real_t eos_barotr_gpoly::gm1_from_rho(real_t rho) const
 {
-  return np1 * pow( rho/rmd_p, invn ) / h0;
+  return np1 * pow_invn(rho / rmd_p) / h0;
 }
 
 
@@ -51,7 +52,7 @@ real_t eos_barotr_gpoly::eps(real_t gm1) const
 */
 real_t eos_barotr_gpoly::press(real_t gm1) const
 {
-  return rmd_p * pow( h0 * gm1 / np1, np1 );
+  return rmd_p * pow_np1(h0 * gm1 / np1);
 }
 
 /**
@@ -60,7 +61,7 @@ real_t eos_barotr_gpoly::press(real_t gm1) const
 */
 real_t eos_barotr_gpoly::rho(real_t gm1) const
 {
-  return rmd_p * pow( h0 * gm1 / np1, n);
+  return rmd_p * pow_n(h0 * gm1 / np1);
 }
 
 /**
@@ -2,6 +2,7 @@
 #define EOS_BAROTR_GPOLY_IMPL_H
 #include <memory>
 #include "eos_barotropic_impl.h"
+#include "fixed_power.h"
 #include "datastore.h"
 
 namespace EOS_Toolkit {
@@ -15,7 +16,8 @@ zero density, but a value \f$ \epsilon_0 \f$. This allows the use
 of arbitrary conventions for the baryon mass.
 
 See eos_cold for notation used and eos_cold_api for a description of 
-the member functions.
+the member functions. As for eos_barotr_poly, integer and 
+half-integer indices are evaluated without calling std::pow.
 */
 class eos_barotr_gpoly : public eos_barotr_impl {
   range rgrho;
@@ -28,6 +30,9 @@ class eos_barotr_gpoly : public eos_barotr_impl {
   real_t invn;    ///< \f$ \frac{1}{n} \f$
   real_t sed0;    ///< \f$ \epsilon_0 \f$
   real_t h0;      ///< \f$ h_0 = 1 + \epsilon_0 \f$
+  detail::fixed_power pow_invn;   ///< \f$ x^{1/n} \f$
+  detail::fixed_power pow_n;      ///< \f$ x^n \f$
+  detail::fixed_power pow_np1;    ///< \f$ x^{n+1} \f$
 
   public:
 
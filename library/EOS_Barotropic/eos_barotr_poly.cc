@@ -26,6 +26,9 @@ void eos_barotr_poly::init(real_t n_, real_t rmd_p_, real_t rho_max_)
   np1   = n + 1; 
   gamma = 1.0 + 1.0 / n; 
   invn  = 1.0 / n; 
+  pow_invn = detail::fixed_power(invn);
+  pow_n    = detail::fixed_power(n);
+  pow_np1  = detail::fixed_power(np1);
   
   real_t gm1_max = gm1_from_rho(rho_max_);
   if (n < 1) {
@@ -69,7 +72,7 @@ eos_barotr_poly::eos_barotr_poly(real_t rmd_m, real_t sed_m, real_t p_m,
 */
 real_t eos_barotr_poly::gm1_from_rho(real_t rho) const
 {
-  return np1 * pow( rho/rmd_p, invn );
+  return np1 * pow_invn(rho / rmd_p);
 }
 
 
@@ -87,7 +90,7 @@ real_t eos_barotr_poly::eps(real_t gm1) const
 */
 real_t eos_barotr_poly::press(real_t gm1) const
 {
-  return rmd_p * pow( gm1 / np1, np1 );
+  return rmd_p * pow_np1(gm1 / np1);
 }
 
 /**
@@ -95,7 +98,7 @@ real_t eos_barotr_poly::press(real_t gm1) const
 */
 real_t eos_barotr_poly::rho(real_t gm1) const
 {
-  return rmd_p * pow( gm1 / np1, n);
+  return rmd_p * pow_n(gm1 / np1);
 }
 
 /**
@@ -2,6 +2,7 @@
 #define EOS_BAROTR_POLY_IMPL_H
 
 #include "eos_barotropic_impl.h"
+#include "fixed_power.h"
 
 namespace EOS_Toolkit {
 namespace implementations {
@@ -15,6 +16,10 @@ Here we use a <em>polytropic density scale</em> \f$ \rho_p \f$ to specify
 the EOS instead of the usual form \f$ P = K \rho^\Gamma \f$
 because it has simpler units than 
 \f$ K = \rho_p^{-1/n} \f$.
+
+Integer and half-integer polytropic indices, e.g. \f$ n=1 \f$ or
+\f$ n=3/2 \f$, are detected at construction and evaluated without
+calling std::pow (see detail::fixed_power).
 */
 class eos_barotr_poly : public eos_barotr_impl {
   range rgrho;
@@ -26,6 +31,9 @@ class eos_barotr_poly : public eos_barotr_impl {
   real_t np1;     ///< \f$ n+1 \f$
   real_t gamma;   ///< Polytropic exponent \f$ \Gamma \f$
   real_t invn;    ///< \f$ \frac{1}{n} \f$
+  detail::fixed_power pow_invn;   ///< \f$ x^{1/n} \f$
+  detail::fixed_power pow_n;      ///< \f$ x^n \f$
+  detail::fixed_power pow_np1;    ///< \f$ x^{n+1} \f$
 
   void init(
     real_t n_,                          ///<Adiabatic index \f$ n \f$
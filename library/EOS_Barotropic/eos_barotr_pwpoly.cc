@@ -1,5 +1,7 @@
 #include "eos_barotr_pwpoly.h"
 #include "eos_barotr_pwpoly_impl.h"
+#include "fast_logexp.h"
+#include <algorithm>
 #include <stdexcept>
 #include <cmath>
 #include <limits>
@@ -171,30 +173,55 @@ eos_barotr_pwpoly::eos_barotr_pwpoly(real_t rmdp0,
   }
   rho_max_ = segments.back().rho_max_save(rho_max_);
   
+  init_soa();
+  
   rgrho = {0, rho_max_};
   rggm1 = {0, gm1_from_rho(rho_max_)};
 }
 
+void eos_barotr_pwpoly::init_soa()
+{
+  for (const eos_poly_piece& s : segments) 
+  {
+    soa.rmd0.push_back(s.rmd0);
+    soa.gm10.push_back(s.gm10);
+    soa.rmd_p.push_back(s.rmd_p);
+    soa.dsed.push_back(s.dsed);
+    soa.gamma.push_back(s.gamma);
+    soa.n.push_back(s.n);
+    soa.np1.push_back(s.np1);
+    soa.invn.push_back(s.invn);
+  }
+}
+
+/**
+This counts the boundaries (excluding the first one) not above x, 
+without branches. For the few segments of a piecewise polytrope, this
+is faster than a search with unpredictable branches. Values below the
+first boundary, or NAN, result in the first segment.
+**/
+auto eos_barotr_pwpoly::find_segment(const std::vector<real_t>& bnd, 
+                                     real_t x)
+-> std::size_t
+{
+  std::size_t k{ 0 };
+  for (std::size_t j = 1; j < bnd.size(); ++j) {
+    k += (bnd[j] <= x);
+  }
+  return k;
+}
 
 const eos_poly_piece& 
 eos_barotr_pwpoly::segment_for_rho(real_t rho) const
 {
-  auto i = segments.rbegin();
-  while (i->rmd0 > rho) {
-    if (++i == segments.rend()) return segments[0];
-  }
-  return *i;
+  return segments[find_segment(soa.rmd0, rho)];
 }
 
 
 const eos_poly_piece& 
 eos_barotr_pwpoly::segment_for_gm1(real_t gm1) const
 {
-  auto i = segments.rbegin();
-  while (i->gm10 > gm1) {
-    if (++i == segments.rend()) return segments[0];
-  }
-  return *i;
+  return segments[find_segment(soa.gm10, gm1)];
 }
   
 
@@ -266,6 +293,91 @@ real_t eos_barotr_pwpoly::ye(real_t gm1) const
   throw std::runtime_error("eos_barotr_pwpoly: electron fraction not "
                            "defined for this EOS");
 }
+
+auto eos_barotr_pwpoly::vars(real_t gm1) const -> vars_t
+{
+  const eos_poly_piece& s{ segment_for_gm1(gm1) };
+  return {s.press_from_gm1(gm1), s.eps_from_gm1(gm1), gm1};
+}
+
+/**
+The points are processed in blocks. For each block, the segment 
+indices are computed first, then the segment constants are gathered 
+and the EOS evaluated for all points. Both loops are free of branches
+and can be vectorized by the compiler. The power functions are
+computed by detail::fast_log() and detail::fast_exp(), and the 
+pressure as \f$ P = \rho (\rho / \rho_p)^{1/n} \f$. The results 
+therefore differ from the pointwise methods by rounding errors, 
+relative deviations are below \f$ 10^{-13} \f$.
+**/
+void eos_barotr_pwpoly::eval_rho(std::size_t n, const real_t* rho, 
+                                 const result_arrays& res, 
+                                 bool* valid) const
+{
+  using detail::fast_exp;
+  using detail::fast_log;
+  
+  const std::size_t blk{ 256 };
+  const real_t nan{ numeric_limits<real_t>::quiet_NaN() };
+  const real_t tiny{ numeric_limits<real_t>::min() };
+  const real_t rho_max{ rgrho.max() };
+  const std::size_t nseg{ soa.rmd0.size() };
+  const real_t* bnd{ soa.rmd0.data() };
+  const real_t* rmdp{ soa.rmd_p.data() };
+  const real_t* dsed{ soa.dsed.data() };
+  const real_t* gamma{ soa.gamma.data() };
+  const real_t* nn{ soa.n.data() };
+  const real_t* np1{ soa.np1.data() };
+  const real_t* invn{ soa.invn.data() };
+
+  std::size_t idx[blk];
+  real_t gm1[blk], pw[blk];
+  
+  for (std::size_t i0 = 0; i0 < n; i0 += blk) 
+  {
+    const std::size_t m{ std::min(blk, n - i0) };
+    const real_t* r{ rho + i0 };
+    
+    for (std::size_t i = 0; i < m; ++i) {
+      std::size_t k{ 0 };
+      for (std::size_t j = 1; j < nseg; ++j) {
+        k += (bnd[j] <= r[i]);
+      }
+      idx[i] = k;
+    }
+    
+    for (std::size_t i = 0; i < m; ++i) {
+      const std::size_t k{ idx[i] };
+      const real_t q{ std::max(tiny, r[i] / rmdp[k]) };
+      const real_t p{ fast_exp(invn[k] * fast_log(q)) };
+      pw[i]  = (r[i] > 0) ? p : 0.0;
+      gm1[i] = np1[k] * pw[i] + dsed[k];
+    }
+    
+    for (std::size_t i = 0; i < m; ++i) {
+      const bool ok{ (r[i] >= 0) && (r[i] <= rho_max) };
+      if (valid) valid[i0 + i] = ok;
+      const std::size_t k{ idx[i] };
+      if (res.gm1) {
+        res.gm1[i0 + i] = ok ? gm1[i] : nan;
+      }
+      if (res.hm1) {
+        res.hm1[i0 + i] = ok ? gm1[i] : nan;
+      }
+      if (res.press) {
+        res.press[i0 + i] = ok ? r[i] * pw[i] : nan;
+      }
+      if (res.eps) {
+        const real_t eps{ (gm1[i] - dsed[k]) / gamma[k] + dsed[k] };
+        res.eps[i0 + i] = ok ? eps : nan;
+      }
+      if (res.csnd) {
+        const real_t cs2{ (np1[k] * pw[i]) / (nn[k] * (gm1[i] + 1.0)) };
+        res.csnd[i0 + i] = ok ? sqrt(cs2) : nan;
+      }
+    }
+  }
+}
   
   
 EOS_Toolkit::eos_barotr 
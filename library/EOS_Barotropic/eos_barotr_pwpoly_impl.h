@@ -48,6 +48,24 @@ class eos_barotr_pwpoly : public eos_barotr_impl {
 
   ///The polytropic segments
   std::vector<eos_poly_piece> segments;
+
+  ///Segment boundaries and constants, in structure-of-arrays layout
+  struct segment_arrays {
+    std::vector<real_t> rmd0;   ///< Densities of segment boundaries
+    std::vector<real_t> gm10;   ///< \f$ g-1 \f$ at segment boundaries
+    std::vector<real_t> rmd_p;  ///< Polytropic density scales
+    std::vector<real_t> dsed;   ///< Specific energy offsets
+    std::vector<real_t> gamma;  ///< Adiabatic exponents
+    std::vector<real_t> n;      ///< Polytropic indices
+    std::vector<real_t> np1;    ///< Polytropic indices plus one
+    std::vector<real_t> invn;   ///< Inverse polytropic indices
+  } soa;
+
+  void init_soa();
+
+  ///Index of segment, given sorted boundaries
+  static auto find_segment(const std::vector<real_t>& bnd, real_t x)
+  -> std::size_t;
   
   ///Find the segment responsible for a given mass density
   const eos_poly_piece& segment_for_rho(real_t rho) const;
@@ -138,6 +156,16 @@ class eos_barotr_pwpoly : public eos_barotr_impl {
     real_t gm1      ///< \f$ g-1 \f$
   ) const final;
 
+  ///Compute pressure, specific energy, and enthalpy together
+  /**Assumes input is in the valid range, no checks are performed.*/
+  auto vars(
+    real_t gm1      ///< \f$ g-1 \f$
+  ) const -> vars_t final;
+
+  ///Evaluate EOS for array of densities
+  void eval_rho(std::size_t n, const real_t* rho, 
+                const result_arrays& res, bool* valid) const final;
+
   void save(datasink s) const final;
   auto descr_str() const -> std::string final;
 
@@ -117,6 +117,43 @@ eos_barotr_spline::eos_barotr_spline(
   if (efrac_gm1) {
     efrac0    = (*efrac_gm1)(rggm1.min());
   }
+  
+  init_fused();
+}
+
+/**
+The splines for specific energy, pressure, and enthalpy are normally
+sampled at the same points. In this case, their coefficients are
+stored together per segment, such that vars() only needs one lookup.
+**/
+void eos_barotr_spline::init_fused()
+{
+  using detail::interpol_regspl_impl;
+  const interpol_regspl_impl& se{ eps_gm1.spline_z() };
+  const interpol_regspl_impl& sp{ p_gm1.spline_logy().spline_z() };
+  const interpol_regspl_impl& sh{ hm1_gm1.spline_z() };
+  
+  auto same_grid = [&se] (const interpol_regspl_impl& s) -> bool {
+    return (s.range_x().min() == se.range_x().min()) 
+           && (s.range_x().max() == se.range_x().max())
+           && (s.segments().size() == se.segments().size());
+  };
+  
+  if (!(same_grid(sp) && same_grid(sh))) return;
+  
+  const std::size_t nseg{ se.segments().size() };
+  fused.resize(nseg);
+  for (std::size_t k=0; k < nseg; ++k) 
+  {
+    const auto& ce = se.segments()[k].c;
+    const auto& cp = sp.segments()[k].c;
+    const auto& ch = sh.segments()[k].c;
+    fused[k] = {{ce[0], ce[1], ce[2], ce[3], 
+                 cp[0], cp[1], cp[2], cp[3],
+                 ch[0], ch[1], ch[2], ch[3]}};
+  }
+  fused_z0 = se.range_x().min();
+  fused_dz = se.spacing();
 }
 
 real_t eos_barotr_spline::gm1_from_rho(real_t rho) const
@@ -146,6 +183,31 @@ real_t eos_barotr_spline::hm1(real_t gm1) const
   return (gm1 >= gm1_low) ? hm1_gm1(gm1)  : poly.hm1(gm1);
 }
 
+/**
+This gives the same results as separate calls to press(), eps(), 
+and hm1(), using the same arithmetic as 
+detail::interpol_regspl_impl::operator().
+**/
+auto eos_barotr_spline::vars(real_t gm1) const -> vars_t
+{
+  if (gm1 < gm1_low) return poly.vars(gm1);
+  if (fused.empty()) return eos_barotr_impl::vars(gm1);
+  
+  using detail::interpol_logspl_impl;
+  const real_t i{ (interpol_logspl_impl::x2z(gm1) - fused_z0) 
+                  / fused_dz };
+  const real_t j{ std::max(0., floor(i)) };
+  const std::size_t k{ std::min(std::size_t(j), fused.size()-1) };
+  const real_t t{ i - k };
+  const fused_seg_t& c = fused[k];
+  
+  const real_t eps{ ((c[0] * t + c[1]) * t + c[2]) * t + c[3] };
+  const real_t lp{ ((c[4] * t + c[5]) * t + c[6]) * t + c[7] };
+  const real_t hm1{ ((c[8] * t + c[9]) * t + c[10]) * t + c[11] };
+  
+  return {interpol_logspl_impl::z2x(lp), eps, hm1};
+}
+
 real_t eos_barotr_spline::csnd(real_t gm1) const
 {
   return (gm1 >= gm1_low) ? csnd_rho(rho_gm1(gm1)) : poly.csnd(gm1);
@@ -4,6 +4,7 @@
 #include "eos_barotropic_impl.h"
 #include "eos_barotr_gpoly_impl.h"
 #include "interpol_logspl.h"
+#include <array>
 #include <vector>
 #include <boost/optional.hpp>
 
@@ -98,6 +99,13 @@ class eos_barotr_spline : public eos_barotr_impl {
     real_t gm1      ///< \f$ g-1 \f$
   ) const final;
 
+  ///Compute pressure, specific energy, and enthalpy together
+  /**Assumes input is in the valid range, no checks are performed.
+  The logarithm and segment index are computed only once.*/
+  auto vars(
+    real_t gm1      ///< \f$ g-1 \f$
+  ) const -> vars_t final;
+
   ///Compute adiabatic soundspeed \f$ c_s \f$
   /**Assumes input is in the valid range, no checks are performed.*/
   real_t csnd(
@@ -137,6 +145,11 @@ class eos_barotr_spline : public eos_barotr_impl {
                         const opt_t&, const opt_t&)  
   -> range;
 
+  ///Interleaved coefficients of \f$ \epsilon, \log(P), h-1 \f$ 
+  using fused_seg_t = std::array<real_t, 12>;
+
+  void init_fused();
+
   lglgspl_t gm1_rho;
   lgspl_t eps_gm1; 
   lglgspl_t p_gm1;
@@ -158,6 +171,11 @@ class eos_barotr_spline : public eos_barotr_impl {
   
   bool zerotemp{true};    ///< If EOS is zero temperature
   const bool isentropic;  ///< If EOS is isentropic
+
+  ///Fused splines, empty if sample points differ
+  std::vector<fused_seg_t> fused;
+  real_t fused_z0{0.};    ///< Lower bound of \f$ \log(g-1) \f$ 
+  real_t fused_dz{1.};    ///< Spacing in \f$ \log(g-1) \f$ 
 };
 
 }//namespace implementations 
@@ -1,5 +1,6 @@
 #include "eos_barotropic.h"
 #include "datastore.h"
+#include "eos_instrument.h"
 #include <stdexcept>
 #include <cassert>
 #include <limits>
@@ -48,6 +49,18 @@ class eos_barotr_invalid: public eos_barotr_impl {
   [[ noreturn ]] real_t ye(real_t) const final {throw(invalid());}
 };
 
+#ifdef REPRIMAND_EOS_INSTRUMENTATION
+std::string describe_impl(const void* p)
+{
+  try {
+    return static_cast<const eos_barotr_impl*>(p)->descr_str();
+  }
+  catch (std::exception&) {
+    return "uninitialized";
+  }
+}
+#endif
+
 }
 
 
@@ -71,12 +84,14 @@ auto eos_barotr::is_gm1_valid(real_t gm1) const -> bool
 auto eos_barotr::at_rho(real_t rho) const -> state
 {
   if (!is_rho_valid(rho)) return {};
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_gm1_from_rho);
   return {impl(), impl().gm1_from_rho(rho), rho};
 }
 
 auto eos_barotr::at_gm1(real_t gm1) const -> state
 {
   if (!is_gm1_valid(gm1)) return {};
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_rho);
   return {impl(), gm1, impl().rho(gm1)};
 }
 
@@ -92,6 +107,7 @@ auto eos_barotr::state::gm1() const -> real_t
 
 auto eos_barotr::state::press() const -> real_t 
 {
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_press);
   real_t press = impl().press(gm1_);  
   assert(press >= 0);
   return press;
@@ -106,6 +122,7 @@ auto eos_barotr::state::rho() const -> real_t
 
 auto eos_barotr::state::csnd() const -> real_t 
 {
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_csnd);
   real_t cs = impl().csnd_from_rho_gm1(rho_, gm1_);  
   assert(cs < 1.0);
   assert(cs >= 0);
@@ -114,6 +131,7 @@ auto eos_barotr::state::csnd() const -> real_t
 
 auto eos_barotr::state::temp() const -> real_t 
 {
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_temp);
   real_t temp = impl().temp(gm1_);  
   assert(temp >= 0);
   return temp;
@@ -121,6 +139,7 @@ auto eos_barotr::state::temp() const -> real_t
 
 auto eos_barotr::state::eps() const -> real_t
 {
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_eps);
   real_t eps = impl().eps(gm1_);  
   assert(eps >= -1);
   return eps;
@@ -128,6 +147,7 @@ auto eos_barotr::state::eps() const -> real_t
 
 auto eos_barotr::state::hm1() const -> real_t
 {
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_hm1);
   real_t hm1 = impl().hm1(gm1_);  
   assert(hm1 > -1);
   return hm1;
@@ -136,9 +156,20 @@ auto eos_barotr::state::hm1() const -> real_t
 
 auto eos_barotr::state::ye() const -> real_t
 {
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_ye);
   return impl().ye(gm1_);
 }
 
+auto eos_barotr::state::vars() const -> vars_t
+{
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_vars);
+  const vars_t v{ impl().vars(gm1_) };
+  assert(v.press >= 0);
+  assert(v.eps >= -1);
+  assert(v.hm1 > -1);
+  return v;
+}
+
 auto eos_barotr::gm1_at_rho(real_t rho) const -> real_t
 {
   auto s = at_rho(rho);
@@ -223,6 +254,14 @@ auto eos_barotr::ye_at_gm1(real_t gm1) const -> real_t
   return s ? s.ye() : numeric_limits<real_t>::quiet_NaN();
 }
 
+void eos_barotr::eval_at_rho(std::size_t n, const real_t* rho, 
+                             const result_arrays& res, 
+                             bool* valid) const
+{
+  EOS_INSTRUMENT(&impl(), describe_impl, barotr_eval_rho);
+  impl().eval_rho(n, rho, res, valid);
+}
+
 auto eos_barotr::units_to_SI() const -> const units&
 {
   return impl().units_to_SI();
@@ -244,6 +283,30 @@ auto eos_barotr_impl::csnd_from_rho_gm1(real_t rho, real_t gm1) const
   return csnd(gm1);
 }
 
+auto eos_barotr_impl::vars(real_t gm1) const -> vars_t
+{
+  return {press(gm1), eps(gm1), hm1(gm1)};
+}
+
+void eos_barotr_impl::eval_rho(std::size_t n, const real_t* rho, 
+                               const result_arrays& res, 
+                               bool* valid) const
+{
+  const real_t nan{ numeric_limits<real_t>::quiet_NaN() };
+  const range& rgrho{ range_rho() };
+  for (std::size_t i = 0; i < n; ++i) {
+    const bool ok{ rgrho.contains(rho[i]) };
+    if (valid) valid[i] = ok;
+    const real_t gm1{ ok ? gm1_from_rho(rho[i]) : nan };
+    if (res.gm1)   res.gm1[i]   = gm1;
+    if (res.press) res.press[i] = ok ? press(gm1) : nan;
+    if (res.eps)   res.eps[i]   = ok ? eps(gm1) : nan;
+    if (res.hm1)   res.hm1[i]   = ok ? hm1(gm1) : nan;
+    if (res.csnd)  res.csnd[i]  = ok ? csnd_from_rho_gm1(rho[i], gm1) 
+                                     : nan;
+  }
+}
+
 void eos_barotr_impl::save(datasink s) const
 {
   throw  std::runtime_error("Saving not implemented for EOS type");
@@ -20,6 +20,12 @@ class eos_barotr : detail::eos_barotr_base {
   using range  = interval<real_t>;
   
   using eos_barotr_base::impl_t;
+
+  ///Pressure, specific energy, and enthalpy, see state::vars()
+  using vars_t = impl_t::vars_t;
+
+  ///Output arrays for eval_at_rho()
+  using result_arrays = impl_t::result_arrays;
   
   ///Class representing the matter state for the eos_barotr interface 
   class state : state_base {
@@ -121,6 +127,19 @@ class eos_barotr : detail::eos_barotr_base {
     \throws std::runtime_error if composition not available for EOS
     **/
     auto ye() const -> real_t;
+
+    /**\brief Compute pressure, specific energy, and enthalpy at once
+    
+    This is cheaper than calling press(), eps(), and hm1() 
+    separately for EOS types that can share parts of the computation,
+    e.g. the interpolation index for spline-based EOS.
+
+    @return Pressure \f$ P \f$, specific internal energy 
+            \f$ \epsilon \f$, and specific enthalpy \f$ h - 1 \f$ 
+    
+    \throws std::runtime_error if state is invalid
+    **/
+    auto vars() const -> vars_t;
     
     friend class eos_barotr;
   };
@@ -404,6 +423,27 @@ class eos_barotr : detail::eos_barotr_base {
   **/
   auto ye_at_gm1(real_t gm1) const -> real_t;
 
+  /**\brief Evaluate EOS for an array of mass densities
+  
+  This computes all quantities requested in the output arrays for
+  many points, using a single call to the EOS implementation. For 
+  invalid points, the outputs are set to NAN. Otherwise, the results
+  agree with the corresponding pointwise functions, e.g. 
+  press_at_rho(), up to rounding errors. This is intended for code 
+  evaluating the EOS for many densities, e.g. when sampling EOS 
+  parameters.
+      
+  @param n    Number of points
+  @param rho  Array with mass density \f$ \rho \f$
+  @param res  Pointers to arrays for the requested results
+  @param valid Array receiving if each point is valid, or nullptr
+  
+  \throws std::runtime_error if called for unitialized object
+  **/
+  void eval_at_rho(std::size_t n, const real_t* rho, 
+                   const result_arrays& res, 
+                   bool* valid=nullptr) const;
+
   /**\brief Return the EOS units
   
   This returns the conversion factors to express the units used by 
@@ -5,6 +5,7 @@
 #include "intervals.h"
 #include "unitconv.h"
 #include "datastore.h"
+#include <cstddef>
 
 namespace EOS_Toolkit {
 namespace implementations {
@@ -16,6 +17,28 @@ class eos_barotr_impl {
   public:
   using range  = interval<real_t>;
 
+  ///Quantities depending on \f$ g-1 \f$, computed together by vars()
+  struct vars_t {
+    real_t press;  ///< Pressure \f$ P \f$
+    real_t eps;    ///< Specific internal energy \f$ \epsilon \f$
+    real_t hm1;    ///< Specific enthalpy \f$ h-1 \f$
+  };
+
+  /**\brief Output arrays for batched EOS evaluation
+  
+  Non-owning pointers to arrays receiving the results of eval_rho().
+  Each array has to provide at least as many elements as points 
+  evaluated. Quantities that are not needed should be left as 
+  nullptr, and are not computed. 
+  **/
+  struct result_arrays {
+    real_t* gm1{nullptr};    ///< Pseudo enthalpy \f$ g-1 \f$
+    real_t* press{nullptr};  ///< Pressure \f$ P \f$
+    real_t* eps{nullptr};    ///< Specific energy \f$ \epsilon \f$
+    real_t* hm1{nullptr};    ///< Specific enthalpy \f$ h-1 \f$
+    real_t* csnd{nullptr};   ///< Speed of sound \f$ c_s \f$
+  };
+
   eos_barotr_impl(const units& u) : eos_units(u) {};
   eos_barotr_impl(const eos_barotr_impl&) = default;
   eos_barotr_impl(eos_barotr_impl&&) = default;
@@ -108,6 +131,16 @@ class eos_barotr_impl {
   **/
   virtual real_t hm1(real_t gm1) const =0;
 
+  /**
+  @param gm1 Pseudo enthalpy \f$ g-1 \f$
+  @return Pressure, specific energy, and specific enthalpy
+  
+  The default implementation calls press(), eps(), and hm1().
+  Implementations should override this if they can share 
+  computations between those.
+  **/
+  virtual auto vars(real_t gm1) const -> vars_t;
+
   /**
   @param gm1 Pseudo enthalpy \f$ g-1 \f$
   @return Adiabatic soundspeed \f$ c_s \f$
@@ -128,6 +161,22 @@ class eos_barotr_impl {
   @throws std::runtime_error if electron fraction is not implemented
   **/
   virtual real_t ye(real_t gm1) const =0;
+
+  /** 
+  \brief Evaluate EOS for an array of mass densities
+  
+  @param n     Number of points
+  @param rho   Array with rest mass density  \f$ \rho \f$
+  @param res   Output arrays, see result_arrays
+  @param valid Array receiving validity of each point, or nullptr
+  
+  Invalid points have to be marked and their results set to NAN.
+  The default implementation checks each point and uses the pointwise
+  methods. Implementations should override this if they can evaluate 
+  many points more efficiently.
+  **/
+  virtual void eval_rho(std::size_t n, const real_t* rho, 
+                        const result_arrays& res, bool* valid) const;
   
   /**\brief Save EOS to a datastore
   
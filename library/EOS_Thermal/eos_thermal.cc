@@ -3,6 +3,7 @@
 **/
 
 #include "eos_thermal_impl.h"
+#include "eos_instrument.h"
 #include <limits>
 #include <stdexcept>
 #include <cassert>
@@ -75,6 +76,18 @@ class eos_thermal_invalid : public eos_thermal_impl {
 
 };
 
+#ifdef REPRIMAND_EOS_INSTRUMENTATION
+std::string describe_impl(const void* p)
+{
+  try {
+    return static_cast<const eos_thermal_impl*>(p)->descr_str();
+  }
+  catch (std::exception&) {
+    return "uninitialized";
+  }
+}
+#endif
+
 }
 
 
@@ -98,6 +111,7 @@ auto eos_thermal_base::state_base::ye() const -> real_t
 
 auto eos_thermal::state::press() const -> real_t 
 {
+  EOS_INSTRUMENT(&eos(), describe_impl, press);
   real_t p = eos().press(rho(), therm(), ye());  
   assert(p >= 0);
   return p;
@@ -105,6 +119,7 @@ auto eos_thermal::state::press() const -> real_t
 
 auto eos_thermal::state::csnd() const -> real_t 
 {
+  EOS_INSTRUMENT(&eos(), describe_impl, csnd);
   real_t cs = eos().csnd(rho(), therm(), ye());  
   assert(cs < 1.0);
   assert(cs >= 0);
@@ -113,6 +128,7 @@ auto eos_thermal::state::csnd() const -> real_t
 
 auto eos_thermal::state::temp() const -> real_t 
 {
+  EOS_INSTRUMENT(&eos(), describe_impl, temp);
   real_t temp = eos().temp(rho(), therm(), ye());  
   assert(temp >= 0);
   return temp;
@@ -120,6 +136,7 @@ auto eos_thermal::state::temp() const -> real_t
 
 auto eos_thermal::state::eps() const -> real_t
 {
+  EOS_INSTRUMENT(&eos(), describe_impl, eps);
   real_t eps = eos().eps(rho(), therm(), ye());  
   assert(eps >= -1);
   return eps;
@@ -127,16 +144,19 @@ auto eos_thermal::state::eps() const -> real_t
 
 auto eos_thermal::state::sentr() const -> real_t
 {
+  EOS_INSTRUMENT(&eos(), describe_impl, sentr);
   return eos().sentr(rho(), therm(), ye());  
 }
 
 auto eos_thermal::state::dpress_drho() const -> real_t
 {
+  EOS_INSTRUMENT(&eos(), describe_impl, dpress_drho);
   return eos().dpress_drho(rho(), therm(), ye());  
 }
 
 auto eos_thermal::state::dpress_deps() const -> real_t
 {
+  EOS_INSTRUMENT(&eos(), describe_impl, dpress_deps);
   return eos().dpress_deps(rho(), therm(), ye());  
 }
 
@@ -146,6 +166,7 @@ auto eos_thermal::at_rho_eps_ye(real_t rho, real_t eps,
 -> state
 {
   if (!is_rho_eps_ye_valid(rho,eps,ye)) return {};
+  EOS_INSTRUMENT(&impl(), describe_impl, therm_from_rho_eps_ye);
   return {impl(), rho, impl().therm_from_rho_eps_ye(rho,eps,ye), ye};
 }
 
@@ -154,6 +175,7 @@ auto eos_thermal::at_rho_temp_ye(real_t rho, real_t temp,
 -> state
 {
   if (!is_rho_temp_ye_valid(rho,temp,ye)) return {};
+  EOS_INSTRUMENT(&impl(), describe_impl, therm_from_rho_temp_ye);
   return {impl(), rho, impl().therm_from_rho_temp_ye(rho,temp,ye), ye};
 }
 
@@ -178,9 +200,17 @@ auto eos_thermal::range_eps(real_t rho, real_t ye) const -> range
     throw range_error("eos_thermal: specific energy range for "
                       "invalid electron fraction requested");
 
+  EOS_INSTRUMENT(&impl(), describe_impl, range_eps);
   return impl().range_eps(rho, ye);
 }
 
+auto eos_thermal::press_limited(real_t rho, real_t eps, 
+                                real_t ye) const -> press_limited_t
+{
+  EOS_INSTRUMENT(&impl(), describe_impl, press_limited);
+  return impl().press_limited(rho, eps, ye);
+}
+
  
 auto eos_thermal::range_temp(real_t rho, real_t ye) const -> range
 {
@@ -190,6 +220,7 @@ auto eos_thermal::range_temp(real_t rho, real_t ye) const -> range
   if (!is_ye_valid(ye))
     throw range_error("eos_thermal: temperature range for "
                       "invalid electron fraction requested");
+  EOS_INSTRUMENT(&impl(), describe_impl, range_temp);
   return impl().range_temp(rho, ye);
 }
 
@@ -221,16 +252,17 @@ auto eos_thermal::is_rho_ye_valid(real_t rho, real_t ye) const
 auto eos_thermal::is_rho_eps_ye_valid(real_t rho, 
                             real_t eps, real_t ye) const -> bool
 {
-  return is_rho_ye_valid(rho, ye) 
-         && impl().range_eps(rho, ye).contains(eps);
+  if (!is_rho_ye_valid(rho, ye)) return false;
+  EOS_INSTRUMENT(&impl(), describe_impl, range_eps);
+  return impl().range_eps(rho, ye).contains(eps);
 }
 
 auto eos_thermal::is_rho_temp_ye_valid(real_t rho, 
                             real_t temp, real_t ye) const ->bool
 {
-  return is_rho_ye_valid(rho, ye) 
-         && impl().range_temp(rho, ye).contains(temp);
-
+  if (!is_rho_ye_valid(rho, ye)) return false;
+  EOS_INSTRUMENT(&impl(), describe_impl, range_temp);
+  return impl().range_temp(rho, ye).contains(temp);
 }
 
 auto eos_thermal::press_at_rho_eps_ye(real_t rho, real_t eps, 
@@ -320,11 +352,32 @@ auto eos_thermal::dpress_deps_at_rho_temp_ye(real_t rho, real_t temp,
   return s ? s.dpress_deps() : numeric_limits<real_t>::quiet_NaN();  
 }
 
+void eos_thermal::eval_at_rho_eps_ye(std::size_t n, const real_t* rho, 
+                            const real_t* eps, const real_t* ye,
+                            const result_arrays& res, bool* valid) const
+{
+  EOS_INSTRUMENT(&impl(), describe_impl, eval_rho_eps_ye);
+  impl().eval_rho_eps_ye(n, rho, eps, ye, res, valid);
+}
+
+void eos_thermal::eval_at_rho_temp_ye(std::size_t n, const real_t* rho, 
+                            const real_t* temp, const real_t* ye,
+                            const result_arrays& res, bool* valid) const
+{
+  EOS_INSTRUMENT(&impl(), describe_impl, eval_rho_temp_ye);
+  impl().eval_rho_temp_ye(n, rho, temp, ye, res, valid);
+}
+
 void eos_thermal::save(datasink s) const
 {
   impl().save(s);
 }
 
+void eos_thermal::save_mapped(implementations::mapped_eos_writer& w) const
+{
+  impl().save_mapped(w);
+}
+
 auto eos_thermal::units_to_SI() const -> const units&
 {
   return impl().units_to_SI();
@@ -340,5 +393,92 @@ void eos_thermal_impl::save(datasink s) const
   throw  std::runtime_error("Saving not implemented for EOS type");
 }
 
+void eos_thermal_impl::save_mapped(mapped_eos_writer& w) const
+{
+  throw  std::runtime_error("Saving in memory-mappable format not "
+                            "implemented for EOS type");
+}
+
+auto eos_thermal_impl::press_limited(real_t rho, real_t eps, 
+                                     real_t ye) const 
+-> eos_thermal::press_limited_t
+{
+  const range rgeps{ range_eps(rho, ye) };
+  const real_t eps_l{ rgeps.limit_to(eps) };
+  const real_t p{ press(rho, therm_from_rho_eps_ye(rho, eps_l, ye), ye) };
+  return {eps_l, p, rgeps};
+}
+
+namespace {
+
+void store_invalid(std::size_t i, const eos_thermal::result_arrays& r)
+{
+  const real_t nan{ numeric_limits<real_t>::quiet_NaN() };
+  if (r.press)       r.press[i]       = nan;
+  if (r.csnd)        r.csnd[i]        = nan;
+  if (r.temp)        r.temp[i]        = nan;
+  if (r.eps)         r.eps[i]         = nan;
+  if (r.sentr)       r.sentr[i]       = nan;
+  if (r.dpress_drho) r.dpress_drho[i] = nan;
+  if (r.dpress_deps) r.dpress_deps[i] = nan;
+}
+
+void store_state(const eos_thermal_impl& e, std::size_t i, real_t rho, 
+                 real_t th, real_t ye, 
+                 const eos_thermal::result_arrays& r)
+{
+  if (r.press)       r.press[i]       = e.press(rho, th, ye);
+  if (r.csnd)        r.csnd[i]        = e.csnd(rho, th, ye);
+  if (r.temp)        r.temp[i]        = e.temp(rho, th, ye);
+  if (r.eps)         r.eps[i]         = e.eps(rho, th, ye);
+  if (r.sentr)       r.sentr[i]       = e.sentr(rho, th, ye);
+  if (r.dpress_drho) r.dpress_drho[i] = e.dpress_drho(rho, th, ye);
+  if (r.dpress_deps) r.dpress_deps[i] = e.dpress_deps(rho, th, ye);
+}
+
+}
+
+void eos_thermal_impl::eval_rho_eps_ye(std::size_t n, const real_t* rho,
+                          const real_t* eps, const real_t* ye,
+                          const eos_thermal::result_arrays& res,
+                          bool* valid) const
+{
+  const range& rgrho{ range_rho() };
+  const range& rgye{ range_ye() };
+  for (std::size_t i = 0; i < n; ++i) {
+    const bool ok{ rgrho.contains(rho[i]) && rgye.contains(ye[i]) 
+                   && range_eps(rho[i], ye[i]).contains(eps[i]) };
+    if (valid) valid[i] = ok;
+    if (ok) {
+      const real_t th{ therm_from_rho_eps_ye(rho[i], eps[i], ye[i]) };
+      store_state(*this, i, rho[i], th, ye[i], res);
+    }
+    else {
+      store_invalid(i, res);
+    }
+  }
+}
+
+void eos_thermal_impl::eval_rho_temp_ye(std::size_t n, const real_t* rho,
+                          const real_t* temp, const real_t* ye,
+                          const eos_thermal::result_arrays& res,
+                          bool* valid) const
+{
+  const range& rgrho{ range_rho() };
+  const range& rgye{ range_ye() };
+  for (std::size_t i = 0; i < n; ++i) {
+    const bool ok{ rgrho.contains(rho[i]) && rgye.contains(ye[i]) 
+                   && range_temp(rho[i], ye[i]).contains(temp[i]) };
+    if (valid) valid[i] = ok;
+    if (ok) {
+      const real_t th{ therm_from_rho_temp_ye(rho[i], temp[i], ye[i]) };
+      store_state(*this, i, rho[i], th, ye[i], res);
+    }
+    else {
+      store_invalid(i, res);
+    }
+  }
+}
+
 eos_thermal_impl::~eos_thermal_impl() = default;
 
@@ -2,8 +2,15 @@
 #include "hdf5store.h"
 #include "eos_thermal_file.h"
 #include "eos_thermal_file_impl.h"
+#include "eos_thermal_mapped_impl.h"
 #include "eos_idealgas_impl.h"
 #include "eos_hybrid_impl.h"
+#include "eos_thermal_table_impl.h"
+#include "eos_thermal_tabulated_impl.h"
+#include "shared_memory.h"
+
+#include <chrono>
+#include <thread>
 
 namespace EOS_Toolkit {
 
@@ -13,7 +20,11 @@ void ugly_hack_to_trick_stupid_linker2()
   // _seemingly_ unused handler registration code 
   volatile bool builtin_handlers_registered {
     implementations::eos_idealgas::file_handler_registered &&
-    implementations::eos_hybrid::file_handler_registered
+    implementations::eos_hybrid::file_handler_registered &&
+    implementations::eos_thermal_table::file_handler_registered &&
+    implementations::eos_thermal_tabulated::file_handler_registered &&
+    implementations::eos_thermal_table::mapped_handler_registered &&
+    implementations::eos_thermal_tabulated::mapped_handler_registered
   };
   assert(builtin_handlers_registered); 
 }
@@ -36,8 +47,31 @@ eos_thermal detail::load_eos_thermal(const datasource s,
   return r.load(g, u);  
 }
 
+namespace {
+
+eos_thermal load_mapped(const implementations::mapped_eos_reader& r,
+                        const units& u)
+{
+  using namespace implementations;
+  ugly_hack_to_trick_stupid_linker2();
+  const units us{ r.units_to_SI() };
+  if ((us.length() != u.length()) || (us.time() != u.time()) 
+      || (us.mass() != u.mass()))
+  {
+    throw std::runtime_error("load_eos_thermal: memory-mapped EOS "
+                             "can only be used in stored units");
+  }
+  return registry_reader_mapped_eos_thermal::get(r.eos_type()).load(r);
+}
+
+}
+
 eos_thermal load_eos_thermal(std::string fname, const units& u)
 {
+  using namespace implementations;
+  if (mapped_eos_reader::is_mapped_eos(fname)) {
+    return load_mapped(mapped_eos_reader(fname), u);
+  }
   auto g = make_hdf5_file_source(fname);
   return detail::load_eos_thermal(g,u);
 }
@@ -51,4 +85,56 @@ void save_eos_thermal(std::string fname, eos_thermal eos,
   eos.save(g / "eos_thermal");
 }
 
+void save_eos_thermal_mapped(std::string fname, eos_thermal eos)
+{
+  implementations::mapped_eos_writer w(eos.units_to_SI());
+  eos.save_mapped(w);
+  w.write(fname);
+}
+
+eos_thermal load_eos_thermal_shared(std::string fname, 
+                                    std::string shm_name,
+                                    const units& u, double timeout)
+{
+  using namespace implementations;
+  
+  auto shm = shared_memory::attach(shm_name, timeout);
+  if (!shm) {
+    auto eos = load_eos_thermal(fname, u);
+    mapped_eos_writer w(eos.units_to_SI());
+    eos.save_mapped(w);
+    auto shm_w = shared_memory::create(shm_name, w.total_size());
+    if (shm_w) {
+      w.write_to(shm_w->data());
+      shm = shm_w;
+    }
+    else {  // lost race against other process
+      shm = shared_memory::attach(shm_name, timeout);
+      if (!shm) {
+        throw std::runtime_error("load_eos_thermal_shared: shared "
+                                 "memory " + shm_name + " vanished");
+      }
+    }
+  }
+
+  using clock = std::chrono::steady_clock;
+  const auto deadline = clock::now()
+                  + std::chrono::duration_cast<clock::duration>(
+                      std::chrono::duration<double>(timeout));
+  while (!mapped_eos_reader::is_mapped_eos(shm->data())) {
+    if (clock::now() > deadline) {
+      throw std::runtime_error("load_eos_thermal_shared: timeout "
+                               "waiting for shared memory " + shm_name);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return load_mapped(mapped_eos_reader(shm, shm->data(), shm->size(), 
+                                       shm_name), u);
+}
+
+bool remove_eos_thermal_shared(std::string shm_name)
+{
+  return shared_memory::remove(shm_name);
+}
+
 } // namespace EOS_Toolkit
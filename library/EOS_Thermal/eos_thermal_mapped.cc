@@ -0,0 +1,266 @@
+#include "eos_thermal_mapped_impl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace EOS_Toolkit {
+namespace implementations {
+
+static_assert(std::is_standard_layout<mapped_eos_header>::value
+              && (sizeof(mapped_eos_header) <= mapped_eos_header::align),
+              "mapped_eos_header must fit into aligned header block");
+
+constexpr std::size_t mapped_eos_header::align;
+constexpr std::size_t mapped_eos_header::max_dims;
+constexpr std::size_t mapped_eos_header::max_params;
+constexpr std::size_t mapped_eos_header::max_sections;
+constexpr std::uint64_t mapped_eos_header::byte_order_mark;
+constexpr std::uint64_t mapped_eos_header::format_version;
+
+const char mapped_eos_header::magic_id[8] = {
+  'R', 'P', 'R', 'M', 'E', 'O', 'S', '\0'
+};
+
+namespace {
+
+auto aligned(std::uint64_t n) -> std::uint64_t
+{
+  const std::uint64_t a{ mapped_eos_header::align };
+  return ((n + a - 1) / a) * a;
+}
+
+}
+
+mapped_eos_writer::mapped_eos_writer(const units& u)
+{
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr.magic, mapped_eos_header::magic_id, sizeof(hdr.magic));
+  hdr.byte_order  = mapped_eos_header::byte_order_mark;
+  hdr.version     = mapped_eos_header::format_version;
+  hdr.units_si[0] = u.length();
+  hdr.units_si[1] = u.time();
+  hdr.units_si[2] = u.mass();
+}
+
+void mapped_eos_writer::set_eos_type(const std::string& eos_type)
+{
+  if (eos_type.size() >= sizeof(hdr.eos_type)) {
+    throw std::runtime_error("mapped_eos_writer: EOS type name too long");
+  }
+  std::memset(hdr.eos_type, 0, sizeof(hdr.eos_type));
+  std::memcpy(hdr.eos_type, eos_type.c_str(), eos_type.size());
+}
+
+void mapped_eos_writer::set_dim(std::size_t i, std::uint64_t v)
+{
+  if (i >= mapped_eos_header::max_dims) {
+    throw std::range_error("mapped_eos_writer: dimension index too large");
+  }
+  hdr.dims[i] = v;
+}
+
+void mapped_eos_writer::set_param(std::size_t i, double v)
+{
+  if (i >= mapped_eos_header::max_params) {
+    throw std::range_error("mapped_eos_writer: parameter index too large");
+  }
+  hdr.params[i] = v;
+}
+
+void mapped_eos_writer::add_raw_section(const char* data,
+                          std::size_t count, std::size_t elem_size)
+{
+  const std::size_t i{ sec_data.size() };
+  if (i >= mapped_eos_header::max_sections) {
+    throw std::range_error("mapped_eos_writer: too many sections");
+  }
+  const std::uint64_t off{ (i == 0) ? mapped_eos_header::align
+           : aligned(hdr.sec_offset[i - 1]
+                     + hdr.sec_count[i - 1] * hdr.sec_elem_size[i - 1]) };
+  hdr.sec_offset[i]    = off;
+  hdr.sec_count[i]     = count;
+  hdr.sec_elem_size[i] = elem_size;
+  hdr.num_sections     = i + 1;
+  sec_data.push_back(data);
+}
+
+void mapped_eos_writer::write(const std::string& fname) const
+{
+  if (hdr.eos_type[0] == '\0') {
+    throw std::runtime_error("mapped_eos_writer: EOS type not set");
+  }
+  std::ofstream os(fname, std::ios::binary | std::ios::trunc);
+  if (!os) {
+    throw std::runtime_error("mapped_eos_writer: cannot open " + fname);
+  }
+  const std::vector<char> zeros(mapped_eos_header::align, 0);
+  os.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  std::uint64_t pos{ sizeof(hdr) };
+  for (std::size_t i = 0; i < sec_data.size(); ++i) {
+    os.write(zeros.data(), hdr.sec_offset[i] - pos);
+    const std::uint64_t len{ hdr.sec_count[i] * hdr.sec_elem_size[i] };
+    os.write(sec_data[i], len);
+    pos = hdr.sec_offset[i] + len;
+  }
+  const std::uint64_t end{ std::max(aligned(pos),
+                                    std::uint64_t(mapped_eos_header::align)) };
+  os.write(zeros.data(), end - pos);
+  if (!os) {
+    throw std::runtime_error("mapped_eos_writer: failed writing " + fname);
+  }
+}
+
+auto mapped_eos_writer::total_size() const -> std::size_t
+{
+  const std::size_t n{ sec_data.size() };
+  if (n == 0) return mapped_eos_header::align;
+  return aligned(hdr.sec_offset[n - 1]
+                 + hdr.sec_count[n - 1] * hdr.sec_elem_size[n - 1]);
+}
+
+void mapped_eos_writer::write_to(char* dest) const
+{
+  if (hdr.eos_type[0] == '\0') {
+    throw std::runtime_error("mapped_eos_writer: EOS type not set");
+  }
+  std::memset(dest, 0, total_size());
+  for (std::size_t i = 0; i < sec_data.size(); ++i) {
+    std::memcpy(dest + hdr.sec_offset[i], sec_data[i],
+                hdr.sec_count[i] * hdr.sec_elem_size[i]);
+  }
+  const std::size_t nm{ sizeof(hdr.magic) };
+  std::memcpy(dest + nm, reinterpret_cast<const char*>(&hdr) + nm,
+              sizeof(hdr) - nm);
+  std::atomic_thread_fence(std::memory_order_release);
+  volatile char* m{ dest };
+  for (std::size_t i = 0; i < nm; ++i) m[i] = hdr.magic[i];
+}
+
+
+mapped_eos_reader::mapped_eos_reader(const std::string& fname)
+: mapped_eos_reader(std::make_shared<const mapped_file>(fname), fname)
+{}
+
+mapped_eos_reader::mapped_eos_reader(std::shared_ptr<const mapped_file> f,
+                                     const std::string& fname)
+: mapped_eos_reader(f, f->data(), f->size(), fname)
+{}
+
+mapped_eos_reader::mapped_eos_reader(std::shared_ptr<const void> owner_,
+                    const char* data, std::size_t size,
+                    const std::string& name)
+: owner{std::move(owner_)}, base{data}
+{
+  auto corrupt = [&name] (const std::string& why) {
+    return std::runtime_error("Invalid memory-mappable EOS data "
+                              + name + " (" + why + ")");
+  };
+  if (size < mapped_eos_header::align) {
+    throw corrupt("truncated header");
+  }
+  hdr = reinterpret_cast<const mapped_eos_header*>(base);
+  if (std::memcmp(hdr->magic, mapped_eos_header::magic_id,
+                  sizeof(hdr->magic)) != 0)
+  {
+    throw corrupt("wrong magic identifier");
+  }
+  if (hdr->byte_order != mapped_eos_header::byte_order_mark) {
+    throw corrupt("byte order differs from this machine");
+  }
+  if (hdr->version != mapped_eos_header::format_version) {
+    throw corrupt("unsupported format version");
+  }
+  if (hdr->eos_type[sizeof(hdr->eos_type) - 1] != '\0') {
+    throw corrupt("malformed EOS type");
+  }
+  if (hdr->num_sections > mapped_eos_header::max_sections) {
+    throw corrupt("too many sections");
+  }
+  for (std::size_t i = 0; i < hdr->num_sections; ++i) {
+    const std::uint64_t off{ hdr->sec_offset[i] };
+    const std::uint64_t esz{ hdr->sec_elem_size[i] };
+    const std::uint64_t cnt{ hdr->sec_count[i] };
+    if ((off % mapped_eos_header::align != 0) || (off > size)
+        || (esz == 0) || (cnt > (size - off) / esz))
+    {
+      throw corrupt("section out of bounds");
+    }
+  }
+}
+
+bool mapped_eos_reader::is_mapped_eos(const std::string& fname)
+{
+  char m[sizeof(mapped_eos_header::magic_id)];
+  std::ifstream is(fname, std::ios::binary);
+  if (!is.read(m, sizeof(m))) return false;
+  return std::memcmp(m, mapped_eos_header::magic_id, sizeof(m)) == 0;
+}
+
+bool mapped_eos_reader::is_mapped_eos(const volatile char* data)
+{
+  for (std::size_t i = 0; i < sizeof(mapped_eos_header::magic_id); ++i) 
+  {
+    if (data[i] != mapped_eos_header::magic_id[i]) return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return true;
+}
+
+auto mapped_eos_reader::eos_type() const -> std::string
+{
+  return std::string(hdr->eos_type);
+}
+
+auto mapped_eos_reader::units_to_SI() const -> units
+{
+  return units{hdr->units_si[0], hdr->units_si[1], hdr->units_si[2]};
+}
+
+auto mapped_eos_reader::dim(std::size_t i) const -> std::uint64_t
+{
+  if (i >= mapped_eos_header::max_dims) {
+    throw std::range_error("mapped_eos_reader: dimension index too large");
+  }
+  return hdr->dims[i];
+}
+
+auto mapped_eos_reader::param(std::size_t i) const -> double
+{
+  if (i >= mapped_eos_header::max_params) {
+    throw std::range_error("mapped_eos_reader: parameter index too large");
+  }
+  return hdr->params[i];
+}
+
+auto mapped_eos_reader::num_sections() const -> std::size_t
+{
+  return hdr->num_sections;
+}
+
+auto mapped_eos_reader::section_size(std::size_t i) const -> std::size_t
+{
+  if (i >= hdr->num_sections) {
+    throw std::runtime_error("mapped_eos_reader: missing section");
+  }
+  return hdr->sec_count[i];
+}
+
+auto mapped_eos_reader::raw_section(std::size_t i,
+                                    std::size_t elem_size) const
+-> const char*
+{
+  if (i >= hdr->num_sections) {
+    throw std::runtime_error("mapped_eos_reader: missing section");
+  }
+  if (hdr->sec_elem_size[i] != elem_size) {
+    throw std::runtime_error("mapped_eos_reader: section element size "
+                             "mismatch");
+  }
+  return base + hdr->sec_offset[i];
+}
+
+} // namespace implementations
+} // namespace EOS_Toolkit
@@ -0,0 +1,33 @@
+#include "eos_thermal_static.h"
+
+using namespace EOS_Toolkit;
+using namespace EOS_Toolkit::implementations;
+
+
+namespace {
+
+auto find_kind(const eos_thermal& eos) -> eos_thermal_static::kind
+{
+  using kind = eos_thermal_static::kind;
+  if (eos.implementation_as<eos_idealgas>() != nullptr) {
+    return kind::IDEALGAS;
+  }
+  if (eos.implementation_as<eos_hybrid>() != nullptr) {
+    return kind::HYBRID;
+  }
+  if (eos.implementation_as<eos_thermal_table>() != nullptr) {
+    return kind::TABLE;
+  }
+  if (eos.implementation_as<eos_thermal_tabulated>() != nullptr) {
+    return kind::TABULATED;
+  }
+  return kind::GENERIC;
+}
+
+}
+
+eos_thermal_static::eos_thermal_static(eos_thermal eos_)
+: eos{std::move(eos_)}, 
+  pimpl{eos.implementation_as<eos_thermal_impl>()},
+  knd{find_kind(eos)}
+{}
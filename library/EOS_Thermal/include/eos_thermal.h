@@ -10,6 +10,7 @@
 
 #include "eos_thermal_internals.h"
 
+#include <cstddef>
 #include <string>
 
 
@@ -25,6 +26,30 @@ class eos_thermal : detail::eos_thermal_base {
   ///Synonym for \ref interval
   using range  = interval<real_t>;
   
+  /// Result of \ref press_limited()
+  struct press_limited_t {
+    real_t eps;    ///< Specific energy limited to valid range
+    real_t press;  ///< Pressure at limited specific energy
+    range rgeps;   ///< Valid range for specific energy
+  };
+  
+  /**\brief Output arrays for batched EOS evaluation
+  
+  Non-owning pointers to arrays receiving the results of 
+  eval_at_rho_eps_ye() and eval_at_rho_temp_ye(). Each array has to
+  provide at least as many elements as points evaluated. Quantities 
+  that are not needed should be left as nullptr, and are not 
+  computed. 
+  **/
+  struct result_arrays {
+    real_t* press{nullptr};       ///< Pressure \f$ P \f$
+    real_t* csnd{nullptr};        ///< Speed of sound \f$ c_s \f$
+    real_t* temp{nullptr};        ///< Temperature \f$ T \f$
+    real_t* eps{nullptr};         ///< Specific energy \f$ \epsilon \f$
+    real_t* sentr{nullptr};       ///< Specific entropy \f$ s \f$
+    real_t* dpress_drho{nullptr}; ///< \f$ \partial P / \partial \rho \f$
+    real_t* dpress_deps{nullptr}; ///< \f$ \partial P / \partial \epsilon \f$
+  };
   
 
   ///Class representing the matter state for the eos_thermal interface 
@@ -188,6 +213,26 @@ class eos_thermal : detail::eos_thermal_base {
   **/
   auto range_eps(real_t rho, real_t ye) const -> range;
 
+  /**\brief Limit specific energy to valid range and compute pressure
+
+  This combines range_eps(), limiting, and pressure evaluation in a
+  single call to the EOS implementation. It is intended for code 
+  evaluating the EOS in tight loops, e.g. primitive recovery.
+
+  @param rho  Mass density \f$ \rho \f$
+  @param eps  Specific energy \f$ \epsilon \f$, may be outside 
+              valid range
+  @param ye   Electron fraction \f$ Y_e \f$
+  @return Limited specific energy, pressure, and valid range for 
+          specific energy.
+
+  \pre Density and electron fraction must be valid. This is not 
+       checked.
+  \throws std::runtime_error if called for unitialized object
+  **/
+  auto press_limited(real_t rho, real_t eps, real_t ye) const 
+  -> press_limited_t;
+
   /**
   @param rho  Mass density \f$ \rho \f$
   @param ye   Electron fraction \f$ Y_e \f$
@@ -427,6 +472,54 @@ class eos_thermal : detail::eos_thermal_base {
   auto dpress_deps_at_rho_temp_ye(real_t rho, real_t temp, 
                                   real_t ye) const -> real_t;
 
+  /**\brief Evaluate EOS for arrays of density, specific energy, 
+  and electron fraction
+  
+  This computes all quantities requested in the output arrays for
+  many points, using a single call to the EOS implementation. For 
+  invalid points, the outputs are set to NAN. Otherwise, the results
+  agree with the corresponding pointwise functions, e.g.
+  press_at_rho_eps_ye(). This is intended for code evaluating the EOS
+  on whole grids or arrays.
+      
+  @param n    Number of points
+  @param rho  Array with mass density \f$ \rho \f$
+  @param eps  Array with specific internal energy \f$ \epsilon \f$
+  @param ye   Array with electron fraction \f$ Y_e \f$
+  @param res  Pointers to arrays for the requested results
+  @param valid Array receiving if each point is valid, or nullptr
+  
+  \throws std::runtime_error if a requested quantity is not 
+          available for the EOS
+  \throws std::runtime_error if called for unitialized object
+  **/
+  void eval_at_rho_eps_ye(std::size_t n, const real_t* rho, 
+                          const real_t* eps, const real_t* ye,
+                          const result_arrays& res, 
+                          bool* valid=nullptr) const;
+
+  /**\brief Evaluate EOS for arrays of density, temperature, 
+  and electron fraction
+  
+  Same as eval_at_rho_eps_ye(), but based on temperature.
+      
+  @param n    Number of points
+  @param rho  Array with mass density \f$ \rho \f$
+  @param temp Array with temperature \f$ T \f$
+  @param ye   Array with electron fraction \f$ Y_e \f$
+  @param res  Pointers to arrays for the requested results
+  @param valid Array receiving if each point is valid, or nullptr
+  
+  \throws std::runtime_error if temperature not available for EOS
+  \throws std::runtime_error if a requested quantity is not 
+          available for the EOS
+  \throws std::runtime_error if called for unitialized object
+  **/
+  void eval_at_rho_temp_ye(std::size_t n, const real_t* rho, 
+                           const real_t* temp, const real_t* ye,
+                           const result_arrays& res, 
+                           bool* valid=nullptr) const;
+
   /**\brief Save EOS to a datastore
   
   Allows saving the EOS to a datastore. This is intended mainly
@@ -434,6 +527,14 @@ class eos_thermal : detail::eos_thermal_base {
   **/
   void save(datasink s) const;
 
+  /**\brief Save EOS to a memory-mappable file writer
+  
+  This is intended for internal use by save_eos_thermal_mapped().
+  
+  \throws std::runtime_error if not supported by the EOS type
+  **/
+  void save_mapped(implementations::mapped_eos_writer& w) const;
+
   /**\brief Return the EOS units
   
   This returns the conversion factors to express the units used by 
@@ -447,6 +548,23 @@ class eos_thermal : detail::eos_thermal_base {
   @returns Short auto-generated EOS type-specific description string 
   **/
   auto descr_str() const -> std::string;
+  
+  /**\brief Access implementation of a given type
+  
+  This is intended for code that is specialized to a given EOS 
+  implementation, avoiding the overhead of virtual function calls.
+  The implementation type has to be complete where this is used.
+  
+  @tparam T Implementation class, derived from 
+            implementations::eos_thermal_impl
+  @returns Pointer to implementation, or nullptr if the EOS is of 
+           different type.
+  **/
+  template<class T>
+  auto implementation_as() const -> const T*
+  {
+    return dynamic_cast<const T*>(&impl());
+  }
 };
 
 
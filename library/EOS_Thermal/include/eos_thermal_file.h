@@ -10,7 +10,14 @@
 namespace EOS_Toolkit {
 
 
-/**\brief Load thermal EOS from hdf5 file. 
+/**\brief Load thermal EOS from file. 
+
+Besides hdf5 files, this also accepts files in the memory-mappable
+format written by save_eos_thermal_mapped(). The latter are not read
+into memory but mapped read-only, such that the table data is loaded
+lazily and shared between all processes using the same file. For
+such files, the requested unit system has to agree with the one of
+the saved EOS.
 
 @param fname Filename of EOS file
 @param Unit system the returned EOS should use. The unit system needs
@@ -31,6 +38,65 @@ eos_thermal load_eos_thermal(std::string fname,
 void save_eos_thermal(std::string fname,  eos_thermal eos, 
                      std::string info="");
 
+/**\brief Save thermal EOS to memory-mappable file. 
+
+The file format is binary, with data stored in native byte order and
+aligned to memory pages, such that tabulated data can be used 
+in place when loading the file with load_eos_thermal(). Loading
+fails on machines with different byte order. The EOS is saved in
+its own unit system. Only the tabulated thermal EOS types support
+this format.
+
+@param fname Filename of EOS file
+@param eos EOS object to save
+**/ 
+void save_eos_thermal_mapped(std::string fname, eos_thermal eos);
+
+/**\brief Load thermal EOS into node-level shared memory
+
+This allows processes on the same node, e.g. MPI ranks, to share
+one copy of a tabulated EOS. The first process calling this function
+for a given segment name loads the EOS from file and copies it into 
+a new POSIX shared memory segment, in the format written by
+save_eos_thermal_mapped(). Other processes wait until the segment is 
+complete and then use it read-only in place. No communication
+between the processes is needed besides agreeing on the segment name.
+
+The segment persists until removed by remove_eos_thermal_shared(),
+even if all processes have finished. EOS objects already using the 
+segment remain valid after removing it. For robustness against 
+stale segments left by crashed jobs, the name should be unique for
+each job and EOS.
+
+Only the tabulated thermal EOS types support this. Note that all
+processes calling this function simultaneously might load the EOS
+from file before one of them creates the segment. The others then 
+discard their copy.
+
+@param fname    Filename of EOS file (hdf5 or memory-mappable)
+@param shm_name Name of the shared memory segment, of the form 
+                "/somename"
+@param u        Unit system the returned EOS should use
+@param timeout  Maximum time in seconds to wait for the segment 
+                to be completed by another process
+
+@return Generic interface to the EOS  
+**/ 
+eos_thermal load_eos_thermal_shared(std::string fname, 
+                                    std::string shm_name,
+                                    const units& u=units::geom_solar(),
+                                    double timeout=60.0);
+
+/**\brief Remove shared memory segment created by 
+          load_eos_thermal_shared()
+
+This only removes the name. The memory is released when no process 
+uses the EOS anymore.
+
+@return If a segment with the given name existed
+**/ 
+bool remove_eos_thermal_shared(std::string shm_name);
+
 
 namespace detail {
 
@@ -145,6 +145,56 @@ class eos_thermal_impl {
   **/
   virtual range range_eps(real_t rho, real_t ye) const=0;
 
+  /** 
+  @return Specific energy limited to valid range, pressure at 
+          limited specific energy, and valid range for specific 
+          energy.
+  
+  @param rho   Rest mass density  \f$ \rho \f$
+  @param eps   Specific internal energy \f$ \epsilon \f$
+  @param ye    Electron fraction \f$ Y_e \f$
+  
+  The default implementation combines range_eps(), 
+  therm_from_rho_eps_ye() and press(). Implementations should 
+  override this if they can avoid redundant computations.
+  
+  \pre Density and electron fraction must be valid.
+  **/
+  virtual auto press_limited(real_t rho, real_t eps, real_t ye) const
+  -> eos_thermal::press_limited_t;
+
+  /** 
+  \brief Evaluate EOS for arrays of density, specific energy, and 
+         electron fraction
+  
+  @param n     Number of points
+  @param rho   Array with rest mass density  \f$ \rho \f$
+  @param eps   Array with specific internal energy \f$ \epsilon \f$
+  @param ye    Array with electron fraction \f$ Y_e \f$
+  @param res   Output arrays, see eos_thermal::result_arrays
+  @param valid Array receiving validity of each point, or nullptr
+  
+  Invalid points have to be marked and their results set to NAN.
+  The default implementation checks each point and uses the pointwise
+  methods. Implementations should override this if they can evaluate 
+  many points more efficiently.
+  **/
+  virtual void eval_rho_eps_ye(std::size_t n, const real_t* rho, 
+                               const real_t* eps, const real_t* ye,
+                               const eos_thermal::result_arrays& res,
+                               bool* valid) const;
+
+  /** 
+  \brief Evaluate EOS for arrays of density, temperature, and 
+         electron fraction
+  
+  Same as eval_rho_eps_ye(), but based on temperature. The default 
+  implementation checks each point and uses the pointwise methods.
+  **/
+  virtual void eval_rho_temp_ye(std::size_t n, const real_t* rho, 
+                                const real_t* temp, const real_t* ye,
+                                const eos_thermal::result_arrays& res,
+                                bool* valid) const;
   
   /** 
   @return Valid range for temperature \f$ T \f$
@@ -167,6 +217,13 @@ class eos_thermal_impl {
 
   virtual void save(datasink s) const;
 
+  /**\brief Add EOS data to memory-mappable EOS file
+
+  The default implementation throws, since only EOS types whose data
+  can be used in place support this format.
+  **/
+  virtual void save_mapped(mapped_eos_writer& w) const;
+
   /**\brief Return the EOS units
 
   @return Unit object with the geometric unit system of the EOS with
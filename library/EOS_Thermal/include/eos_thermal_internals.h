@@ -15,6 +15,7 @@ class eos_thermal;
 namespace implementations {
 
   class eos_thermal_impl;
+  class mapped_eos_writer;
 
 }
 
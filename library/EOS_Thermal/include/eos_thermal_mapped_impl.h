@@ -0,0 +1,184 @@
+#ifndef EOS_THERMAL_MAPPED_IMPL_H
+#define EOS_THERMAL_MAPPED_IMPL_H
+
+#include "eos_thermal.h"
+#include "global_registry.h"
+#include "mapped_file.h"
+#include "shared_array.h"
+#include "unitconv.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace EOS_Toolkit {
+namespace implementations {
+
+/**\brief Header of the memory-mappable EOS file format
+
+The file starts with this header, padded to mapped_eos_header::align
+bytes, followed by the data sections. Each section is an array of
+trivially copyable elements starting at a multiple of
+mapped_eos_header::align bytes, such that it can be used in place
+after mapping the file. Values are stored in native byte order, which
+is checked when loading. The interpretation of dimensions, parameters,
+and sections is up to each EOS type. Units refer to the unit system
+in which all dimensionful data is stored.
+**/
+struct mapped_eos_header {
+  static constexpr std::size_t align        = 4096;
+  static constexpr std::size_t max_dims     = 8;
+  static constexpr std::size_t max_params   = 32;
+  static constexpr std::size_t max_sections = 8;
+  static constexpr std::uint64_t byte_order_mark = 0x0102030405060708ULL;
+  static constexpr std::uint64_t format_version  = 1;
+
+  char magic[8];              ///< Always "RPRMEOS" + '\0'
+  std::uint64_t byte_order;   ///< Always byte_order_mark
+  std::uint64_t version;      ///< Format version
+  char eos_type[48];          ///< EOS type identifier
+  double units_si[3];         ///< Length, time, mass unit in SI
+  std::uint64_t dims[max_dims];
+  double params[max_params];
+  std::uint64_t num_sections;
+  std::uint64_t sec_offset[max_sections];   ///< Offset in bytes
+  std::uint64_t sec_count[max_sections];    ///< Number of elements
+  std::uint64_t sec_elem_size[max_sections];///< Element size in bytes
+
+  static const char magic_id[8];
+};
+
+/**\brief Collects EOS data and writes memory-mappable EOS file
+
+The data added via add_section() is only referenced and has to stay
+valid until write() is called.
+**/
+class mapped_eos_writer {
+  mapped_eos_header hdr;
+  std::vector<const char*> sec_data;
+
+  public:
+
+  ///Units refer to the unit system of the stored data
+  explicit mapped_eos_writer(const units& u);
+
+  ///Set EOS type identifier used to select the reader
+  void set_eos_type(const std::string& eos_type);
+
+  ///Set integer parameter (e.g. table dimensions)
+  void set_dim(std::size_t i, std::uint64_t v);
+
+  ///Set floating point parameter
+  void set_param(std::size_t i, double v);
+
+  ///Add array of trivially copyable elements as next section
+  template<class T>
+  void add_section(const T* data, std::size_t count)
+  {
+    add_raw_section(reinterpret_cast<const char*>(data), count,
+                    sizeof(T));
+  }
+
+  template<class T>
+  void add_section(const shared_array<T>& a)
+  {
+    add_section(a.data(), a.size());
+  }
+
+  ///Write file, overwriting existing ones
+  void write(const std::string& fname) const;
+
+  ///Total size in bytes, including padding
+  auto total_size() const -> std::size_t;
+
+  /**\brief Write to memory of size total_size()
+  
+  The magic identifier is written last, after a memory fence, such
+  that other processes sharing the memory can wait for it.
+  **/
+  void write_to(char* dest) const;
+
+  private:
+
+  void add_raw_section(const char* data, std::size_t count,
+                       std::size_t elem_size);
+};
+
+/**\brief Provides access to data in memory-mappable EOS format
+
+The arrays returned by section() reference the memory directly
+and keep it alive.
+**/
+class mapped_eos_reader {
+  std::shared_ptr<const void> owner;
+  const char* base;
+  const mapped_eos_header* hdr;
+
+  auto raw_section(std::size_t i, std::size_t elem_size) const
+  -> const char*;
+
+  mapped_eos_reader(std::shared_ptr<const mapped_file> f,
+                    const std::string& fname);
+
+  public:
+
+  ///Map file and validate header. Throws if file is invalid.
+  explicit mapped_eos_reader(const std::string& fname);
+
+  /**\brief Use memory owned by another object, e.g. shared memory
+
+  @param owner_ Object owning the memory, kept alive by the reader
+  @param data   Start of the memory
+  @param size   Size of the memory in bytes
+  @param name   Name used in error messages
+  **/
+  mapped_eos_reader(std::shared_ptr<const void> owner_, const char* data,
+                    std::size_t size, const std::string& name);
+
+  ///Check if a file starts with the magic identifier of the format
+  static bool is_mapped_eos(const std::string& fname);
+
+  ///Check if memory starts with the magic identifier of the format
+  static bool is_mapped_eos(const volatile char* data);
+
+  auto eos_type() const -> std::string;
+
+  ///Unit system in which the data is stored
+  auto units_to_SI() const -> units;
+
+  auto dim(std::size_t i) const -> std::uint64_t;
+
+  auto param(std::size_t i) const -> double;
+
+  auto num_sections() const -> std::size_t;
+
+  ///Number of elements in given section
+  auto section_size(std::size_t i) const -> std::size_t;
+
+  /**\brief Access section in place
+
+  Throws if the element size does not match the stored one.
+  **/
+  template<class T>
+  auto section(std::size_t i) const -> shared_array<T>
+  {
+    const char* p{ raw_section(i, sizeof(T)) };
+    return shared_array<T>(owner, reinterpret_cast<const T*>(p),
+                           section_size(i));
+  }
+};
+
+struct reader_mapped_eos_thermal {
+  virtual eos_thermal load(const mapped_eos_reader& r) const = 0;
+  virtual ~reader_mapped_eos_thermal() {}
+};
+
+using registry_reader_mapped_eos_thermal
+        = global_registry<reader_mapped_eos_thermal>;
+
+} // namespace implementations
+} // namespace EOS_Toolkit
+
+#endif
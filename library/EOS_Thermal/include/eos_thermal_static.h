@@ -0,0 +1,92 @@
+#ifndef EOS_THERMAL_STATIC_H
+#define EOS_THERMAL_STATIC_H
+
+#include "eos_thermal.h"
+#include "eos_idealgas_impl.h"
+#include "eos_hybrid_impl.h"
+#include "eos_thermal_table_impl.h"
+#include "eos_thermal_tabulated_impl.h"
+#include <utility>
+
+namespace EOS_Toolkit {
+
+/**\brief Thermal EOS handle with static dispatch to known
+          implementations
+
+This wraps an eos_thermal and determines once, on construction,
+whether the implementation is one of the EOS types provided by the
+library. Code that is generic with respect to the EOS type can then
+be called with the concrete implementation via visit(), such that
+the EOS calls inside can be inlined. This is intended for dispatching
+once before tight loops, e.g. for a batch of points or a root finding,
+instead of dispatching each EOS call by virtual functions.
+EOS implementations not known to the library are passed as the
+abstract interface implementations::eos_thermal_impl, i.e. they
+still work, but use virtual function calls.
+
+Note the implementation methods expect the thermal variable as input,
+which for some EOS types differs from the specific energy, see
+implementations::eos_thermal_impl::therm_from_rho_eps_ye().
+**/
+class eos_thermal_static {
+  public:
+
+  ///EOS implementations known to the static dispatch
+  enum class kind {
+    GENERIC,    ///< Unknown implementation, use virtual calls
+    IDEALGAS,   ///< implementations::eos_idealgas
+    HYBRID,     ///< implementations::eos_hybrid
+    TABLE,      ///< implementations::eos_thermal_table
+    TABULATED   ///< implementations::eos_thermal_tabulated
+  };
+
+  ///Determine implementation type of given EOS
+  explicit eos_thermal_static(eos_thermal eos_);
+
+  ///The type of the EOS implementation
+  auto get_kind() const -> kind {return knd;}
+
+  ///The generic EOS
+  auto generic() const -> const eos_thermal& {return eos;}
+
+  /**\brief Call function object with concrete EOS implementation
+
+  @param f Function object. It has to be callable with const
+           references to each of the implementation types listed in
+           \ref kind, and implementations::eos_thermal_impl. All
+           calls must return the same type.
+
+  @return The result of calling f.
+  **/
+  template<class F>
+  auto visit(F&& f) const
+  -> decltype(std::forward<F>(f)(
+       std::declval<const implementations::eos_thermal_impl&>()))
+  {
+    using namespace implementations;
+    switch (knd) {
+      case kind::IDEALGAS:
+        return std::forward<F>(f)(static_cast<const eos_idealgas&>(*pimpl));
+      case kind::HYBRID:
+        return std::forward<F>(f)(static_cast<const eos_hybrid&>(*pimpl));
+      case kind::TABLE:
+        return std::forward<F>(f)(
+                 static_cast<const eos_thermal_table&>(*pimpl));
+      case kind::TABULATED:
+        return std::forward<F>(f)(
+                 static_cast<const eos_thermal_tabulated&>(*pimpl));
+      default:
+        return std::forward<F>(f)(*pimpl);
+    }
+  }
+
+  private:
+
+  eos_thermal eos;
+  const implementations::eos_thermal_impl* pimpl;  ///< Owned by eos
+  kind knd;
+};
+
+}
+
+#endif
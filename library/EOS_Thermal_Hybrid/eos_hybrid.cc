@@ -8,6 +8,7 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 
 
 using namespace EOS_Toolkit;
@@ -36,42 +37,39 @@ real_t eos_hybrid::eps_cold(real_t rho) const
   return eos_c.at_rho(rho).eps();
 }
 
-real_t eos_hybrid::p_cold(real_t rho) const
-{
-  return eos_c.at_rho(rho).press();
+/**
+The density-dependent part of the barotropic EOS evaluation is only
+done once, the requested quantities are then computed from the same 
+cold EOS state.
+**/
+auto eos_hybrid::cold(real_t rho, bool full) const -> cold_state
+{
+  const auto sc = eos_c.at_rho(rho);
+  const auto v  = sc.vars();
+  cold_state c{v.eps, v.press, 1.0 + v.hm1, 0.0};
+  if (full) {
+    const real_t cs{ sc.csnd() };
+    c.cs2 = cs * cs;
+  }
+  return c;
 }
 
-real_t eos_hybrid::hm1_cold(real_t rho) const
-{
-  return eos_c.at_rho(rho).hm1();
-}
-
-real_t eos_hybrid::cs2_cold(real_t rho) const
-{
-  real_t cs = eos_c.at_rho(rho).csnd();
-  return cs*cs;
-}
-
-
-
-real_t eos_hybrid::press(real_t rho, real_t eps, real_t ye) const
-{
-  real_t p_c   = p_cold(rho);
-  real_t eps_c = eps_cold(rho);
-  real_t p_th  = gm1_th * rho * (eps - eps_c);
-  return p_c + p_th;
+auto eos_hybrid::full_state(real_t rho, real_t eps, real_t ye) const 
+-> full_state_t
+{
+  const cold_state c{ cold(rho, true) };
+  const real_t eps_th{ eps - c.eps };
+  const real_t h_th{ gamma_th * eps_th };
+  const real_t w{ h_th / (c.h + h_th) };
+  const real_t cs2{ (1.0 - w) * c.cs2 + w * gm1_th };
+  return {c.press + gm1_th * rho * eps_th, sqrt(cs2), 
+          c.h * c.cs2 + gm1_th * (eps_th - c.press / rho),
+          gm1_th * rho};
 }
 
 real_t eos_hybrid::csnd(real_t rho, real_t eps, real_t ye) const
 {
-  real_t cs2_c   = cs2_cold(rho);
-  real_t eps_c   = eps_cold(rho);
-  real_t h_c     = 1.0 + hm1_cold(rho);
-  real_t eps_th  = eps - eps_c;
-  real_t h_th    = gamma_th * eps_th;
-  real_t w       = h_th / (h_c + h_th);
-  real_t cs2     = (1.0 - w) * cs2_c + w * gm1_th;
-  return sqrt(cs2);
+  return full_state(rho, eps, ye).csnd;
 }
 
 real_t eos_hybrid::temp(real_t rho, real_t eps, real_t ye) const
@@ -81,12 +79,9 @@ real_t eos_hybrid::temp(real_t rho, real_t eps, real_t ye) const
 
 real_t eos_hybrid::dpress_drho(real_t rho, real_t eps, real_t ye) const
 {
-  real_t p_c     = p_cold(rho);
-  real_t cs2_c   = cs2_cold(rho);
-  real_t eps_c   = eps_cold(rho);
-  real_t h_c     = 1.0 + hm1_cold(rho);
-  real_t eps_th  = eps - eps_c;
-  return h_c * cs2_c + gm1_th * (eps_th - p_c / rho);
+  const cold_state c{ cold(rho, true) };
+  const real_t eps_th{ eps - c.eps };
+  return c.h * c.cs2 + gm1_th * (eps_th - c.press / rho);
 }
 
 real_t eos_hybrid::dpress_deps(real_t rho, real_t eps, real_t ye) const
@@ -105,11 +100,82 @@ real_t eos_hybrid::therm_from_rho_temp_ye(real_t rho,
   throw runtime_error("eos_hybrid: temperature not implemented");
 }
 
-eos_thermal_impl::range 
-eos_hybrid::range_eps(real_t rho, real_t ye) const
+auto eos_hybrid::press_limited(real_t rho, real_t eps, 
+                               real_t ye) const
+-> eos_thermal::press_limited_t
 {
-  real_t eps_min = eps_cold(rho);
-  return {eps_min, eps_max};
+  const cold_state c{ cold(rho, false) };
+  const range rgeps{c.eps, eps_max};
+  const real_t eps_l = rgeps.limit_to(eps);
+  const real_t p     = c.press + gm1_th * rho * (eps_l - c.eps);
+  return {eps_l, p, rgeps};
+}
+
+auto eos_hybrid::press_derivs_limited(real_t rho, real_t eps, 
+                                      real_t ye) const
+-> press_derivs_t
+{
+  const cold_state c{ cold(rho, true) };
+  const range rgeps{c.eps, eps_max};
+  const real_t eps_l  = rgeps.limit_to(eps);
+  const real_t eps_th = eps_l - c.eps;
+  return {eps_l, c.press + gm1_th * rho * eps_th, 
+          c.h * c.cs2 + gm1_th * (eps_th - c.press / rho),
+          gm1_th * rho};
+}
+
+void eos_hybrid::eval_rho_eps_ye(std::size_t n, const real_t* rho,
+                          const real_t* eps, const real_t* ye,
+                          const eos_thermal::result_arrays& res,
+                          bool* valid) const
+{
+  if ((res.temp != nullptr) || (res.sentr != nullptr)) {
+    throw runtime_error("eos_hybrid: temperature and entropy not "
+                        "implemented");
+  }
+  
+  const real_t nan{ numeric_limits<real_t>::quiet_NaN() };
+  const bool full{ (res.csnd != nullptr) 
+                   || (res.dpress_drho != nullptr) };
+  
+  for (std::size_t i = 0; i < n; ++i) {
+    bool ok{ rgrho.contains(rho[i]) && rgye.contains(ye[i]) };
+    cold_state c{0., 0., 1., 0.};
+    if (ok) {
+      c  = cold(rho[i], full);
+      ok = (eps[i] >= c.eps) && (eps[i] <= eps_max);
+    }
+    if (valid) valid[i] = ok;
+    
+    if (!ok) {
+      if (res.press)       res.press[i]       = nan;
+      if (res.csnd)        res.csnd[i]        = nan;
+      if (res.eps)         res.eps[i]         = nan;
+      if (res.dpress_drho) res.dpress_drho[i] = nan;
+      if (res.dpress_deps) res.dpress_deps[i] = nan;
+      continue;
+    }
+    
+    const real_t eps_th{ eps[i] - c.eps };
+    if (res.press) {
+      res.press[i] = c.press + gm1_th * rho[i] * eps_th;
+    }
+    if (res.csnd) {
+      const real_t h_th{ gamma_th * eps_th };
+      const real_t w{ h_th / (c.h + h_th) };
+      res.csnd[i] = sqrt((1.0 - w) * c.cs2 + w * gm1_th);
+    }
+    if (res.eps) {
+      res.eps[i] = eps[i];
+    }
+    if (res.dpress_drho) {
+      res.dpress_drho[i] = c.h * c.cs2 
+                           + gm1_th * (eps_th - c.press / rho[i]);
+    }
+    if (res.dpress_deps) {
+      res.dpress_deps[i] = gm1_th * rho[i];
+    }
+  }
 }
 
 eos_thermal_impl::range 
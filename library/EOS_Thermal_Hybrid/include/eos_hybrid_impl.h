@@ -14,13 +14,36 @@ class eos_hybrid : public eos_thermal_impl {
   const real_t min_h;   ///< Lower bound for enthalpy \f$ h \ge h_0 > 0 \f$
 
 
+  ///Quantities of the cold EOS at a given density
+  struct cold_state {
+    real_t eps;     ///< Specific energy \f$ \epsilon_c \f$
+    real_t press;   ///< Pressure \f$ P_c \f$
+    real_t h;       ///< Enthalpy \f$ h_c \f$ (if requested)
+    real_t cs2;     ///< Squared soundspeed \f$ c_{s,c}^2 \f$ (if requested)
+  };
+
+  ///Evaluate the cold EOS once, enthalpy and soundspeed only if full
+  auto cold(real_t rho, bool full) const -> cold_state;
   real_t eps_cold(real_t rho) const;
-  real_t p_cold(real_t rho) const;
-  real_t hm1_cold(real_t rho) const;
-  real_t cs2_cold(real_t rho) const;
 
   public:
 
+  ///Pressure, soundspeed, and pressure derivatives at one point
+  struct full_state_t {
+    real_t press;         ///< Pressure \f$ P \f$
+    real_t csnd;          ///< Speed of sound \f$ c_s \f$
+    real_t dpress_drho;   ///< \f$ \partial P / \partial \rho \f$
+    real_t dpress_deps;   ///< \f$ \partial P / \partial \epsilon \f$
+  };
+
+  ///Limited specific energy, pressure, and pressure derivatives
+  struct press_derivs_t {
+    real_t eps;           ///< Specific energy limited to valid range
+    real_t press;         ///< Pressure \f$ P \f$
+    real_t dpress_drho;   ///< \f$ \partial P / \partial \rho \f$
+    real_t dpress_deps;   ///< \f$ \partial P / \partial \epsilon \f$
+  };
+
   eos_hybrid(eos_barotr eos_c_,  real_t gamma_th_,  
              real_t eps_max_, real_t rho_max_); 
   ~eos_hybrid() final = default;
@@ -60,12 +83,17 @@ class eos_hybrid : public eos_thermal_impl {
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
   ) const final;
 
-  ///Compute pressure
+  ///Compute pressure. Defined inline for specialized code.
   real_t press(
     real_t rho,     ///<Rest mass density  \f$ \rho \f$
     real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
-  ) const final;
+  ) const final
+  {
+    const cold_state c{ cold(rho, false) };
+    real_t p_th  = gm1_th * rho * (eps - c.eps);
+    return c.press + p_th;
+  }
 
   ///Compute soundspeed
   real_t csnd(
@@ -100,10 +128,53 @@ class eos_hybrid : public eos_thermal_impl {
   /// Valid range for electron fraction
   const range& range_ye() const final {return rgye;}
 
+  ///Valid range for specific energy, bounded below by cold EOS.
   range range_eps(
     real_t rho,     ///<Rest mass density  \f$ \rho \f$
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
-  ) const final;
+  ) const final
+  {
+    return {eps_cold(rho), eps_max};
+  }
+
+  ///Limit specific energy and compute pressure, sharing cold part.
+  auto press_limited(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$ 
+  ) const -> eos_thermal::press_limited_t final;
+
+  /**\brief Compute pressure, soundspeed, and derivatives together
+  
+  This evaluates the cold EOS only once, instead of once for each 
+  quantity. 
+  
+  \pre Density and specific energy must be valid.
+  **/
+  auto full_state(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$ 
+  ) const -> full_state_t;
+
+  /**\brief Limit specific energy, compute pressure and derivatives
+  
+  This is the combination of press_limited() and the pressure 
+  derivatives, evaluating the cold EOS only once. 
+  
+  \pre Density must be valid.
+  **/
+  auto press_derivs_limited(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$ 
+  ) const -> press_derivs_t;
+
+  ///Evaluate many points, sharing the cold EOS state per point.
+  void eval_rho_eps_ye(std::size_t n, const real_t* rho, 
+                       const real_t* eps, const real_t* ye,
+                       const eos_thermal::result_arrays& res,
+                       bool* valid) const final;
 
   range range_temp(
     real_t rho,     ///<Rest mass density  \f$ \rho \f$
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 
 
 using namespace EOS_Toolkit;
@@ -31,58 +32,92 @@ eos_idealgas::eos_idealgas(real_t n_, real_t max_eps_, real_t max_rho_,
 
 /**
 Using the formula 
-\f[ P = \left(\Gamma - 1\right) \rho \epsilon \f]
+\f[ c_s^2 = \frac{\left(\Gamma - 1\right) \epsilon}{\epsilon + 1/\Gamma} \f]
 **/
-real_t eos_idealgas::press(real_t rho, real_t eps, real_t ye) const
+real_t eos_idealgas::csnd(real_t rho, real_t eps, real_t ye) const
 {
-  return gm1 * rho * eps;
+  return sqrt(gm1 * eps / (eps + 1.0/gamma));
 }
 
 /**
-Using the formula 
-\f[ c_s^2 = \frac{\left(\Gamma - 1\right) \epsilon}{\epsilon + 1/\Gamma} \f]
+Each requested quantity is computed in a separate loop without 
+function calls, such that the compiler can vectorize it. Invalid 
+points are replaced by NAN using a select instead of a branch.
 **/
-real_t eos_idealgas::csnd(real_t rho, real_t eps, real_t ye) const
+void eos_idealgas::eval_rho_eps_ye(std::size_t n, const real_t* rho,
+                          const real_t* eps, const real_t* ye,
+                          const eos_thermal::result_arrays& res,
+                          bool* valid) const
 {
-  return sqrt(gm1 * eps / (eps + 1.0/gamma));
+  if ((res.temp != nullptr) || (res.sentr != nullptr)) {
+    throw runtime_error("eos_idealgas: temperature and entropy not "
+                        "implemented");
+  }
+  
+  const real_t nan{ numeric_limits<real_t>::quiet_NaN() };
+  const real_t rho_min{ rgrho.min() }, rho_max{ rgrho.max() };
+  const real_t ye_min{ rgye.min() }, ye_max{ rgye.max() };
+  const real_t eps_min{ rgeps.min() }, eps_max{ rgeps.max() };
+  const real_t ginv{ 1.0 / gamma };
+  
+  auto ok = [&] (std::size_t i) -> bool {
+    return (rho[i] >= rho_min) & (rho[i] <= rho_max) 
+         & (ye[i] >= ye_min) & (ye[i] <= ye_max)
+         & (eps[i] >= eps_min) & (eps[i] <= eps_max);
+  };
+  
+  if (valid) {
+    for (std::size_t i = 0; i < n; ++i) {
+      valid[i] = ok(i);
+    }
+  }
+  if (res.press) {
+    for (std::size_t i = 0; i < n; ++i) {
+      res.press[i] = ok(i) ? gm1 * rho[i] * eps[i] : nan;
+    }
+  }
+  if (res.csnd) {
+    for (std::size_t i = 0; i < n; ++i) {
+      const real_t e{ ok(i) ? eps[i] : nan };
+      res.csnd[i] = sqrt(gm1 * e / (e + ginv));
+    }
+  }
+  if (res.eps) {
+    for (std::size_t i = 0; i < n; ++i) {
+      res.eps[i] = ok(i) ? eps[i] : nan;
+    }
+  }
+  if (res.dpress_drho) {
+    for (std::size_t i = 0; i < n; ++i) {
+      res.dpress_drho[i] = ok(i) ? gm1 * eps[i] : nan;
+    }
+  }
+  if (res.dpress_deps) {
+    for (std::size_t i = 0; i < n; ++i) {
+      res.dpress_deps[i] = ok(i) ? gm1 * rho[i] : nan;
+    }
+  }
 }
 
 real_t eos_idealgas::temp(real_t rho, real_t eps, real_t ye) const
 {
-  throw logic_error("eos_idealgas: temperature not implemented");
+  throw runtime_error("eos_idealgas: temperature not implemented");
 } 
 
-real_t eos_idealgas::dpress_drho(real_t rho, real_t eps, 
-                               real_t ye) const
-{
-  return gm1 * eps;
-}
-
-real_t eos_idealgas::dpress_deps(real_t rho, real_t eps, 
-                               real_t ye) const
-{
-  return gm1 * rho;
-}
-
 real_t eos_idealgas::sentr(real_t rho, real_t eps, real_t ye) const
 {
-  throw logic_error("eos_idealgas: entropy not implemented");
+  throw runtime_error("eos_idealgas: entropy not implemented");
 }
 
 real_t eos_idealgas::therm_from_rho_temp_ye(real_t rho, 
                                 real_t temp, real_t ye) const
 {
-  throw logic_error("eos_idealgas: temperature not implemented");
-}
-
-auto eos_idealgas::range_eps(real_t rho, real_t ye) const -> range
-{
-  return rgeps;
+  throw runtime_error("eos_idealgas: temperature not implemented");
 }
 
 auto eos_idealgas::range_temp(real_t rho, real_t ye) const -> range
 {
-  throw logic_error("eos_idealgas: temperature not implemented");
+  throw runtime_error("eos_idealgas: temperature not implemented");
 }
 
 
@@ -67,12 +67,20 @@ class eos_idealgas : public eos_thermal_impl {
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
   ) const final;
 
-  ///Compute pressure
+  /**\brief Compute pressure
+  
+  Using the formula 
+  \f[ P = \left(\Gamma - 1\right) \rho \epsilon \f]
+  Defined inline for use by code specialized to this EOS.
+  **/
   real_t press(
     real_t rho,     ///<Rest mass density  \f$ \rho \f$
     real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
-  ) const final;
+  ) const final
+  {
+    return gm1 * rho * eps;
+  }
 
   ///Compute soundspeed
   real_t csnd(
@@ -89,17 +97,25 @@ class eos_idealgas : public eos_thermal_impl {
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
   ) const final;
 
+  ///Partial derivative of pressure. Defined inline.
   real_t dpress_drho(
     real_t rho,     ///<Rest mass density  \f$ \rho \f$
     real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
-  ) const final;
+  ) const final
+  {
+    return gm1 * eps;
+  }
 
+  ///Partial derivative of pressure. Defined inline.
   real_t dpress_deps(
     real_t rho,     ///<Rest mass density  \f$ \rho \f$
     real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
-  ) const final;
+  ) const final
+  {
+    return gm1 * rho;
+  }
   
   /// Valid range for density
   const range& range_rho() const final {return rgrho;}
@@ -108,10 +124,31 @@ class eos_idealgas : public eos_thermal_impl {
   const range& range_ye() const final {return rgye;}
 
   
+  /// Valid range for specific energy (independent of density)
   range range_eps(
     real_t rho,     ///<Rest mass density  \f$ \rho \f$
     real_t ye       ///<Electron fraction \f$ Y_e \f$ 
-  ) const final;
+  ) const final
+  {
+    return rgeps;
+  }
+
+  ///Limit specific energy and compute pressure. Defined inline.
+  auto press_limited(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$ 
+  ) const -> eos_thermal::press_limited_t final
+  {
+    const real_t eps_l{ rgeps.limit_to(eps) };
+    return {eps_l, gm1 * rho * eps_l, rgeps};
+  }
+
+  ///Evaluate many points in vectorizable loops
+  void eval_rho_eps_ye(std::size_t n, const real_t* rho, 
+                       const real_t* eps, const real_t* ye,
+                       const eos_thermal::result_arrays& res,
+                       bool* valid) const final;
 
   [[ noreturn ]] 
   range range_temp(
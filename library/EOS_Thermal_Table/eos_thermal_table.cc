@@ -0,0 +1,394 @@
+#include "eos_thermal_table.h"
+#include "eos_thermal_table_impl.h"
+#include "table_interp.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <sstream>
+
+
+using namespace EOS_Toolkit;
+using namespace EOS_Toolkit::implementations;
+using namespace std;
+
+namespace {
+
+using detail::cell_index;
+
+using node_t = eos_thermal_table::node;
+
+/// Weighted sum of 4 nodes
+node_t wsum4(const node_t* n0, std::size_t sr, std::size_t sy,
+             real_t w00, real_t w10, real_t w01, real_t w11)
+{
+  return detail::wsum4<node_t, &node_t::eps, &node_t::press,
+                       &node_t::cs2, &node_t::sentr>(
+           n0, sr, sy, w00, w10, w01, w11);
+}
+
+}
+
+
+eos_thermal_table::eos_thermal_table(range rg_rho_, std::size_t n_rho_,
+                    range rg_temp_, std::size_t n_temp_,
+                    range rg_ye_, std::size_t n_ye_,
+                    const std::vector<real_t>& press_,
+                    const std::vector<real_t>& eps_,
+                    const std::vector<real_t>& cs2_,
+                    const std::vector<real_t>& sentr_,
+                    units units_)
+: eos_thermal_impl{units_}, nrho{n_rho_}, ntemp{n_temp_}, nye{n_ye_},
+  stride_rho{n_temp_}, stride_ye{n_rho_ * n_temp_},
+  rgrho{rg_rho_}, rgtemp{rg_temp_}, rgye{rg_ye_},
+  has_sentr{!sentr_.empty()}
+{
+  init_grid();
+
+  const std::size_t sz{ nrho * ntemp * nye };
+  if ((press_.size() != sz) || (eps_.size() != sz) ||
+      (cs2_.size() != sz) || (has_sentr && (sentr_.size() != sz)))
+  {
+    throw runtime_error("eos_thermal_table: mismatching table sizes");
+  }
+
+  std::vector<node> v_nodes(sz);
+  for (std::size_t iy = 0; iy < nye; ++iy) {
+    for (std::size_t it = 0; it < ntemp; ++it) {
+      for (std::size_t ir = 0; ir < nrho; ++ir) {
+        const std::size_t j{ (iy * ntemp + it) * nrho + ir };
+        node& n = v_nodes[iy * stride_ye + ir * stride_rho + it];
+        n.eps   = eps_[j];
+        n.press = press_[j];
+        n.cs2   = cs2_[j];
+        n.sentr = has_sentr ? sentr_[j] : 0.0;
+
+        if (!(isfinite(n.eps) && isfinite(n.press) &&
+              isfinite(n.cs2) && isfinite(n.sentr)))
+        {
+          throw runtime_error("eos_thermal_table: non-finite values");
+        }
+        if (n.press < 0) {
+          throw runtime_error("eos_thermal_table: negative pressure");
+        }
+        if (n.eps <= -1) {
+          throw runtime_error("eos_thermal_table: specific energy "
+                              "must be above -1");
+        }
+        if ((n.cs2 < 0) || (n.cs2 >= 1)) {
+          throw runtime_error("eos_thermal_table: soundspeed out of "
+                              "range");
+        }
+      }
+    }
+  }
+  nodes = shared_array<node>(std::move(v_nodes));
+
+  for (std::size_t c = 0; c < nrho * nye; ++c) {
+    const node* col{ &nodes[c * ntemp] };
+    for (std::size_t it = 1; it < ntemp; ++it) {
+      if (col[it].eps <= col[it - 1].eps) {
+        throw runtime_error("eos_thermal_table: specific energy not "
+                            "strictly increasing with temperature");
+      }
+    }
+  }
+
+  // Lower bound for interpolated h = 1 + eps + P / rho within
+  // each cell, using that interpolation weights are non-negative.
+  min_h = numeric_limits<real_t>::max();
+  for (std::size_t iy = 0; iy + 1 < nye; ++iy) {
+    for (std::size_t ir = 0; ir + 1 < nrho; ++ir) {
+      const real_t rho_hi{ (ir + 2 == nrho) ? rgrho.max()
+                                : exp(lrho0 + (ir + 1) * dlrho) };
+      for (std::size_t it = 0; it + 1 < ntemp; ++it) {
+        const node* n0{ &nodes[iy * stride_ye + ir * stride_rho + it] };
+        real_t eps_min{ numeric_limits<real_t>::max() };
+        real_t p_min{ numeric_limits<real_t>::max() };
+        for (std::size_t dy : {std::size_t(0), stride_ye}) {
+          for (std::size_t dr : {std::size_t(0), stride_rho}) {
+            for (std::size_t dt : {0, 1}) {
+              const node& n{ n0[dy + dr + dt] };
+              eps_min = min(eps_min, n.eps);
+              p_min   = min(p_min, n.press);
+            }
+          }
+        }
+        min_h = min(min_h, 1.0 + eps_min + p_min / rho_hi);
+      }
+    }
+  }
+  if (min_h <= 0) {
+    throw runtime_error("eos_thermal_table: cannot guarantee "
+                        "positive enthalpy");
+  }
+}
+
+eos_thermal_table::eos_thermal_table(range rg_rho_, std::size_t n_rho_,
+                    range rg_temp_, std::size_t n_temp_,
+                    range rg_ye_, std::size_t n_ye_,
+                    shared_array<node> nodes_, bool has_sentr_,
+                    real_t min_h_, units units_)
+: eos_thermal_impl{units_}, nrho{n_rho_}, ntemp{n_temp_}, nye{n_ye_},
+  stride_rho{n_temp_}, stride_ye{n_rho_ * n_temp_},
+  rgrho{rg_rho_}, rgtemp{rg_temp_}, rgye{rg_ye_},
+  has_sentr{has_sentr_}, min_h{min_h_}, nodes{std::move(nodes_)}
+{
+  init_grid();
+  if (nodes.size() != nrho * ntemp * nye) {
+    throw runtime_error("eos_thermal_table: mismatching table sizes");
+  }
+  if (!(min_h > 0)) {
+    throw runtime_error("eos_thermal_table: cannot guarantee "
+                        "positive enthalpy");
+  }
+}
+
+void eos_thermal_table::init_grid()
+{
+  if ((nrho < 2) || (ntemp < 2) || (nye < 2)) {
+    throw runtime_error("eos_thermal_table: need at least 2 samples "
+                        "along each axis");
+  }
+  if ((rgrho.min() <= 0) || (rgrho.max() <= rgrho.min())) {
+    throw runtime_error("eos_thermal_table: invalid density range");
+  }
+  if ((rgtemp.min() <= 0) || (rgtemp.max() <= rgtemp.min())) {
+    throw runtime_error("eos_thermal_table: invalid temperature range");
+  }
+  if (rgye.max() <= rgye.min()) {
+    throw runtime_error("eos_thermal_table: invalid electron fraction "
+                        "range");
+  }
+
+  lrho0       = log(rgrho.min());
+  dlrho       = (log(rgrho.max()) - lrho0) / (nrho - 1);
+  dlrho_inv   = 1.0 / dlrho;
+  ltemp0      = log(rgtemp.min());
+  dltemp      = (log(rgtemp.max()) - ltemp0) / (ntemp - 1);
+  dltemp_inv  = 1.0 / dltemp;
+  dye         = (rgye.max() - rgye.min()) / (nye - 1);
+  dye_inv     = 1.0 / dye;
+}
+
+
+auto eos_thermal_table::locate(real_t rho, real_t ye) const -> column
+{
+  column c;
+  const std::size_t ir{ cell_index((log(rho) - lrho0) * dlrho_inv,
+                                   nrho, c.frho) };
+  const std::size_t iy{ cell_index((ye - rgye.min()) * dye_inv,
+                                   nye, c.fye) };
+  c.off = iy * stride_ye + ir * stride_rho;
+  return c;
+}
+
+auto eos_thermal_table::blend(const column& c, std::size_t it) const
+-> node
+{
+  const real_t gr{ 1.0 - c.frho };
+  const real_t gy{ 1.0 - c.fye };
+  return wsum4(&nodes[c.off + it], stride_rho, stride_ye,
+               gr * gy, c.frho * gy, gr * c.fye, c.frho * c.fye);
+}
+
+auto eos_thermal_table::blend_drho(const column& c,
+                                   std::size_t it) const -> node
+{
+  const real_t gy{ 1.0 - c.fye };
+  return wsum4(&nodes[c.off + it], stride_rho, stride_ye,
+               -gy, gy, -c.fye, c.fye);
+}
+
+void eos_thermal_table::locate_temp(real_t ltemp, std::size_t& it,
+                                    real_t& ft) const
+{
+  it = cell_index((ltemp - ltemp0) * dltemp_inv, ntemp, ft);
+}
+
+/**
+Bisection over the temperature samples of the column. On entry, lo
+and hi have to contain the nodes interpolated at the lowest and
+highest temperature, on exit they contain those bracketing the
+given specific energy.
+**/
+void eos_thermal_table::find_temp(const column& c, real_t eps,
+                                  node& lo, node& hi,
+                                  std::size_t& it, real_t& ft) const
+{
+  std::size_t ilo{ 0 };
+  std::size_t ihi{ ntemp - 1 };
+  while (ihi - ilo > 1) {
+    const std::size_t imid{ (ilo + ihi) / 2 };
+    const node mid{ blend(c, imid) };
+    if (eps < mid.eps) {
+      ihi = imid;
+      hi  = mid;
+    }
+    else {
+      ilo = imid;
+      lo  = mid;
+    }
+  }
+  it = ilo;
+  ft = min(max((eps - lo.eps) / (hi.eps - lo.eps), real_t(0)),
+           real_t(1));
+}
+
+auto eos_thermal_table::interp(real_t rho, real_t ltemp,
+                               real_t ye) const -> node
+{
+  const column c{ locate(rho, ye) };
+  std::size_t it;
+  real_t ft;
+  locate_temp(ltemp, it, ft);
+  const node a{ blend(c, it) };
+  const node b{ blend(c, it + 1) };
+  const real_t gt{ 1.0 - ft };
+  return {gt * a.eps   + ft * b.eps,   gt * a.press + ft * b.press,
+          gt * a.cs2   + ft * b.cs2,   gt * a.sentr + ft * b.sentr};
+}
+
+
+real_t eos_thermal_table::therm_from_rho_eps_ye(real_t rho, real_t eps,
+                                                real_t ye) const
+{
+  const column c{ locate(rho, ye) };
+  node lo{ blend(c, 0) };
+  node hi{ blend(c, ntemp - 1) };
+  std::size_t it;
+  real_t ft;
+  find_temp(c, eps, lo, hi, it, ft);
+  return ltemp0 + (it + ft) * dltemp;
+}
+
+real_t eos_thermal_table::therm_from_rho_temp_ye(real_t rho,
+                                     real_t temp, real_t ye) const
+{
+  return log(temp);
+}
+
+real_t eos_thermal_table::eps(real_t rho, real_t ltemp,
+                              real_t ye) const
+{
+  return interp(rho, ltemp, ye).eps;
+}
+
+real_t eos_thermal_table::temp(real_t rho, real_t ltemp,
+                               real_t ye) const
+{
+  return rgtemp.limit_to(exp(ltemp));
+}
+
+real_t eos_thermal_table::press(real_t rho, real_t ltemp,
+                                real_t ye) const
+{
+  return interp(rho, ltemp, ye).press;
+}
+
+real_t eos_thermal_table::csnd(real_t rho, real_t ltemp,
+                               real_t ye) const
+{
+  return sqrt(interp(rho, ltemp, ye).cs2);
+}
+
+real_t eos_thermal_table::sentr(real_t rho, real_t ltemp,
+                                real_t ye) const
+{
+  if (!has_sentr) {
+    throw runtime_error("eos_thermal_table: entropy not available");
+  }
+  return interp(rho, ltemp, ye).sentr;
+}
+
+real_t eos_thermal_table::dpress_deps(real_t rho, real_t ltemp,
+                                      real_t ye) const
+{
+  const column c{ locate(rho, ye) };
+  std::size_t it;
+  real_t ft;
+  locate_temp(ltemp, it, ft);
+  const node a{ blend(c, it) };
+  const node b{ blend(c, it + 1) };
+  return (b.press - a.press) / (b.eps - a.eps);
+}
+
+real_t eos_thermal_table::dpress_drho(real_t rho, real_t ltemp,
+                                      real_t ye) const
+{
+  const column c{ locate(rho, ye) };
+  std::size_t it;
+  real_t ft;
+  locate_temp(ltemp, it, ft);
+  const node a{ blend(c, it) };
+  const node b{ blend(c, it + 1) };
+  const node da{ blend_drho(c, it) };
+  const node db{ blend_drho(c, it + 1) };
+  const real_t gt{ 1.0 - ft };
+  const real_t dp_dfr{ gt * da.press + ft * db.press };
+  const real_t de_dfr{ gt * da.eps + ft * db.eps };
+  const real_t dp_de{ (b.press - a.press) / (b.eps - a.eps) };
+  return (dp_dfr - dp_de * de_dfr) * dlrho_inv / rho;
+}
+
+auto eos_thermal_table::range_eps(real_t rho, real_t ye) const -> range
+{
+  const column c{ locate(rho, ye) };
+  return {blend(c, 0).eps, blend(c, ntemp - 1).eps};
+}
+
+auto eos_thermal_table::press_limited(real_t rho, real_t eps,
+                                      real_t ye) const
+-> eos_thermal::press_limited_t
+{
+  const column c{ locate(rho, ye) };
+  node lo{ blend(c, 0) };
+  node hi{ blend(c, ntemp - 1) };
+  const range rgeps{lo.eps, hi.eps};
+  const real_t eps_l{ rgeps.limit_to(eps) };
+  std::size_t it;
+  real_t ft;
+  find_temp(c, eps_l, lo, hi, it, ft);
+  const real_t p{ (1.0 - ft) * lo.press + ft * hi.press };
+  return {eps_l, p, rgeps};
+}
+
+
+auto eos_thermal_table::descr_str() const -> std::string
+{
+  auto u = units_to_SI();
+  std::ostringstream s;
+  s.precision(15);
+  s.setf(std::ios::scientific);
+  s << "Tabulated thermal EOS, "
+    << "samples (rho, T, Y_e) = "
+    << nrho << " x " << ntemp << " x " << nye
+    << ", valid density range = ["
+    << (rgrho.min() * u.density()) << ", "
+    << (rgrho.max() * u.density())
+    << "] kg/m^3, "
+    << "temperature range = ["
+    << rgtemp.min() << ", " << rgtemp.max() << "]"
+    << ", electron fraction range = ["
+    << rgye.min() << ", " << rgye.max() << "]";
+
+  return s.str();
+}
+
+eos_thermal EOS_Toolkit::make_eos_thermal_table(
+  const eos_thermal::range& rg_rho, std::size_t n_rho,
+  const eos_thermal::range& rg_temp, std::size_t n_temp,
+  const eos_thermal::range& rg_ye, std::size_t n_ye,
+  const std::vector<real_t>& press,
+  const std::vector<real_t>& eps,
+  const std::vector<real_t>& cs2,
+  const std::vector<real_t>& sentr,
+  units units_)
+{
+  return eos_thermal{std::make_shared<eos_thermal_table>(
+                       rg_rho, n_rho, rg_temp, n_temp, rg_ye, n_ye,
+                       press, eps, cs2, sentr, units_)};
+}
@@ -0,0 +1,571 @@
+#include "eos_thermal_table.h"
+#include "eos_thermal_tabulated_impl.h"
+#include "table_interp.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <sstream>
+
+
+using namespace EOS_Toolkit;
+using namespace EOS_Toolkit::implementations;
+using namespace std;
+
+namespace {
+
+using detail::cell_index;
+
+using node_t = eos_thermal_tabulated::node;
+
+/// Weighted sum of 4 nodes
+node_t wsum4(const node_t* n0, std::size_t sr, std::size_t sy,
+             real_t w00, real_t w10, real_t w01, real_t w11)
+{
+  return detail::wsum4<node_t, &node_t::press, &node_t::cs2,
+                       &node_t::temp, &node_t::sentr>(
+           n0, sr, sy, w00, w10, w01, w11);
+}
+
+}
+
+
+eos_thermal_tabulated::eos_thermal_tabulated(
+                    range rg_rho_, std::size_t n_rho_,
+                    range rg_eps_th_, std::size_t n_eps_,
+                    range rg_ye_, std::size_t n_ye_,
+                    const std::vector<real_t>& eps_min_,
+                    const std::vector<real_t>& press_,
+                    const std::vector<real_t>& cs2_,
+                    const std::vector<real_t>& temp_,
+                    const std::vector<real_t>& sentr_,
+                    units units_)
+: eos_thermal_impl{units_}, nrho{n_rho_}, neps{n_eps_}, nye{n_ye_},
+  stride_rho{n_eps_}, stride_ye{n_rho_ * n_eps_},
+  step_ye{(n_ye_ > 1) ? n_rho_ * n_eps_ : 0},
+  step_ye_e{(n_ye_ > 1) ? n_rho_ : 0},
+  rgrho{rg_rho_}, rgepsth{rg_eps_th_}, rgye{rg_ye_},
+  has_temp{!temp_.empty()}, has_sentr{!sentr_.empty()}
+{
+  init_grid();
+
+  const std::size_t sz{ nrho * neps * nye };
+  if ((eps_min_.size() != nrho * nye) ||
+      (press_.size() != sz) || (cs2_.size() != sz) ||
+      (has_temp && (temp_.size() != sz)) ||
+      (has_sentr && (sentr_.size() != sz)))
+  {
+    throw runtime_error("eos_thermal_tabulated: mismatching table "
+                        "sizes");
+  }
+
+  std::vector<real_t> v_epsmin(eps_min_);
+  for (real_t e : v_epsmin) {
+    if (!isfinite(e) || (e <= -1)) {
+      throw runtime_error("eos_thermal_tabulated: specific energy "
+                          "must be above -1");
+    }
+  }
+  epsmin = shared_array<real_t>(std::move(v_epsmin));
+
+  std::vector<node> v_nodes(sz);
+  for (std::size_t iy = 0; iy < nye; ++iy) {
+    for (std::size_t ie = 0; ie < neps; ++ie) {
+      for (std::size_t ir = 0; ir < nrho; ++ir) {
+        const std::size_t j{ (iy * neps + ie) * nrho + ir };
+        node& n = v_nodes[iy * stride_ye + ir * stride_rho + ie];
+        n.press = press_[j];
+        n.cs2   = cs2_[j];
+        n.temp  = has_temp ? temp_[j] : 0.0;
+        n.sentr = has_sentr ? sentr_[j] : 0.0;
+
+        if (!(isfinite(n.press) && isfinite(n.cs2) &&
+              isfinite(n.temp) && isfinite(n.sentr)))
+        {
+          throw runtime_error("eos_thermal_tabulated: non-finite "
+                              "values");
+        }
+        if (n.press < 0) {
+          throw runtime_error("eos_thermal_tabulated: negative "
+                              "pressure");
+        }
+        if ((n.cs2 < 0) || (n.cs2 >= 1)) {
+          throw runtime_error("eos_thermal_tabulated: soundspeed out "
+                              "of range");
+        }
+      }
+    }
+  }
+
+  nodes = shared_array<node>(std::move(v_nodes));
+
+  // Lower bound for interpolated h = 1 + eps + P / rho within
+  // each cell, using that interpolation weights are non-negative
+  // and eps >= interpolated eps_min.
+  min_h = numeric_limits<real_t>::max();
+  for (std::size_t iy = 0; iy < max(nye, std::size_t(2)) - 1; ++iy) {
+    for (std::size_t ir = 0; ir + 1 < nrho; ++ir) {
+      const real_t rho_hi{ (ir + 2 == nrho) ? rgrho.max()
+                                : exp(lrho0 + (ir + 1) * dlrho) };
+      const real_t* e0{ &epsmin[iy * nrho + ir] };
+      const real_t e_min{ min(min(e0[0], e0[1]),
+                              min(e0[step_ye_e], e0[step_ye_e + 1])) };
+      for (std::size_t ie = 0; ie + 1 < neps; ++ie) {
+        const node* n0{ &nodes[iy * stride_ye + ir * stride_rho + ie] };
+        real_t p_min{ numeric_limits<real_t>::max() };
+        for (std::size_t dy : {std::size_t(0), step_ye}) {
+          for (std::size_t dr : {std::size_t(0), stride_rho}) {
+            for (std::size_t de : {0, 1}) {
+              p_min = min(p_min, n0[dy + dr + de].press);
+            }
+          }
+        }
+        min_h = min(min_h, 1.0 + e_min + p_min / rho_hi);
+      }
+    }
+  }
+  if (min_h <= 0) {
+    throw runtime_error("eos_thermal_tabulated: cannot guarantee "
+                        "positive enthalpy");
+  }
+}
+
+eos_thermal_tabulated::eos_thermal_tabulated(
+                    range rg_rho_, std::size_t n_rho_,
+                    range rg_eps_th_, std::size_t n_eps_,
+                    range rg_ye_, std::size_t n_ye_,
+                    shared_array<real_t> eps_min_,
+                    shared_array<node> nodes_,
+                    bool has_temp_, bool has_sentr_,
+                    real_t min_h_, units units_)
+: eos_thermal_impl{units_}, nrho{n_rho_}, neps{n_eps_}, nye{n_ye_},
+  stride_rho{n_eps_}, stride_ye{n_rho_ * n_eps_},
+  step_ye{(n_ye_ > 1) ? n_rho_ * n_eps_ : 0},
+  step_ye_e{(n_ye_ > 1) ? n_rho_ : 0},
+  rgrho{rg_rho_}, rgepsth{rg_eps_th_}, rgye{rg_ye_},
+  has_temp{has_temp_}, has_sentr{has_sentr_}, min_h{min_h_},
+  epsmin{std::move(eps_min_)}, nodes{std::move(nodes_)}
+{
+  init_grid();
+  if ((epsmin.size() != nrho * nye) || (nodes.size() != nrho * neps * nye))
+  {
+    throw runtime_error("eos_thermal_tabulated: mismatching table "
+                        "sizes");
+  }
+  if (!(min_h > 0)) {
+    throw runtime_error("eos_thermal_tabulated: cannot guarantee "
+                        "positive enthalpy");
+  }
+}
+
+void eos_thermal_tabulated::init_grid()
+{
+  if ((nrho < 2) || (neps < 2) || (nye < 1)) {
+    throw runtime_error("eos_thermal_tabulated: need at least 2 samples "
+                        "along density and energy axis");
+  }
+  if ((rgrho.min() <= 0) || (rgrho.max() <= rgrho.min())) {
+    throw runtime_error("eos_thermal_tabulated: invalid density range");
+  }
+  if ((rgepsth.min() <= 0) || (rgepsth.max() <= rgepsth.min())) {
+    throw runtime_error("eos_thermal_tabulated: invalid thermal "
+                        "energy range");
+  }
+  if (rgye.max() < rgye.min()) {
+    throw runtime_error("eos_thermal_tabulated: invalid electron "
+                        "fraction range");
+  }
+
+  lrho0     = log(rgrho.min());
+  dlrho     = (log(rgrho.max()) - lrho0) / (nrho - 1);
+  dlrho_inv = 1.0 / dlrho;
+  du        = log1p(rgepsth.max() / rgepsth.min()) / (neps - 1);
+  du_inv    = 1.0 / du;
+  dye       = (nye > 1) ? (rgye.max() - rgye.min()) / (nye - 1) : 0.0;
+  dye_inv   = (nye > 1) ? 1.0 / dye : 0.0;
+}
+
+
+auto eos_thermal_tabulated::locate(real_t rho, real_t ye) const
+-> column
+{
+  column c;
+  const std::size_t ir{ cell_index((log(rho) - lrho0) * dlrho_inv,
+                                   nrho, c.frho) };
+  const std::size_t iy{ cell_index((ye - rgye.min()) * dye_inv,
+                                   nye, c.fye) };
+  c.off = iy * stride_ye + ir * stride_rho;
+
+  const real_t* e0{ &epsmin[iy * nrho + ir] };
+  const real_t gy{ 1.0 - c.fye };
+  const real_t e_lo{ gy * e0[0] + c.fye * e0[step_ye_e] };
+  const real_t e_hi{ gy * e0[1] + c.fye * e0[step_ye_e + 1] };
+  c.eps_min  = e_lo + c.frho * (e_hi - e_lo);
+  c.deps_min = e_hi - e_lo;
+  return c;
+}
+
+auto eos_thermal_tabulated::blend(const column& c,
+                                  std::size_t ie) const -> node
+{
+  const real_t gr{ 1.0 - c.frho };
+  const real_t gy{ 1.0 - c.fye };
+  return wsum4(&nodes[c.off + ie], stride_rho, step_ye,
+               gr * gy, c.frho * gy, gr * c.fye, c.frho * c.fye);
+}
+
+auto eos_thermal_tabulated::blend_drho(const column& c,
+                                       std::size_t ie) const -> node
+{
+  const real_t gy{ 1.0 - c.fye };
+  return wsum4(&nodes[c.off + ie], stride_rho, step_ye,
+               -gy, gy, -c.fye, c.fye);
+}
+
+void eos_thermal_tabulated::locate_eps(const column& c, real_t eps,
+                                 std::size_t& ie, real_t& fe) const
+{
+  const real_t epsth{ max(eps - c.eps_min, real_t(0)) };
+  ie = cell_index(log1p(epsth / rgepsth.min()) * du_inv, neps, fe);
+}
+
+auto eos_thermal_tabulated::interp(real_t rho, real_t eps,
+                                   real_t ye) const -> node
+{
+  const column c{ locate(rho, ye) };
+  std::size_t ie;
+  real_t fe;
+  locate_eps(c, eps, ie, fe);
+  const node a{ blend(c, ie) };
+  const node b{ blend(c, ie + 1) };
+  const real_t ge{ 1.0 - fe };
+  return {ge * a.press + fe * b.press, ge * a.cs2   + fe * b.cs2,
+          ge * a.temp  + fe * b.temp,  ge * a.sentr + fe * b.sentr};
+}
+
+
+real_t eos_thermal_tabulated::therm_from_rho_temp_ye(real_t rho,
+                                     real_t temp, real_t ye) const
+{
+  throw runtime_error("eos_thermal_tabulated: temperature cannot be "
+                      "used as input");
+}
+
+real_t eos_thermal_tabulated::temp(real_t rho, real_t eps,
+                                   real_t ye) const
+{
+  if (!has_temp) {
+    throw runtime_error("eos_thermal_tabulated: temperature not "
+                        "available");
+  }
+  return interp(rho, eps, ye).temp;
+}
+
+real_t eos_thermal_tabulated::press(real_t rho, real_t eps,
+                                    real_t ye) const
+{
+  return interp(rho, eps, ye).press;
+}
+
+real_t eos_thermal_tabulated::csnd(real_t rho, real_t eps,
+                                   real_t ye) const
+{
+  return sqrt(interp(rho, eps, ye).cs2);
+}
+
+real_t eos_thermal_tabulated::sentr(real_t rho, real_t eps,
+                                    real_t ye) const
+{
+  if (!has_sentr) {
+    throw runtime_error("eos_thermal_tabulated: entropy not "
+                        "available");
+  }
+  return interp(rho, eps, ye).sentr;
+}
+
+real_t eos_thermal_tabulated::dpress_deps(real_t rho, real_t eps,
+                                          real_t ye) const
+{
+  const column c{ locate(rho, ye) };
+  std::size_t ie;
+  real_t fe;
+  locate_eps(c, eps, ie, fe);
+  const node a{ blend(c, ie) };
+  const node b{ blend(c, ie + 1) };
+  const real_t epsth{ max(eps - c.eps_min, real_t(0)) };
+  return (b.press - a.press) * du_inv / (rgepsth.min() + epsth);
+}
+
+real_t eos_thermal_tabulated::dpress_drho(real_t rho, real_t eps,
+                                          real_t ye) const
+{
+  const column c{ locate(rho, ye) };
+  std::size_t ie;
+  real_t fe;
+  locate_eps(c, eps, ie, fe);
+  const node a{ blend(c, ie) };
+  const node b{ blend(c, ie + 1) };
+  const node da{ blend_drho(c, ie) };
+  const node db{ blend_drho(c, ie + 1) };
+  const real_t ge{ 1.0 - fe };
+  const real_t epsth{ max(eps - c.eps_min, real_t(0)) };
+  const real_t dp_dfr{ ge * da.press + fe * db.press };
+  const real_t dp_de{ (b.press - a.press) * du_inv
+                      / (rgepsth.min() + epsth) };
+  return (dp_dfr - dp_de * c.deps_min) * dlrho_inv / rho;
+}
+
+auto eos_thermal_tabulated::range_eps(real_t rho, real_t ye) const
+-> range
+{
+  const column c{ locate(rho, ye) };
+  return {c.eps_min, c.eps_min + rgepsth.max()};
+}
+
+auto eos_thermal_tabulated::range_temp(real_t rho, real_t ye) const
+-> range
+{
+  throw runtime_error("eos_thermal_tabulated: temperature cannot be "
+                      "used as input");
+}
+
+auto eos_thermal_tabulated::press_limited(real_t rho, real_t eps,
+                                          real_t ye) const
+-> eos_thermal::press_limited_t
+{
+  const column c{ locate(rho, ye) };
+  const range rgeps{c.eps_min, c.eps_min + rgepsth.max()};
+  const real_t eps_l{ rgeps.limit_to(eps) };
+  std::size_t ie;
+  real_t fe;
+  locate_eps(c, eps_l, ie, fe);
+  const real_t p{ (1.0 - fe) * blend(c, ie).press
+                  + fe * blend(c, ie + 1).press };
+  return {eps_l, p, rgeps};
+}
+
+
+auto eos_thermal_tabulated::descr_str() const -> std::string
+{
+  auto u = units_to_SI();
+  std::ostringstream s;
+  s.precision(15);
+  s.setf(std::ios::scientific);
+  s << "Thermal EOS tabulated in specific energy, "
+    << "samples (rho, eps_th, Y_e) = "
+    << nrho << " x " << neps << " x " << nye
+    << ", valid density range = ["
+    << (rgrho.min() * u.density()) << ", "
+    << (rgrho.max() * u.density())
+    << "] kg/m^3, "
+    << "thermal energy range = [0, " << rgepsth.max()
+    << "], logarithmic above " << rgepsth.min()
+    << ", electron fraction range = ["
+    << rgye.min() << ", " << rgye.max() << "]";
+
+  return s.str();
+}
+
+
+namespace {
+
+///Samples of an EOS taken by make_eos_thermal_tabulated()
+struct sampler {
+  const eos_thermal& eos;
+  eos_thermal::range rg_rho, rg_eps_th, rg_ye;
+  bool has_temp, has_sentr;
+
+  real_t rho_at(std::size_t i, std::size_t n) const;
+  real_t eps_th_at(std::size_t i, std::size_t n) const;
+  real_t ye_at(std::size_t i, std::size_t n) const;
+
+  auto sample(std::size_t n_rho, std::size_t n_eps,
+              std::size_t n_ye) const
+  -> std::shared_ptr<eos_thermal_tabulated>;
+
+  real_t error(const eos_thermal_tabulated& tab, real_t rho,
+               real_t eps_th, real_t ye) const;
+};
+
+real_t sampler::rho_at(std::size_t i, std::size_t n) const
+{
+  const real_t l0{ log(rg_rho.min()) };
+  const real_t l1{ log(rg_rho.max()) };
+  return rg_rho.limit_to(exp(l0 + i * (l1 - l0) / (n - 1)));
+}
+
+real_t sampler::eps_th_at(std::size_t i, std::size_t n) const
+{
+  const real_t u1{ log1p(rg_eps_th.max() / rg_eps_th.min()) };
+  return min(rg_eps_th.min() * expm1(i * u1 / (n - 1)),
+             rg_eps_th.max());
+}
+
+real_t sampler::ye_at(std::size_t i, std::size_t n) const
+{
+  if (n < 2) {
+    return 0.5 * (rg_ye.min() + rg_ye.max());
+  }
+  return rg_ye.limit_to(rg_ye.min()
+                        + i * (rg_ye.max() - rg_ye.min()) / (n - 1));
+}
+
+auto sampler::sample(std::size_t n_rho, std::size_t n_eps,
+                     std::size_t n_ye) const
+-> std::shared_ptr<eos_thermal_tabulated>
+{
+  const std::size_t sz{ n_rho * n_eps * n_ye };
+  std::vector<real_t> v_emin(n_rho * n_ye), v_p(sz), v_cs2(sz);
+  std::vector<real_t> v_t(has_temp ? sz : 0);
+  std::vector<real_t> v_s(has_sentr ? sz : 0);
+
+  for (std::size_t iy = 0; iy < n_ye; ++iy) {
+    const real_t ye{ ye_at(iy, n_ye) };
+    for (std::size_t ir = 0; ir < n_rho; ++ir) {
+      const real_t rho{ rho_at(ir, n_rho) };
+      const auto rg_eps = eos.range_eps(rho, ye);
+      if (rg_eps.max() < rg_eps.min() + rg_eps_th.max()) {
+        throw runtime_error("make_eos_thermal_tabulated: thermal "
+                            "energy range exceeds validity range of "
+                            "EOS");
+      }
+      v_emin[iy * n_rho + ir] = rg_eps.min();
+      for (std::size_t ie = 0; ie < n_eps; ++ie) {
+        const real_t eps{ rg_eps.limit_to(rg_eps.min()
+                                          + eps_th_at(ie, n_eps)) };
+        const auto s = eos.at_rho_eps_ye(rho, eps, ye);
+        if (!s) {
+          throw runtime_error("make_eos_thermal_tabulated: EOS "
+                              "invalid at sample point");
+        }
+        const std::size_t j{ (iy * n_eps + ie) * n_rho + ir };
+        v_p[j]   = s.press();
+        v_cs2[j] = pow(s.csnd(), 2);
+        if (has_temp) v_t[j] = s.temp();
+        if (has_sentr) v_s[j] = s.sentr();
+      }
+    }
+  }
+
+  return std::make_shared<eos_thermal_tabulated>(
+           rg_rho, n_rho, rg_eps_th, n_eps, rg_ye, n_ye,
+           v_emin, v_p, v_cs2, v_t, v_s, eos.units_to_SI());
+}
+
+/**
+Relative deviation of pressure. Pressures below
+\f$ \rho \epsilon_s \f$ are treated as absolute errors, where
+\f$ \epsilon_s \f$ is the scale below which the thermal energy is
+sampled linearly. The soundspeed is not used since it can be
+discontinuous, e.g. for piecewise polytropic cold EOS.
+**/
+real_t sampler::error(const eos_thermal_tabulated& tab, real_t rho,
+                      real_t eps_th, real_t ye) const
+{
+  const auto rg_eps = eos.range_eps(rho, ye);
+  const real_t eps{ rg_eps.limit_to(rg_eps.min() + eps_th) };
+  const auto s = eos.at_rho_eps_ye(rho, eps, ye);
+  if (!s) {
+    throw runtime_error("make_eos_thermal_tabulated: EOS "
+                        "invalid at test point");
+  }
+  const real_t p{ s.press() };
+  const auto pl = tab.press_limited(rho, eps, ye);
+  return fabs(pl.press - p) / (p + rho * rg_eps_th.min());
+}
+
+}
+
+eos_thermal EOS_Toolkit::make_eos_thermal_tabulated(
+  const eos_thermal& eos,
+  const eos_thermal::range& rg_rho,
+  const eos_thermal::range& rg_eps_th,
+  std::size_t resolution,
+  real_t err_target,
+  std::size_t max_samples)
+{
+  if ((rg_rho.min() <= 0) || (rg_rho.max() <= rg_rho.min())) {
+    throw invalid_argument("make_eos_thermal_tabulated: invalid "
+                           "density range");
+  }
+  if ((rg_eps_th.min() <= 0) || (rg_eps_th.max() <= rg_eps_th.min())) {
+    throw invalid_argument("make_eos_thermal_tabulated: invalid "
+                           "thermal energy range");
+  }
+  if ((resolution < 1) || !(err_target > 0)) {
+    throw invalid_argument("make_eos_thermal_tabulated: resolution and "
+                           "error target have to be positive");
+  }
+  if (!eos.range_rho().contains(rg_rho)) {
+    throw invalid_argument("make_eos_thermal_tabulated: density range "
+                           "exceeds validity range of EOS");
+  }
+
+  const auto rg_ye = eos.range_ye();
+  const real_t rho0{ rg_rho.min() };
+  const real_t ye0{ rg_ye.limit_to(0.5 * (rg_ye.min() + rg_ye.max())) };
+  const auto s0 = eos.at_rho_eps_ye(rho0,
+                                    eos.range_eps(rho0, ye0).min(), ye0);
+  if (!s0) {
+    throw runtime_error("make_eos_thermal_tabulated: EOS invalid at "
+                        "lower range boundary");
+  }
+  bool has_temp{ true };
+  bool has_sentr{ true };
+  try { s0.temp(); } catch (const std::exception&) { has_temp = false; }
+  try { s0.sentr(); } catch (const std::exception&) { has_sentr = false; }
+
+  const sampler smp{eos, rg_rho, rg_eps_th, rg_ye, has_temp, has_sentr};
+
+  auto decades = [resolution] (real_t ratio) -> std::size_t {
+    return std::size_t(ceil(resolution * log10(ratio))) + 1;
+  };
+  std::size_t n_rho{ max(decades(rg_rho.max() / rg_rho.min()),
+                         std::size_t(2)) };
+  std::size_t n_eps{ max(decades(1.0 + rg_eps_th.max()
+                                       / rg_eps_th.min()),
+                         std::size_t(2)) };
+  std::size_t n_ye{ 1 };
+
+  // Compare to the EOS at cell midpoints along each axis separately
+  // and refine those axes which exceed the error target.
+  while (true) {
+    if (n_rho * n_eps * n_ye > max_samples) {
+      throw runtime_error("make_eos_thermal_tabulated: cannot reach "
+                          "error target within maximum table size");
+    }
+    auto tab = smp.sample(n_rho, n_eps, n_ye);
+
+    const std::size_t m_ye{ (n_ye > 1) ? 2 * n_ye - 1 : 3 };
+    real_t err_rho{ 0 }, err_eps{ 0 }, err_ye{ 0 };
+    for (std::size_t jy = 0; jy < m_ye; ++jy) {
+      const real_t ye{ smp.ye_at(jy, m_ye) };
+      const bool mid_ye{ (n_ye > 1) ? (jy % 2 == 1) : (jy != 1) };
+      for (std::size_t jr = 0; jr < 2 * n_rho - 1; ++jr) {
+        const real_t rho{ smp.rho_at(jr, 2 * n_rho - 1) };
+        const bool mid_rho{ jr % 2 == 1 };
+        for (std::size_t je = 0; je < 2 * n_eps - 1; ++je) {
+          const bool mid_eps{ je % 2 == 1 };
+          if (int(mid_ye) + int(mid_rho) + int(mid_eps) != 1) continue;
+          const real_t eps_th{ smp.eps_th_at(je, 2 * n_eps - 1) };
+          const real_t err{ smp.error(*tab, rho, eps_th, ye) };
+          if (mid_rho) err_rho = max(err_rho, err);
+          if (mid_eps) err_eps = max(err_eps, err);
+          if (mid_ye)  err_ye  = max(err_ye, err);
+        }
+      }
+    }
+
+    if ((err_rho <= err_target) && (err_eps <= err_target)
+        && (err_ye <= err_target))
+    {
+      return eos_thermal{tab};
+    }
+    if (err_rho > err_target) n_rho = 2 * n_rho - 1;
+    if (err_eps > err_target) n_eps = 2 * n_eps - 1;
+    if (err_ye > err_target)  n_ye  = (n_ye > 1) ? 2 * n_ye - 1 : 2;
+  }
+}
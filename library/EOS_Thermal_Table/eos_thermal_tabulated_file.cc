@@ -0,0 +1,170 @@
+#include "datastore.h"
+#include "eos_thermal_file_impl.h"
+#include "eos_thermal_mapped_impl.h"
+#include "eos_thermal_tabulated_impl.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace EOS_Toolkit {
+namespace implementations {
+
+const std::string eos_thermal_tabulated::datastore_id{
+  "thermal_tabulated"
+};
+
+struct reader_eos_thermal_tabulated : reader_eos_thermal
+{
+  eos_thermal load(const datasource g, const units& u) const final;
+};
+
+const bool eos_thermal_tabulated::file_handler_registered {
+  registry_reader_eos_thermal::add(eos_thermal_tabulated::datastore_id,
+                                  new reader_eos_thermal_tabulated())
+};
+
+struct reader_mapped_eos_thermal_tabulated : reader_mapped_eos_thermal
+{
+  eos_thermal load(const mapped_eos_reader& r) const final;
+};
+
+const bool eos_thermal_tabulated::mapped_handler_registered {
+  registry_reader_mapped_eos_thermal::add(
+    eos_thermal_tabulated::datastore_id,
+    new reader_mapped_eos_thermal_tabulated())
+};
+
+static_assert(
+  std::is_trivially_copyable<eos_thermal_tabulated::node>::value
+  && std::is_standard_layout<eos_thermal_tabulated::node>::value,
+  "Table nodes must be usable in place from mapped files");
+
+eos_thermal reader_eos_thermal_tabulated::load(const datasource g,
+                                               const units& u) const
+{
+  real_t rho_min    = g["rho_min"];
+  real_t rho_max    = g["rho_max"];
+  int n_rho         = g["n_rho"];
+  real_t eps_th_min = g["eps_th_min"];
+  real_t eps_th_max = g["eps_th_max"];
+  int n_eps         = g["n_eps"];
+  real_t ye_min     = g["ye_min"];
+  real_t ye_max     = g["ye_max"];
+  int n_ye          = g["n_ye"];
+
+  std::vector<real_t> v_emin = g["eps_min"];
+  std::vector<real_t> v_p    = g["press"];
+  std::vector<real_t> v_cs   = g["csnd"];
+
+  std::vector<real_t> v_t, v_s;
+  if (g.has_data("temp")) {
+    v_t = g["temp"];
+  }
+  if (g.has_data("sentr")) {
+    v_s = g["sentr"];
+  }
+
+  if ((n_rho < 2) || (n_eps < 2) || (n_ye < 1)) {
+    throw std::runtime_error("Corrupt tabulated thermal EOS file "
+                             "(invalid table dimensions)");
+  }
+
+  std::vector<real_t> v_cs2(v_cs.size());
+  for (std::size_t i = 0; i < v_p.size(); ++i) {
+    v_p[i] /= u.pressure();
+  }
+  for (std::size_t i = 0; i < v_cs.size(); ++i) {
+    v_cs2[i] = std::pow(v_cs[i] / u.velocity(), 2);
+  }
+
+  return eos_thermal{std::make_shared<eos_thermal_tabulated>(
+           eos_thermal::range{rho_min / u.density(),
+                              rho_max / u.density()}, n_rho,
+           eos_thermal::range{eps_th_min, eps_th_max}, n_eps,
+           eos_thermal::range{ye_min, ye_max}, n_ye,
+           v_emin, v_p, v_cs2, v_t, v_s, u)};
+}
+
+
+void eos_thermal_tabulated::save(datasink g) const
+{
+  auto u = units_to_SI();
+  g["eos_type"]   = datastore_id;
+  g["rho_min"]    = rgrho.min() * u.density();
+  g["rho_max"]    = rgrho.max() * u.density();
+  g["n_rho"]      = int(nrho);
+  g["eps_th_min"] = rgepsth.min();
+  g["eps_th_max"] = rgepsth.max();
+  g["n_eps"]      = int(neps);
+  g["ye_min"]     = rgye.min();
+  g["ye_max"]     = rgye.max();
+  g["n_ye"]       = int(nye);
+  g["eps_min"]    = std::vector<real_t>(epsmin.begin(), epsmin.end());
+
+  const std::size_t sz{ nodes.size() };
+  std::vector<real_t> v_p(sz), v_cs(sz), v_t(sz), v_s(sz);
+  for (std::size_t iy = 0; iy < nye; ++iy) {
+    for (std::size_t ie = 0; ie < neps; ++ie) {
+      for (std::size_t ir = 0; ir < nrho; ++ir) {
+        const std::size_t j{ (iy * neps + ie) * nrho + ir };
+        const node& n = nodes[iy * stride_ye + ir * stride_rho + ie];
+        v_p[j]  = n.press * u.pressure();
+        v_cs[j] = std::sqrt(n.cs2) * u.velocity();
+        v_t[j]  = n.temp;
+        v_s[j]  = n.sentr;
+      }
+    }
+  }
+  g["press"] = v_p;
+  g["csnd"]  = v_cs;
+  if (has_temp) {
+    g["temp"] = v_t;
+  }
+  if (has_sentr) {
+    g["sentr"] = v_s;
+  }
+}
+
+
+/*
+Mapped layout: dims = (n_rho, n_eps, n_ye, has_temp, has_sentr),
+params = (rho_min, rho_max, eps_th_min, eps_th_max, ye_min, ye_max,
+min_h), section 0 = eps_min, section 1 = nodes in internal order.
+All in EOS units.
+*/
+void eos_thermal_tabulated::save_mapped(mapped_eos_writer& w) const
+{
+  w.set_eos_type(datastore_id);
+  w.set_dim(0, nrho);
+  w.set_dim(1, neps);
+  w.set_dim(2, nye);
+  w.set_dim(3, has_temp ? 1 : 0);
+  w.set_dim(4, has_sentr ? 1 : 0);
+  w.set_param(0, rgrho.min());
+  w.set_param(1, rgrho.max());
+  w.set_param(2, rgepsth.min());
+  w.set_param(3, rgepsth.max());
+  w.set_param(4, rgye.min());
+  w.set_param(5, rgye.max());
+  w.set_param(6, min_h);
+  w.add_section(epsmin);
+  w.add_section(nodes);
+}
+
+eos_thermal reader_mapped_eos_thermal_tabulated::load(
+                                   const mapped_eos_reader& r) const
+{
+  using node = eos_thermal_tabulated::node;
+  return eos_thermal{std::make_shared<eos_thermal_tabulated>(
+           eos_thermal::range{r.param(0), r.param(1)}, r.dim(0),
+           eos_thermal::range{r.param(2), r.param(3)}, r.dim(1),
+           eos_thermal::range{r.param(4), r.param(5)}, r.dim(2),
+           r.section<real_t>(0), r.section<node>(1),
+           r.dim(3) != 0, r.dim(4) != 0, r.param(6),
+           r.units_to_SI())};
+}
+
+}
+}
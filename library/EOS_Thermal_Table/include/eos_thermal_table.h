@@ -0,0 +1,109 @@
+#ifndef EOS_THERMAL_TABLE_H
+#define EOS_THERMAL_TABLE_H
+#include "eos_thermal.h"
+#include <cstddef>
+#include <vector>
+
+namespace EOS_Toolkit {
+
+/**\brief Create tabulated thermal EOS
+
+The EOS is given by samples on a regular grid in 
+\f$ \ln(\rho), \ln(T), Y_e \f$, and evaluated using trilinear 
+interpolation. For each combination of density and electron fraction,
+the specific energy has to be strictly increasing with temperature.
+The validity range is given by the tabulated ranges of density, 
+temperature, and electron fraction.
+
+The sample vectors use the index 
+\f$ (i_{Y_e} n_T + i_T) n_\rho + i_\rho \f$, i.e. density is the 
+fastest varying index. The parameters are w.r.t EOS units, except 
+temperature, which is never converted. The EOS units given in the 
+last parameter are stored for bookkeeping.
+
+@param rg_rho  Range of mass density \f$ \rho > 0 \f$, sampled 
+               logarithmically
+@param n_rho   Number of density samples (at least 2)
+@param rg_temp Range of temperature \f$ T > 0 \f$, sampled 
+               logarithmically
+@param n_temp  Number of temperature samples (at least 2)
+@param rg_ye   Range of electron fraction, sampled linearly
+@param n_ye    Number of electron fraction samples (at least 2)
+@param press   Samples of pressure \f$ P \ge 0 \f$
+@param eps     Samples of specific energy \f$ \epsilon > -1 \f$
+@param cs2     Samples of squared soundspeed \f$ 0 \le c_s^2 < 1 \f$
+@param sentr   Samples of specific entropy, or empty vector (in which
+               case the EOS will not provide entropy)
+@param units_  Unit system (w.r.t. SI) of the EOS
+
+@return Generic interface employing tabulated thermal EOS
+**/
+eos_thermal make_eos_thermal_table(
+  const eos_thermal::range& rg_rho, std::size_t n_rho,
+  const eos_thermal::range& rg_temp, std::size_t n_temp,
+  const eos_thermal::range& rg_ye, std::size_t n_ye,
+  const std::vector<real_t>& press,
+  const std::vector<real_t>& eps,
+  const std::vector<real_t>& cs2,
+  const std::vector<real_t>& sentr,
+  units units_=units::geom_solar()
+);
+
+
+/**\brief Create tabulated version of a given thermal EOS
+
+This samples an arbitrary thermal EOS on a regular grid in
+\f$ \ln(\rho) \f$, \f$ \ln(1 + \epsilon_\mathrm{th}/\epsilon_s) \f$,
+and \f$ Y_e \f$, where
+\f$ \epsilon_\mathrm{th} = \epsilon - \epsilon_\mathrm{min}(\rho, Y_e) \f$
+is the specific energy above the lower validity bound of the
+original EOS. The latter is tabulated as well. The returned EOS uses
+trilinear interpolation and specific energy as thermal variable,
+which is cheaper than evaluating EOS with expensive cold parts.
+It can be saved to file like any other EOS.
+
+The sampling is refined until the relative deviation of the pressure
+at the centers between samples is below a given target. Pressures
+below \f$ \rho \epsilon_s \f$ are compared absolutely. The
+soundspeed is not taken into account since it can be discontinuous,
+e.g. for piecewise polytropic cold EOS. Note that kinks of the
+pressure, as for piecewise polytropes, are only resolved to first 
+order and may require many density samples. The
+electron fraction is first sampled only at the center of the valid
+range, and the deviation is measured at the boundaries. This way,
+no electron fraction samples are stored for EOS that do not depend
+on it.
+
+Temperature and entropy are tabulated if available in the
+original EOS. Temperature cannot be used as input.
+
+@param eos        The EOS to be tabulated
+@param rg_rho     Range of mass density \f$ \rho > 0 \f$. Must be
+                  within the validity range of the EOS
+@param rg_eps_th  Range \f$ [\epsilon_s, \epsilon_\mathrm{max}] \f$ of
+                  thermal specific energy, where
+                  \f$ \epsilon_\mathrm{max} \f$ is the upper bound of
+                  the tabulated range and \f$ \epsilon_s > 0 \f$ the
+                  scale below which the sampling becomes linear. The
+                  EOS has to be valid up to \f$ \epsilon_\mathrm{max} \f$
+@param resolution Initial number of samples per decade in density
+                  and in \f$ 1 + \epsilon_\mathrm{th}/\epsilon_s \f$
+@param err_target Target for relative error
+@param max_samples Maximum total number of samples. If the error
+                   target cannot be reached, an exception is thrown.
+
+@return Generic interface employing the tabulated EOS
+**/
+eos_thermal make_eos_thermal_tabulated(
+  const eos_thermal& eos,
+  const eos_thermal::range& rg_rho,
+  const eos_thermal::range& rg_eps_th,
+  std::size_t resolution,
+  real_t err_target,
+  std::size_t max_samples=std::size_t(1) << 24
+);
+
+
+} // namespace EOS_Toolkit
+
+#endif
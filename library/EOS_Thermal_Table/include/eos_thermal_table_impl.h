@@ -0,0 +1,204 @@
+#ifndef EOS_THERMAL_TABLE_IMPL_H
+#define EOS_THERMAL_TABLE_IMPL_H
+
+#include "eos_thermal_impl.h"
+#include "shared_array.h"
+#include <cstddef>
+#include <vector>
+
+namespace EOS_Toolkit {
+
+namespace implementations {
+
+///Tabulated thermal EOS.
+/**
+This uses trilinear interpolation on a regular grid in
+\f$ \ln(\rho), \ln(T), Y_e \f$. The thermal variable is
+\f$ \ln(T) \f$.
+
+All quantities belonging to one grid point are stored together
+(see \ref node), and the table is ordered such that temperature is
+the fastest varying index. The 8 nodes needed for interpolation are
+thus stored in 4 contiguous pairs, and a single stencil fetch
+provides pressure, specific energy, soundspeed, and the derivatives.
+Since the interpolation is linear in \f$ \ln(T) \f$ for fixed density
+and electron fraction, computing temperature from specific energy is
+done exactly by searching the bracketing grid points.
+**/
+class eos_thermal_table : public eos_thermal_impl {
+  public:
+
+  ///Quantities stored for each grid point.
+  struct node {
+    real_t eps;     ///< Specific energy \f$ \epsilon \f$
+    real_t press;   ///< Pressure \f$ P \f$
+    real_t cs2;     ///< Squared soundspeed \f$ c_s^2 \f$
+    real_t sentr;   ///< Specific entropy (zero if not available)
+  };
+
+  private:
+
+  ///Location within the table for given density and electron fraction
+  struct column {
+    std::size_t off;   ///< Offset of first node of the 4 columns
+    real_t frho;       ///< Fractional index for density
+    real_t fye;        ///< Fractional index for electron fraction
+  };
+
+  std::size_t nrho, ntemp, nye;
+  std::size_t stride_rho, stride_ye;
+  range rgrho;      ///< Valid range for density \f$ \rho \f$
+  range rgtemp;     ///< Valid range for temperature \f$ T \f$
+  range rgye;       ///< Valid range for electron fraction \f$ Y_e \f$
+  real_t lrho0, dlrho, dlrho_inv;
+  real_t ltemp0, dltemp, dltemp_inv;
+  real_t dye, dye_inv;
+  bool has_sentr;
+  real_t min_h;     ///< Lower bound for enthalpy \f$ h \ge h_0 > 0 \f$
+
+  shared_array<node> nodes;
+
+  void init_grid();
+  auto locate(real_t rho, real_t ye) const -> column;
+  auto blend(const column& c, std::size_t it) const -> node;
+  auto blend_drho(const column& c, std::size_t it) const -> node;
+  void find_temp(const column& c, real_t eps, node& lo, node& hi,
+                 std::size_t& it, real_t& ft) const;
+  void locate_temp(real_t ltemp, std::size_t& it, real_t& ft) const;
+  auto interp(real_t rho, real_t ltemp, real_t ye) const -> node;
+
+  public:
+
+  ///Constructor. Samples are ordered as for make_eos_thermal_table()
+  eos_thermal_table(range rg_rho_, std::size_t n_rho_,
+                    range rg_temp_, std::size_t n_temp_,
+                    range rg_ye_, std::size_t n_ye_,
+                    const std::vector<real_t>& press_,
+                    const std::vector<real_t>& eps_,
+                    const std::vector<real_t>& cs2_,
+                    const std::vector<real_t>& sentr_,
+                    units units_);
+
+  /**\brief Constructor from prepared node array
+  
+  This is used for memory-mapped tables. The nodes are ordered as
+  used internally, and the values are not validated.
+  **/
+  eos_thermal_table(range rg_rho_, std::size_t n_rho_,
+                    range rg_temp_, std::size_t n_temp_,
+                    range rg_ye_, std::size_t n_ye_,
+                    shared_array<node> nodes_, bool has_sentr_,
+                    real_t min_h_, units units_);
+
+  ~eos_thermal_table() final = default;
+
+  ///Compute \f$ \ln(T) \f$ from specific energy
+  real_t therm_from_rho_eps_ye(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute \f$ \ln(T) \f$ from temperature
+  real_t therm_from_rho_temp_ye(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t temp,    ///<Temperature
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute specific energy
+  real_t eps(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ltemp,   ///<Thermal variable \f$ \ln(T) \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute temperature
+  real_t temp(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ltemp,   ///<Thermal variable \f$ \ln(T) \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute pressure
+  real_t press(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ltemp,   ///<Thermal variable \f$ \ln(T) \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute soundspeed
+  real_t csnd(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ltemp,   ///<Thermal variable \f$ \ln(T) \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute entropy, if available
+  real_t sentr(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ltemp,   ///<Thermal variable \f$ \ln(T) \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Partial derivative of interpolated pressure at fixed eps
+  real_t dpress_drho(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ltemp,   ///<Thermal variable \f$ \ln(T) \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Partial derivative of interpolated pressure at fixed density
+  real_t dpress_deps(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ltemp,   ///<Thermal variable \f$ \ln(T) \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  /// Valid range for density
+  const range& range_rho() const final {return rgrho;}
+
+  /// Valid range for electron fraction
+  const range& range_ye() const final {return rgye;}
+
+  /// Valid range for specific energy
+  range range_eps(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  /// Valid range for temperature (independent of density)
+  range range_temp(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final
+  {
+    return rgtemp;
+  }
+
+  ///Limit specific energy and compute pressure, using one stencil.
+  auto press_limited(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const -> eos_thermal::press_limited_t final;
+
+  real_t minimal_h() const final {return min_h;}
+
+  void save(datasink s) const final;
+
+  void save_mapped(mapped_eos_writer& w) const final;
+
+  auto descr_str() const -> std::string final;
+
+
+  static const std::string datastore_id;
+  static const bool file_handler_registered;
+  static const bool mapped_handler_registered;
+};
+
+
+} // namespace implementations
+} // namespace EOS_Toolkit
+
+#endif
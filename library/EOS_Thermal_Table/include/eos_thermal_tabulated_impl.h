@@ -0,0 +1,219 @@
+#ifndef EOS_THERMAL_TABULATED_IMPL_H
+#define EOS_THERMAL_TABULATED_IMPL_H
+
+#include "eos_thermal_impl.h"
+#include "shared_array.h"
+#include <cstddef>
+#include <vector>
+
+namespace EOS_Toolkit {
+
+namespace implementations {
+
+///Thermal EOS tabulated in terms of specific energy.
+/**
+This is used to accelerate EOS that are expensive to evaluate. It uses
+trilinear interpolation on a regular grid in \f$ \ln(\rho) \f$,
+\f$ u = \ln(1 + \epsilon_\mathrm{th} / \epsilon_s) \f$, and \f$ Y_e \f$,
+where \f$ \epsilon_\mathrm{th} = \epsilon - \epsilon_\mathrm{min}(\rho, Y_e) \f$
+is the specific energy above the lower bound of the valid range. The
+lower bound itself is tabulated on the \f$ \ln(\rho), Y_e \f$ grid.
+The grid is logarithmic in \f$ \epsilon_\mathrm{th} \f$ above the scale
+\f$ \epsilon_s \f$, and linear below. The thermal variable is the
+specific energy, such that no root finding is required.
+
+If only one sample is given for the electron fraction, the EOS is
+assumed to be independent of it.
+
+Temperature and entropy are optional. Temperature can only be
+computed, but not used as input.
+**/
+class eos_thermal_tabulated : public eos_thermal_impl {
+  public:
+
+  ///Quantities stored for each grid point.
+  struct node {
+    real_t press;   ///< Pressure \f$ P \f$
+    real_t cs2;     ///< Squared soundspeed \f$ c_s^2 \f$
+    real_t temp;    ///< Temperature (zero if not available)
+    real_t sentr;   ///< Specific entropy (zero if not available)
+  };
+
+  private:
+
+  ///Location within the table for given density and electron fraction
+  struct column {
+    std::size_t off;   ///< Offset of first node of the 4 columns
+    real_t frho;       ///< Fractional index for density
+    real_t fye;        ///< Fractional index for electron fraction
+    real_t eps_min;    ///< Interpolated lower bound for eps
+    real_t deps_min;   ///< Derivative of eps_min w.r.t. frho
+  };
+
+  std::size_t nrho, neps, nye;
+  std::size_t stride_rho, stride_ye;
+  std::size_t step_ye;     ///< Node offset to next Y_e (0 if nye=1)
+  std::size_t step_ye_e;   ///< Same for lower eps bound
+  range rgrho;      ///< Valid range for density \f$ \rho \f$
+  range rgepsth;    ///< Range of thermal specific energy
+  range rgye;       ///< Valid range for electron fraction \f$ Y_e \f$
+  real_t lrho0, dlrho, dlrho_inv;
+  real_t du, du_inv;
+  real_t dye, dye_inv;
+  bool has_temp, has_sentr;
+  real_t min_h;     ///< Lower bound for enthalpy \f$ h \ge h_0 > 0 \f$
+
+  shared_array<real_t> epsmin;
+  shared_array<node> nodes;
+
+  void init_grid();
+  auto locate(real_t rho, real_t ye) const -> column;
+  auto blend(const column& c, std::size_t ie) const -> node;
+  auto blend_drho(const column& c, std::size_t ie) const -> node;
+  void locate_eps(const column& c, real_t eps,
+                  std::size_t& ie, real_t& fe) const;
+  auto interp(real_t rho, real_t eps, real_t ye) const -> node;
+
+  public:
+
+  ///Constructor. Samples are ordered as for make_eos_thermal_table(),
+  ///with thermal specific energy instead of temperature
+  eos_thermal_tabulated(range rg_rho_, std::size_t n_rho_,
+                        range rg_eps_th_, std::size_t n_eps_,
+                        range rg_ye_, std::size_t n_ye_,
+                        const std::vector<real_t>& eps_min_,
+                        const std::vector<real_t>& press_,
+                        const std::vector<real_t>& cs2_,
+                        const std::vector<real_t>& temp_,
+                        const std::vector<real_t>& sentr_,
+                        units units_);
+
+  /**\brief Constructor from prepared arrays
+  
+  This is used for memory-mapped tables. The nodes are ordered as
+  used internally, and the values are not validated.
+  **/
+  eos_thermal_tabulated(range rg_rho_, std::size_t n_rho_,
+                        range rg_eps_th_, std::size_t n_eps_,
+                        range rg_ye_, std::size_t n_ye_,
+                        shared_array<real_t> eps_min_,
+                        shared_array<node> nodes_,
+                        bool has_temp_, bool has_sentr_,
+                        real_t min_h_, units units_);
+
+  ~eos_thermal_tabulated() final = default;
+
+  ///Identity: thermal variable is eps for this EOS
+  real_t therm_from_rho_eps_ye(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final
+  {
+    return eps;
+  }
+
+  ///Temperature as input is not supported.
+  [[ noreturn ]]
+  real_t therm_from_rho_temp_ye(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t temp,    ///<Temperature
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Inverse Identity: eps is thermal variable for this EOS
+  real_t eps(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final
+  {
+    return eps;
+  }
+
+  ///Compute temperature, if available
+  real_t temp(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute pressure
+  real_t press(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute soundspeed
+  real_t csnd(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Compute entropy, if available
+  real_t sentr(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Partial derivative of interpolated pressure at fixed eps
+  real_t dpress_drho(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Partial derivative of interpolated pressure at fixed density
+  real_t dpress_deps(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  /// Valid range for density
+  const range& range_rho() const final {return rgrho;}
+
+  /// Valid range for electron fraction
+  const range& range_ye() const final {return rgye;}
+
+  /// Valid range for specific energy
+  range range_eps(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Temperature as input is not supported.
+  [[ noreturn ]]
+  range range_temp(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const final;
+
+  ///Limit specific energy and compute pressure, using one stencil.
+  auto press_limited(
+    real_t rho,     ///<Rest mass density  \f$ \rho \f$
+    real_t eps,     ///<Specific internal energy \f$ \epsilon \f$
+    real_t ye       ///<Electron fraction \f$ Y_e \f$
+  ) const -> eos_thermal::press_limited_t final;
+
+  real_t minimal_h() const final {return min_h;}
+
+  void save(datasink s) const final;
+
+  void save_mapped(mapped_eos_writer& w) const final;
+
+  auto descr_str() const -> std::string final;
+
+  static const std::string datastore_id;
+  static const bool file_handler_registered;
+  static const bool mapped_handler_registered;
+};
+
+
+} // namespace implementations
+} // namespace EOS_Toolkit
+
+#endif
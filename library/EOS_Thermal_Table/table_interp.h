@@ -0,0 +1,52 @@
+/*! \file table_interp.h
+\brief Internal interpolation helpers shared by the tabulated thermal EOS.
+*/
+
+#ifndef TABLE_INTERP_H
+#define TABLE_INTERP_H
+
+#include "config.h"
+#include <algorithm>
+#include <cstddef>
+
+namespace EOS_Toolkit {
+namespace detail {
+
+/// Cell index and fractional position for regular grid coordinate t
+/** The coordinate is in units of the grid spacing, starting at zero.
+    It is limited to the grid, which has n points. For \f$ n<2 \f$,
+    the index and fraction are zero.
+**/
+inline std::size_t cell_index(real_t t, std::size_t n, real_t& f)
+{
+  if (n < 2) {
+    f = 0;
+    return 0;
+  }
+  const real_t tc = std::min(std::max(t, real_t(0)), real_t(n - 1));
+  const std::size_t i = std::min(std::size_t(tc), n - 2);
+  f = tc - i;
+  return i;
+}
+
+/// Weighted sum of 4 nodes n0[0], n0[sr], n0[sy], n0[sr + sy]
+/** This is the stencil in density and electron fraction. The node
+    type N is an aggregate of the real_t members given by M, in order
+    of declaration. All of them are blended.
+**/
+template<class N, real_t N::*... M>
+N wsum4(const N* n0, std::size_t sr, std::size_t sy,
+        real_t w00, real_t w10, real_t w01, real_t w11)
+{
+  const N& a = n0[0];
+  const N& b = n0[sr];
+  const N& c = n0[sy];
+  const N& d = n0[sr + sy];
+  return {(w00 * (a.*M) + w10 * (b.*M) + w01 * (c.*M)
+           + w11 * (d.*M))...};
+}
+
+}
+}
+
+#endif
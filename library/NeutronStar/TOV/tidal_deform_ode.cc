@@ -111,9 +111,10 @@ auto tidal_ode::drho_y(real_t rho_, real_t ym2) const -> real_t
   
   auto s{ eos.at_rho(rho) };
   assert(s);
-  real_t h{ s.hm1() + 1. }; 
-  real_t p{ s.press() }; 
-  real_t eps{ s.eps() }; 
+  const auto v = s.vars();
+  real_t h{ v.hm1 + 1. }; 
+  real_t p{ v.press }; 
+  real_t eps{ v.eps }; 
   real_t cs2{ std::pow(s.csnd(), 2) }; 
    
   real_t rho_e{ rho * (1.0 + eps) };
@@ -225,10 +225,11 @@ void tov_ode::operator()(const state_t &s , state_t &dsdx,
   auto e{ eos.at_gm1(eos.range_gm1().limit_to(gm1_from_x(x))) };
   assert(e);
   
-  const real_t press{ e.press() };
-  const real_t eps{ e.eps() };
+  const auto v = e.vars();
+  const real_t press{ v.press };
+  const real_t eps{ v.eps };
   const real_t rho{ e.rho() };
-  const real_t hm1{ e.hm1() };
+  const real_t hm1{ v.hm1 };
   const real_t rho_e{ (eps  + 1.0) * rho };
   const real_t rsqr{ s[RSQR] * rsqr_norm };
   assert(s[RSQR] >= 0);
@@ -0,0 +1,165 @@
+#include "bench_config.h"
+#include "bench_utils.h"
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "con2prim_imhd.h"
+#include "con2prim_hydro.h"
+#include "eos_thermal_file.h"
+#include "eos_hybrid.h"
+#include "eos_idealgas.h"
+
+using namespace std;
+using namespace EOS_Toolkit;
+
+
+atmosphere get_atmo(eos_thermal eos, const real_t eps_th=0.,
+                    const real_t rho_atmo= 1e-11,
+                    const real_t ye_atmo= 0.25)
+{
+  const real_t rho_atmo_cut = rho_atmo * 1.01;
+  assert(eos.is_rho_valid(rho_atmo));
+  assert(eos.is_rho_valid(rho_atmo_cut));
+  assert(eos.is_ye_valid(ye_atmo));
+
+  const real_t eps0      = eos.range_eps(rho_atmo, ye_atmo).min();
+  const real_t eps_atmo  = eps_th + eps0;
+
+  const real_t p_atmo       = eos.at_rho_eps_ye(rho_atmo,
+                                         eps_atmo, ye_atmo). press();
+
+  return atmosphere(rho_atmo, eps_atmo, ye_atmo, p_atmo, rho_atmo_cut);
+}
+
+/**
+Sample evolved variables without magnetic field for a grid in 
+Lorentz factor and thermal energy.
+**/
+auto sample_cons(const eos_thermal& eos, const sm_metric3& g,
+                 real_t rho, real_t ye)
+-> vector<cons_vars>
+{
+  vector<cons_vars> cells;
+  const real_t eps0 = eos.range_eps(rho, ye).min();
+
+  for (const real_t z : log_spacing(1e-2, 1e3, 200)) {
+    const real_t w = sqrt(1.0 + z*z);
+    const sm_vec3u vel{z / w, 0., 0.};
+    for (const real_t epsth : log_spacing(1e-4, 1e1, 100)) {
+      const real_t eps = eps0 + epsth;
+      const real_t press = eos.at_rho_eps_ye(rho, eps, ye).press();
+      prim_vars pv(rho, eps, ye, press, vel, w);
+      cons_vars cv;
+      cv.from_prim(pv, g);
+      cells.push_back(cv);
+    }
+  }
+  return cells;
+}
+
+/// Average time per cell in nanoseconds, using MHD C2P with B=0
+real_t time_c2p(const con2prim_mhd& cv2pv, const vector<cons_vars>& cells,
+                const sm_metric3& g, int repeat)
+{
+  const sm_vec3u zero{0., 0., 0.};
+  size_t nfail{ 0 };
+  auto t0 = chrono::steady_clock::now();
+  for (int k = 0; k < repeat; ++k) {
+    for (const cons_vars& c : cells) {
+      cons_vars_mhd cv{ c.dens, c.tau, c.tracer_ye, c.scon, zero };
+      prim_vars_mhd pv;
+      con2prim_mhd::report rep;
+      cv2pv(pv, cv, g, rep);
+      if (rep.failed()) ++nfail;
+    }
+  }
+  auto t1 = chrono::steady_clock::now();
+  assert(nfail == 0);
+
+  const real_t dt = chrono::duration<real_t, nano>(t1 - t0).count();
+  return dt / (repeat * cells.size());
+}
+
+/// Average time per cell in nanoseconds, using hydro C2P
+real_t time_c2p(const con2prim_hydro& cv2pv, 
+                const vector<cons_vars>& cells,
+                const sm_metric3& g, int repeat)
+{
+  size_t nfail{ 0 };
+  auto t0 = chrono::steady_clock::now();
+  for (int k = 0; k < repeat; ++k) {
+    for (const cons_vars& c : cells) {
+      cons_vars cv{ c };
+      prim_vars pv;
+      con2prim_hydro::report rep;
+      cv2pv(pv, cv, g, rep);
+      if (rep.failed()) ++nfail;
+    }
+  }
+  auto t1 = chrono::steady_clock::now();
+  assert(nfail == 0);
+
+  const real_t dt = chrono::duration<real_t, nano>(t1 - t0).count();
+  return dt / (repeat * cells.size());
+}
+
+void compare(const string& name, const eos_thermal& eos,
+             const con2prim_mhd& cv2pv_mhd, 
+             const con2prim_hydro& cv2pv_hyd,
+             const sm_metric3& g)
+{
+  const int repeat{ 5 };
+  const auto cells = sample_cons(eos, g, 1e-5, 0.25);
+
+  //warm up
+  time_c2p(cv2pv_mhd, cells, g, 1);
+
+  const real_t t_mhd = time_c2p(cv2pv_mhd, cells, g, repeat);
+  const real_t t_hyd = time_c2p(cv2pv_hyd, cells, g, repeat);
+
+  cout << setw(12) << name
+       << setw(16) << t_mhd
+       << setw(16) << t_hyd
+       << setw(12) << t_mhd / t_hyd << endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  const real_t acc          = 1e-8;
+
+  eos_thermal eos_ig = make_eos_idealgas(1.0, 100., 1e6);
+  atmosphere atmo_ig = get_atmo(eos_ig, 1e-6);
+  con2prim_mhd cv2pv_ig(eos_ig, atmo_ig.rho, false, 2e3, 5e4,
+                        atmo_ig, acc, 100);
+  con2prim_hydro cv2pv_ig_hyd(eos_ig, atmo_ig.rho, false, 2e3,
+                              atmo_ig, acc, 100);
+
+  auto eos_hyb = load_eos_thermal(PATH_EOS_HYB, units::geom_solar());
+  atmosphere atmo_hyb = get_atmo(eos_hyb, 0.0);
+  con2prim_mhd cv2pv_hyb(eos_hyb, atmo_hyb.rho, false, 2e3, 5e4,
+                         atmo_hyb, acc, 100);
+  con2prim_hydro cv2pv_hyb_hyd(eos_hyb, atmo_hyb.rho, false, 2e3,
+                               atmo_hyb, acc, 100);
+
+  sm_metric3 g;
+  g.minkowski();
+
+  cout << "# Time per cell [ns] for MHD C2P with B=0 and hydro C2P"
+       << endl;
+  cout << setw(12) << "# EOS"
+       << setw(16) << "MHD"
+       << setw(16) << "hydro"
+       << setw(12) << "speedup" << endl;
+
+  compare("idealgas", eos_ig, cv2pv_ig, cv2pv_ig_hyd, g);
+  compare("hybrid", eos_hyb, cv2pv_hyb, cv2pv_hyb_hyd, g);
+
+  return 0;
+}
+
@@ -0,0 +1,181 @@
+#include "bench_config.h"
+#include "bench_utils.h"
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "con2prim_imhd.h"
+#include "eos_thermal_file.h"
+#include "eos_hybrid.h"
+#include "eos_idealgas.h"
+
+using namespace std;
+using namespace EOS_Toolkit;
+
+
+atmosphere get_atmo(eos_thermal eos, const real_t eps_th=0.,
+                    const real_t rho_atmo= 1e-11,
+                    const real_t ye_atmo= 0.25)
+{
+  const real_t rho_atmo_cut = rho_atmo * 1.01;
+  assert(eos.is_rho_valid(rho_atmo));
+  assert(eos.is_rho_valid(rho_atmo_cut));
+  assert(eos.is_ye_valid(ye_atmo));
+
+  const real_t eps0      = eos.range_eps(rho_atmo, ye_atmo).min();
+  const real_t eps_atmo  = eps_th + eps0;
+
+  const real_t p_atmo       = eos.at_rho_eps_ye(rho_atmo,
+                                         eps_atmo, ye_atmo). press();
+
+  return atmosphere(rho_atmo, eps_atmo, ye_atmo, p_atmo, rho_atmo_cut);
+}
+
+auto make_cons(const eos_thermal& eos, const sm_metric3& g, 
+               real_t rho, real_t eps, real_t ye, real_t z, real_t b)
+-> cons_vars_mhd
+{
+  const real_t w = sqrt(1.0 + z*z);
+  const sm_vec3u vel{z / w, 0., 0.};
+  const real_t press = eos.at_rho_eps_ye(rho, eps, ye).press();
+  const sm_vec3u B{0., b * sqrt(rho * w), 0.};
+  const sm_vec3u E{ g.raise(g.cross_product(B, vel)) };
+  prim_vars_mhd pv(rho, eps, ye, press, vel, w, E, B);
+  cons_vars_mhd cv;
+  cv.from_prim(pv, g);
+  return cv;
+}
+
+/// Same parameter space as map_z_eps in benchmark_con2prim_mhd.cc
+auto sample_z_eps(const eos_thermal& eos, const sm_metric3& g, 
+                  real_t b, real_t rho, real_t ye)
+-> vector<cons_vars_mhd>
+{
+  vector<cons_vars_mhd> cells;
+  const real_t eps0 = eos.range_eps(rho, ye).min();
+  for (const real_t z : log_spacing(1e-2, 1e3, 200)) {
+    for (const real_t epsth : log_spacing(1e-4, 1e1, 200)) {
+      cells.push_back(make_cons(eos, g, rho, eps0 + epsth, ye, z, b));
+    }
+  }
+  return cells;
+}
+
+/// Same parameter space as map_z_b in benchmark_con2prim_mhd.cc
+auto sample_z_b(const eos_thermal& eos, const sm_metric3& g, 
+                real_t epsth, real_t rho, real_t ye)
+-> vector<cons_vars_mhd>
+{
+  vector<cons_vars_mhd> cells;
+  const real_t eps = eos.range_eps(rho, ye).min() + epsth;
+  for (const real_t z : log_spacing(1e-2, 1e3, 200)) {
+    for (const real_t b : log_spacing(1e-4, 1e4, 200)) {
+      cells.push_back(make_cons(eos, g, rho, eps, ye, z, b));
+    }
+  }
+  return cells;
+}
+
+/// Average time per cell in nanoseconds and EOS calls per cell
+void time_c2p(const con2prim_mhd& cv2pv, 
+              const vector<cons_vars_mhd>& cells,
+              const sm_metric3& g, int repeat, 
+              real_t& dt_cell, real_t& calls_cell)
+{
+  size_t nfail{ 0 }, calls{ 0 };
+  auto t0 = chrono::steady_clock::now();
+  for (int k = 0; k < repeat; ++k) {
+    for (const cons_vars_mhd& c : cells) {
+      cons_vars_mhd cv{ c };
+      prim_vars_mhd pv;
+      con2prim_mhd::report rep;
+      cv2pv(pv, cv, g, rep);
+      if (rep.failed()) ++nfail;
+      calls += rep.iters;
+    }
+  }
+  auto t1 = chrono::steady_clock::now();
+  assert(nfail == 0);
+
+  const real_t n = repeat * cells.size();
+  dt_cell    = chrono::duration<real_t, nano>(t1 - t0).count() / n;
+  calls_cell = calls / n;
+}
+
+void compare(const string& name, const con2prim_mhd& cv2pv_toms, 
+             const con2prim_mhd& cv2pv_newt, 
+             const vector<cons_vars_mhd>& cells, const sm_metric3& g)
+{
+  const int repeat{ 3 };
+  real_t t_toms, t_newt, n_toms, n_newt;
+  
+  //warm up
+  time_c2p(cv2pv_toms, cells, g, 1, t_toms, n_toms);
+  
+  time_c2p(cv2pv_toms, cells, g, repeat, t_toms, n_toms);
+  time_c2p(cv2pv_newt, cells, g, repeat, t_newt, n_newt);
+
+  cout << setw(24) << name
+       << setw(12) << n_toms
+       << setw(12) << n_newt
+       << setw(12) << t_toms
+       << setw(12) << t_newt
+       << setw(12) << t_toms / t_newt << endl;
+}
+
+void compare_maps(const string& name, const eos_thermal& eos, 
+                  const atmosphere& atmo, const sm_metric3& g)
+{
+  const real_t acc        = 1e-8;
+  const real_t ye_fixed   = 0.25;
+  const real_t rho_fixed  = 1e-5;  
+  const real_t blarge     = 10.;
+  const real_t epsth_hot  = 10.;
+  const real_t epsth_cold = 1e-4;
+
+  con2prim_mhd cv2pv_toms(eos, atmo.rho, false, 2e3, 5e4, atmo, acc, 
+                          100, con2prim_mhd::root_solver::TOMS748);
+  con2prim_mhd cv2pv_newt(eos, atmo.rho, false, 2e3, 5e4, atmo, acc, 
+                          100, con2prim_mhd::root_solver::NEWTON);
+
+  compare(name + "_z_eps_Bzero", cv2pv_toms, cv2pv_newt, 
+          sample_z_eps(eos, g, 0, rho_fixed, ye_fixed), g);
+  compare(name + "_z_eps_Blarge", cv2pv_toms, cv2pv_newt, 
+          sample_z_eps(eos, g, blarge, rho_fixed, ye_fixed), g);
+  compare(name + "_z_b_cold", cv2pv_toms, cv2pv_newt, 
+          sample_z_b(eos, g, epsth_cold, rho_fixed, ye_fixed), g);
+  compare(name + "_z_b_hot", cv2pv_toms, cv2pv_newt, 
+          sample_z_b(eos, g, epsth_hot, rho_fixed, ye_fixed), g);
+}
+
+
+int main(int argc, char *argv[])
+{
+  eos_thermal eos_ig = make_eos_idealgas(1.0, 100., 1e6);
+  atmosphere atmo_ig = get_atmo(eos_ig, 1e-6);
+
+  auto eos_hyb = load_eos_thermal(PATH_EOS_HYB, units::geom_solar());
+  atmosphere atmo_hyb = get_atmo(eos_hyb, 0.0);
+
+  sm_metric3 g;
+  g.minkowski();
+
+  cout << "# EOS calls and time per cell [ns] for TOMS748 and Newton "
+       << "root solvers" << endl;
+  cout << setw(24) << "# map"
+       << setw(12) << "calls_t748"
+       << setw(12) << "calls_newt"
+       << setw(12) << "time_t748"
+       << setw(12) << "time_newt"
+       << setw(12) << "speedup" << endl;
+
+  compare_maps("eosig", eos_ig, atmo_ig, g);
+  compare_maps("eoshyb", eos_hyb, atmo_hyb, g);
+
+  return 0;
+}
+
@@ -0,0 +1,145 @@
+#include "bench_config.h"
+#include "bench_utils.h"
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "con2prim_imhd.h"
+#include "eos_thermal_file.h"
+#include "eos_hybrid.h"
+#include "eos_idealgas.h"
+
+using namespace std;
+using namespace EOS_Toolkit;
+
+
+atmosphere get_atmo(eos_thermal eos, const real_t eps_th=0.,
+                    const real_t rho_atmo= 1e-11,
+                    const real_t ye_atmo= 0.25)
+{
+  const real_t rho_atmo_cut = rho_atmo * 1.01;
+  assert(eos.is_rho_valid(rho_atmo));
+  assert(eos.is_rho_valid(rho_atmo_cut));
+  assert(eos.is_ye_valid(ye_atmo));
+
+  const real_t eps0      = eos.range_eps(rho_atmo, ye_atmo).min();
+  const real_t eps_atmo  = eps_th + eps0;
+
+  const real_t p_atmo       = eos.at_rho_eps_ye(rho_atmo,
+                                         eps_atmo, ye_atmo). press();
+
+  return atmosphere(rho_atmo, eps_atmo, ye_atmo, p_atmo, rho_atmo_cut);
+}
+
+/**
+Sample evolved variables for a grid in Lorentz factor, thermal energy,
+and magnetization.
+**/
+auto sample_cons(const eos_thermal& eos, const sm_metric3& g,
+                 real_t rho, real_t ye)
+-> vector<cons_vars_mhd>
+{
+  vector<cons_vars_mhd> cells;
+  const real_t eps0 = eos.range_eps(rho, ye).min();
+
+  for (const real_t z : log_spacing(1e-2, 1e3, 50)) {
+    const real_t w = sqrt(1.0 + z*z);
+    const sm_vec3u vel{z / w, 0., 0.};
+    for (const real_t epsth : log_spacing(1e-4, 1e1, 50)) {
+      const real_t eps = eps0 + epsth;
+      const real_t press = eos.at_rho_eps_ye(rho, eps, ye).press();
+      for (const real_t b : log_spacing(1e-4, 1e1, 10)) {
+        const sm_vec3u B{0., b * sqrt(rho * w), 0.};
+        const sm_vec3u E{ g.raise(g.cross_product(B, vel)) };
+        prim_vars_mhd pv(rho, eps, ye, press, vel, w, E, B);
+        cons_vars_mhd cv;
+        cv.from_prim(pv, g);
+        cells.push_back(cv);
+      }
+    }
+  }
+  return cells;
+}
+
+/// Average time per cell in nanoseconds
+template<class C>
+real_t time_c2p(const C& cv2pv, const vector<cons_vars_mhd>& cells,
+                const sm_metric3& g, int repeat)
+{
+  size_t nfail{ 0 };
+  auto t0 = chrono::steady_clock::now();
+  for (int k = 0; k < repeat; ++k) {
+    for (const cons_vars_mhd& c : cells) {
+      cons_vars_mhd cv{ c };
+      prim_vars_mhd pv;
+      con2prim_mhd::report rep;
+      cv2pv(pv, cv, g, rep);
+      if (rep.failed()) ++nfail;
+    }
+  }
+  auto t1 = chrono::steady_clock::now();
+  assert(nfail == 0);
+
+  const real_t dt = chrono::duration<real_t, nano>(t1 - t0).count();
+  return dt / (repeat * cells.size());
+}
+
+template<class C>
+void compare(const string& name, const eos_thermal& eos,
+             const con2prim_mhd& cv2pv, const C& cv2pv_spec,
+             const sm_metric3& g)
+{
+  const int repeat{ 5 };
+  const auto cells = sample_cons(eos, g, 1e-5, 0.25);
+
+  //warm up
+  time_c2p(cv2pv, cells, g, 1);
+
+  const real_t t_gen  = time_c2p(cv2pv, cells, g, repeat);
+  const real_t t_spec = time_c2p(cv2pv_spec, cells, g, repeat);
+
+  cout << setw(12) << name
+       << setw(16) << t_gen
+       << setw(16) << t_spec
+       << setw(12) << t_gen / t_spec << endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  const real_t acc          = 1e-8;
+
+  eos_thermal eos_ig = make_eos_idealgas(1.0, 100., 1e6);
+  atmosphere atmo_ig = get_atmo(eos_ig, 1e-6);
+  con2prim_mhd cv2pv_ig(eos_ig, atmo_ig.rho, false, 2e3, 5e4,
+                        atmo_ig, acc, 100);
+  con2prim_mhd_idealgas cv2pv_ig_spec(eos_ig, atmo_ig.rho, false,
+                        2e3, 5e4, atmo_ig, acc, 100);
+
+  auto eos_hyb = load_eos_thermal(PATH_EOS_HYB, units::geom_solar());
+  atmosphere atmo_hyb = get_atmo(eos_hyb, 0.0);
+  con2prim_mhd cv2pv_hyb(eos_hyb, atmo_hyb.rho, false, 2e3, 5e4,
+                         atmo_hyb, acc, 100);
+  con2prim_mhd_hybrid cv2pv_hyb_spec(eos_hyb, atmo_hyb.rho, false,
+                         2e3, 5e4, atmo_hyb, acc, 100);
+
+  sm_metric3 g;
+  g.minkowski();
+
+  cout << "# Time per cell [ns] for generic and EOS-specialized C2P"
+       << endl;
+  cout << setw(12) << "# EOS"
+       << setw(16) << "generic"
+       << setw(16) << "specialized"
+       << setw(12) << "speedup" << endl;
+
+  compare("idealgas", eos_ig, cv2pv_ig, cv2pv_ig_spec, g);
+  compare("hybrid", eos_hyb, cv2pv_hyb, cv2pv_hyb_spec, g);
+
+  return 0;
+}
+
@@ -0,0 +1,377 @@
+#include "bench_config.h"
+#include "bench_utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <vector>
+#include "con2prim_imhd.h"
+#include "c2p_stats.h"
+#include "eos_thermal_file.h"
+#include "eos_hybrid.h"
+#include "eos_idealgas.h"
+#include "eos_thermal_table.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+using namespace EOS_Toolkit;
+
+
+atmosphere get_atmo(eos_thermal eos, const real_t eps_th=0.,
+                    const real_t rho_atmo= 1e-11,
+                    const real_t ye_atmo= 0.25)
+{
+  const real_t rho_atmo_cut = rho_atmo * 1.01;
+  assert(eos.is_rho_valid(rho_atmo));
+  assert(eos.is_rho_valid(rho_atmo_cut));
+  assert(eos.is_ye_valid(ye_atmo));
+
+  const real_t eps0      = eos.range_eps(rho_atmo, ye_atmo).min();
+  const real_t eps_atmo  = eps_th + eps0;
+
+  const real_t p_atmo       = eos.at_rho_eps_ye(rho_atmo,
+                                         eps_atmo, ye_atmo). press();
+
+  return atmosphere(rho_atmo, eps_atmo, ye_atmo, p_atmo, rho_atmo_cut);
+}
+
+
+cons_vars_mhd make_cons(const eos_thermal& eos, const sm_metric3& g,
+                        real_t rho, real_t eps, real_t ye, real_t z,
+                        real_t b)
+{
+  const real_t w = sqrt(1.0 + z*z);
+  const sm_vec3u vel{z / w, 0., 0.};
+  const real_t press = eos.at_rho_eps_ye(rho, eps, ye).press();
+  const sm_vec3u B{0., b * sqrt(rho * w), 0.};
+  const sm_vec3u E{ g.raise(g.cross_product(B, vel)) };
+  prim_vars_mhd pv(rho, eps, ye, press, vel, w, E, B);
+  cons_vars_mhd cv;
+  cv.from_prim(pv, g);
+  return cv;
+}
+
+/**
+Tabulated EOS sampled from a polytrope with thermal part linear in 
+temperature, with a resolution typical for nuclear physics tables.
+**/
+eos_thermal make_bench_table()
+{
+  const real_t kappa{ 100. }, gm1_th{ 0.8 }, cv{ 0.1 };
+  const eos_thermal::range rg_rho{1e-12, 1e-2}, rg_temp{1e-3, 2e2};
+  const size_t n_rho{ 300 }, n_temp{ 150 }, n_ye{ 50 };
+  const real_t fr{ log(rg_rho.max() / rg_rho.min()) / (n_rho - 1) };
+  const real_t ft{ log(rg_temp.max() / rg_temp.min()) / (n_temp - 1) };
+
+  const size_t sz{ n_rho * n_temp * n_ye };
+  vector<real_t> vp(sz), veps(sz), vcs2(sz);
+  for (size_t iy = 0; iy < n_ye; ++iy) {
+    for (size_t it = 0; it < n_temp; ++it) {
+      for (size_t ir = 0; ir < n_rho; ++ir) {
+        const size_t j{ (iy * n_temp + it) * n_rho + ir };
+        const real_t rho{ rg_rho.min() * exp(ir * fr) };
+        const real_t eth{ cv * rg_temp.min() * exp(it * ft) };
+        vp[j]   = kappa * rho * rho + gm1_th * rho * eth;
+        veps[j] = kappa * rho + eth;
+        const real_t h{ 1 + veps[j] + vp[j] / rho };
+        vcs2[j] = ((2 - gm1_th) * kappa * rho + gm1_th * eth 
+                   + gm1_th * vp[j] / rho) / h;
+      }
+    }
+  }
+  return make_eos_thermal_table(rg_rho, n_rho, rg_temp, n_temp, 
+                                {0.01, 0.6}, n_ye, vp, veps, vcs2, {});
+}
+
+/// Samples in the (z, eps) plane, as in benchmark_c2p
+auto sample_z_eps(const eos_thermal& eos, const sm_metric3& g,
+                  real_t b, real_t rho, real_t ye)
+-> vector<cons_vars_mhd>
+{
+  vector<cons_vars_mhd> cells;
+  const real_t eps0 = eos.range_eps(rho, ye).min();
+  for (const real_t z : log_spacing(1e-2, 1e3, 40)) {
+    for (const real_t epsth : log_spacing(1e-4, 1e1, 40)) {
+      cells.push_back(make_cons(eos, g, rho, eps0 + epsth, ye, z, b));
+    }
+  }
+  return cells;
+}
+
+/// Samples in the (z, b) plane, as in benchmark_c2p
+auto sample_z_b(const eos_thermal& eos, const sm_metric3& g,
+                real_t epsth, real_t rho, real_t ye)
+-> vector<cons_vars_mhd>
+{
+  vector<cons_vars_mhd> cells;
+  const real_t eps = eos.range_eps(rho, ye).min() + epsth;
+  for (const real_t z : log_spacing(1e-2, 1e3, 40)) {
+    for (const real_t b : log_spacing(1e-4, 1e4, 40)) {
+      cells.push_back(make_cons(eos, g, rho, eps, ye, z, b));
+    }
+  }
+  return cells;
+}
+
+
+/// Owning storage for the arrays used by the batched recovery
+class cell_arrays {
+  vector<vector<real_t>> p, c, c0, m;
+  vector<uint8_t> st;
+
+  public:
+
+  const size_t size;
+
+  cell_arrays(const vector<cons_vars_mhd>& cells, const sm_metric3& g,
+              size_t copies)
+  : p(14, vector<real_t>(cells.size() * copies)),
+    c(9, vector<real_t>(cells.size() * copies)),
+    m(6, vector<real_t>(cells.size() * copies)),
+    st(cells.size() * copies), size{cells.size() * copies}
+  {
+    for (size_t i = 0; i < size; ++i) {
+      const cons_vars_mhd& cv{ cells[i % cells.size()] };
+      c[0][i] = cv.dens;
+      c[1][i] = cv.tau;
+      c[2][i] = cv.tracer_ye;
+      for (int d = 0; d < 3; ++d) {
+        c[3+d][i] = cv.scon(d);
+        c[6+d][i] = cv.bcons(d);
+      }
+      m[0][i] = g.lo(0,0);
+      m[1][i] = g.lo(0,1);
+      m[2][i] = g.lo(0,2);
+      m[3][i] = g.lo(1,1);
+      m[4][i] = g.lo(1,2);
+      m[5][i] = g.lo(2,2);
+    }
+    c0 = c;
+  }
+
+  /// Undo corrections written back by previous recovery
+  void reset() { c = c0; }
+
+  prim_vars_mhd_arrays prims()
+  {
+    return {p[0].data(), p[1].data(), p[2].data(), p[3].data(),
+            {p[4].data(), p[5].data(), p[6].data()}, p[7].data(),
+            {p[8].data(), p[9].data(), p[10].data()},
+            {p[11].data(), p[12].data(), p[13].data()}};
+  }
+
+  cons_vars_mhd_arrays cons()
+  {
+    return {c[0].data(), c[1].data(), c[2].data(),
+            {c[3].data(), c[4].data(), c[5].data()},
+            {c[6].data(), c[7].data(), c[8].data()}};
+  }
+
+  sm_metric3_arrays metric() const
+  {
+    return {m[0].data(), m[1].data(), m[2].data(),
+            m[3].data(), m[4].data(), m[5].data()};
+  }
+
+  uint8_t* status() {return st.data();}
+};
+
+
+/// Minimum over repetitions of average time per cell in nanoseconds
+real_t time_pointwise(const con2prim_mhd& cv2pv,
+                      const vector<cons_vars_mhd>& cells,
+                      const sm_metric3& g, int repeat,
+                      c2p_mhd_stats& stats)
+{
+  real_t best{ numeric_limits<real_t>::max() };
+  for (int k = 0; k < repeat; ++k) {
+    stats.clear();
+    auto t0 = chrono::steady_clock::now();
+    for (const cons_vars_mhd& c : cells) {
+      cons_vars_mhd cv{ c };
+      prim_vars_mhd pv;
+      con2prim_mhd::report rep;
+      cv2pv(pv, cv, g, rep);
+      stats.add(rep);
+    }
+    auto t1 = chrono::steady_clock::now();
+    const real_t dt = chrono::duration<real_t, nano>(t1 - t0).count();
+    best = min(best, dt / cells.size());
+  }
+  return best;
+}
+
+/// Minimum over repetitions of average time per cell in nanoseconds
+real_t time_batch(const con2prim_mhd& cv2pv, cell_arrays& a,
+                  int repeat)
+{
+  real_t best{ numeric_limits<real_t>::max() };
+  for (int k = 0; k < repeat; ++k) {
+    a.reset();
+    auto t0 = chrono::steady_clock::now();
+    cv2pv(a.size, a.prims(), a.cons(), a.metric(), a.status());
+    auto t1 = chrono::steady_clock::now();
+    const real_t dt = chrono::duration<real_t, nano>(t1 - t0).count();
+    best = min(best, dt / a.size);
+  }
+  return best;
+}
+
+int max_threads()
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+void set_threads(int n)
+{
+#ifdef _OPENMP
+  omp_set_num_threads(n);
+#else
+  assert(n == 1);
+#endif
+}
+
+/// Thread counts 1, 2, 4, ... up to and including nmax
+vector<int> thread_counts(int nmax)
+{
+  vector<int> n;
+  for (int k = 1; k < nmax; k *= 2) n.push_back(k);
+  n.push_back(nmax);
+  return n;
+}
+
+
+void bench_regime(ostream& js, bool first, const string& eos_name,
+                  const string& regime, const con2prim_mhd& cv2pv,
+                  const vector<cons_vars_mhd>& cells,
+                  const sm_metric3& g, int nthreads_max)
+{
+  const int repeat{ 5 };
+  const size_t copies{ 32 };
+
+  c2p_mhd_stats stats;
+  const real_t t_pt = time_pointwise(cv2pv, cells, g, repeat, stats);
+  assert(stats.num_failed() == 0);
+
+  cell_arrays arr(cells, g, copies);
+  vector<int> nthr{ thread_counts(nthreads_max) };
+  vector<real_t> t_batch;
+  for (int n : nthr) {
+    set_threads(n);
+    t_batch.push_back(time_batch(cv2pv, arr, repeat));
+  }
+  set_threads(nthreads_max);
+
+  cout << setw(10) << eos_name << setw(16) << regime
+       << setw(12) << t_pt << setw(12) << stats.mean_iters();
+  for (real_t t : t_batch) cout << setw(10) << t;
+  cout << endl;
+
+  js << (first ? "" : ",\n")
+     << "    {\"eos\": \"" << eos_name << "\", "
+     << "\"regime\": \"" << regime << "\",\n"
+     << "     \"cells\": " << cells.size() << ", "
+     << "\"ns_per_cell_pointwise\": " << t_pt << ", "
+     << "\"mean_iters\": " << stats.mean_iters() << ",\n"
+     << "     \"batch_cells\": " << arr.size << ",\n"
+     << "     \"scaling\": [";
+  for (size_t k = 0; k < nthr.size(); ++k) {
+    js << (k == 0 ? "" : ", ")
+       << "{\"threads\": " << nthr[k]
+       << ", \"ns_per_cell\": " << t_batch[k]
+       << ", \"speedup\": " << t_batch[0] / t_batch[k] << "}";
+  }
+  js << "]}";
+}
+
+
+int main(int argc, char *argv[])
+{
+  assert(argc==2);
+  const string path{string(argv[1])+"/"};
+
+  const real_t acc          = 1e-8;
+  const real_t ye_fixed     = 0.25;
+  const real_t rho_fixed    = 1e-5;
+  const real_t blarge       = 10.;
+  const real_t epsth_hot    = 10.;
+  const real_t epsth_cold   = 1e-4;
+  const int nthreads_max    = max_threads();
+
+  eos_thermal eos_ig = make_eos_idealgas(1.0, 100., 1e6);
+  atmosphere atmo_ig = get_atmo(eos_ig, 1e-6);
+  con2prim_mhd cv2pv_ig(eos_ig, atmo_ig.rho, false, 2e3, 5e4,
+                        atmo_ig, acc, 100);
+
+  auto eos_hyb = load_eos_thermal(PATH_EOS_HYB, units::geom_solar());
+  atmosphere atmo_hyb = get_atmo(eos_hyb, 0.0);
+  con2prim_mhd cv2pv_hyb(eos_hyb, atmo_hyb.rho, false, 2e3, 5e4,
+                         atmo_hyb, acc, 100);
+
+  eos_thermal eos_tab = make_bench_table();
+  atmosphere atmo_tab = get_atmo(eos_tab, 0.0);
+  con2prim_mhd cv2pv_tab(eos_tab, atmo_tab.rho, false, 2e3, 5e4,
+                         atmo_tab, acc, 100);
+
+  sm_metric3 g;
+  g.minkowski();
+
+  struct eos_case {
+    string name;
+    const eos_thermal& eos;
+    const con2prim_mhd& cv2pv;
+  };
+  const vector<eos_case> cases{ {"idealgas", eos_ig, cv2pv_ig},
+                                {"hybrid", eos_hyb, cv2pv_hyb},
+                                {"table", eos_tab, cv2pv_tab} };
+
+  ofstream js((path + "perf_timing.json").c_str());
+  js << setprecision(6);
+  js << "{\n  \"benchmark\": \"con2prim_mhd_timing\",\n"
+     << "  \"acc\": " << acc << ",\n"
+     << "  \"max_threads\": " << nthreads_max << ",\n"
+     << "  \"results\": [\n";
+
+  cout << "# Time per cell [ns], pointwise and batched for "
+       << "threads =";
+  for (int n : thread_counts(nthreads_max)) cout << " " << n;
+  cout << endl;
+  cout << setw(10) << "# EOS" << setw(16) << "regime"
+       << setw(12) << "pointwise" << setw(12) << "iters"
+       << setw(10) << "batched" << endl;
+
+  bool first{ true };
+  for (const eos_case& e : cases) {
+    bench_regime(js, first, e.name, "z_eps_Bzero", e.cv2pv,
+      sample_z_eps(e.eos, g, 0., rho_fixed, ye_fixed), g,
+      nthreads_max);
+    first = false;
+    bench_regime(js, first, e.name, "z_eps_Blarge", e.cv2pv,
+      sample_z_eps(e.eos, g, blarge, rho_fixed, ye_fixed), g,
+      nthreads_max);
+    bench_regime(js, first, e.name, "z_b_cold", e.cv2pv,
+      sample_z_b(e.eos, g, epsth_cold, rho_fixed, ye_fixed), g,
+      nthreads_max);
+    bench_regime(js, first, e.name, "z_b_hot", e.cv2pv,
+      sample_z_b(e.eos, g, epsth_hot, rho_fixed, ye_fixed), g,
+      nthreads_max);
+  }
+
+  js << "\n  ]\n}\n";
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "fast_logexp.h"
+#include "interpol_logspl.h"
+
+using namespace std;
+using namespace EOS_Toolkit;
+
+/**
+Compares the standard library log and exp to the approximations
+fast_log() and fast_exp() used by the fast_logexp build option, and
+measures the time per lookup of logarithmic splines, which use
+whichever the library was built with.
+**/
+
+template<class F>
+real_t time_per_call(const vector<real_t>& x, vector<real_t>& y, F f,
+                     int repeat=20)
+{
+  auto t0 = chrono::steady_clock::now();
+  for (int r = 0; r < repeat; ++r) {
+    for (size_t i = 0; i < x.size(); ++i) y[i] = f(x[i]);
+  }
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<real_t, nano>(t1 - t0).count()
+         / (repeat * x.size());
+}
+
+real_t max_rel_err(const vector<real_t>& a, const vector<real_t>& b)
+{
+  real_t e{ 0 };
+  for (size_t i = 0; i < a.size(); ++i) {
+    e = max(e, fabs(a[i] - b[i]) / fabs(a[i]));
+  }
+  return e;
+}
+
+void report(const string& name, real_t t, real_t err)
+{
+  cout << setw(20) << name << setw(12) << setprecision(3) << t
+       << setw(14) << setprecision(3) << err << endl;
+}
+
+int main()
+{
+  const size_t n{ 1 << 16 };
+  mt19937_64 rng{ 42 };
+  uniform_real_distribution<real_t> dist(-30.0, 30.0);
+
+  vector<real_t> z(n), x(n), y0(n), y1(n);
+  for (size_t i = 0; i < n; ++i) {
+    z[i] = dist(rng);
+    x[i] = exp(z[i]);
+  }
+
+  cout << "# Time per call [ns] and max. relative deviation from "
+          "standard library" << endl;
+
+  real_t t_std = time_per_call(x, y0, [] (real_t v) {return log(v);});
+  real_t t_fast = time_per_call(x, y1,
+                    [] (real_t v) {return detail::fast_log(v);});
+  report("std::log", t_std, 0.);
+  report("fast_log", t_fast, max_rel_err(y0, y1));
+
+  t_std  = time_per_call(z, y0, [] (real_t v) {return exp(v);});
+  t_fast = time_per_call(z, y1,
+             [] (real_t v) {return detail::fast_exp(v);});
+  report("std::exp", t_std, 0.);
+  report("fast_exp", t_fast, max_rel_err(y0, y1));
+
+  const interval<real_t> rgx{ exp(-30.0), exp(30.0) };
+  auto f = [] (real_t v) {return v * (1.0 + sqrt(v));};
+  auto lgspl = detail::interpol_logspl_impl::from_function(f, rgx,
+                                                           2000);
+  auto llgspl = detail::interpol_llogspl_impl::from_function(f, rgx,
+                                                             2000);
+  for (size_t i = 0; i < n; ++i) y0[i] = f(x[i]);
+
+  t_std = time_per_call(x, y1,
+            [&lgspl] (real_t v) {return lgspl(v);});
+  report("logspl", t_std, max_rel_err(y0, y1));
+  t_std = time_per_call(x, y1,
+            [&llgspl] (real_t v) {return llgspl(v);});
+  report("llogspl", t_std, max_rel_err(y0, y1));
+
+#ifdef REPRIMAND_FAST_LOGEXP
+  cout << "# Splines use fast_log/fast_exp" << endl;
+#else
+  cout << "# Splines use standard library log/exp" << endl;
+#endif
+
+  return 0;
+}
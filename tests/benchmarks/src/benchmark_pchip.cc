@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "interpol_pchip_spline.h"
+
+using namespace std;
+using namespace EOS_Toolkit;
+
+/**
+Measures the time per lookup of the monotonic spline used for
+tabulated EOS data, both for random arguments and for a monotonic
+sweep with search hint.
+
+GSL is no longer a dependency, so the previous implementation is
+represented by gsl_steffen_ref below, which reproduces what
+gsl_interp_eval does for Steffen splines with an accelerator: a
+range check, a dispatch through the function pointer of the
+interpolation type, the accelerator cache check followed by
+gsl_interp_bsearch on a miss, and evaluation from separate
+coefficient arrays. The overhead of calling into the shared GSL
+library is not included, so this slightly favors the reference.
+**/
+
+class gsl_steffen_ref {
+  vector<real_t> xa, ya, a, b, c, d;
+  real_t xmin, xmax;
+  mutable size_t cache{ 0 };   ///< Shared accelerator state
+
+  using eval_t = int (*)(const gsl_steffen_ref&, real_t, real_t*);
+  eval_t eval_fn;
+
+  static size_t bsearch(const real_t* x, real_t t, size_t lo,
+                        size_t hi)
+  {
+    while (hi > lo + 1) {
+      const size_t i{ (hi + lo) / 2 };
+      if (x[i] > t) hi = i;
+      else lo = i;
+    }
+    return lo;
+  }
+
+  size_t accel_find(real_t t) const
+  {
+    if (t < xa[cache]) {
+      cache = bsearch(xa.data(), t, 0, cache);
+    }
+    else if (t >= xa[cache + 1]) {
+      cache = bsearch(xa.data(), t, cache, xa.size() - 1);
+    }
+    return cache;
+  }
+
+  static int steffen_eval(const gsl_steffen_ref& s, real_t t,
+                          real_t* y)
+  {
+    const size_t i{ s.accel_find(t) };
+    const real_t delx{ t - s.xa[i] };
+    *y = s.d[i] + delx * (s.c[i] + delx * (s.b[i] + delx * s.a[i]));
+    return 0;
+  }
+
+  public:
+
+  gsl_steffen_ref(vector<real_t> x, vector<real_t> y)
+  : xa(move(x)), ya(move(y)), xmin{xa.front()}, xmax{xa.back()},
+    eval_fn{&steffen_eval}
+  {
+    const size_t n{ xa.size() };
+    vector<real_t> yp(n);
+    yp[0] = (ya[1] - ya[0]) / (xa[1] - xa[0]);
+    for (size_t i = 1; i < n - 1; ++i) {
+      const real_t hi{ xa[i+1] - xa[i] };
+      const real_t him1{ xa[i] - xa[i-1] };
+      const real_t si{ (ya[i+1] - ya[i]) / hi };
+      const real_t sim1{ (ya[i] - ya[i-1]) / him1 };
+      const real_t pi{ (sim1 * hi + si * him1) / (him1 + hi) };
+      yp[i] = (copysign(1.0, sim1) + copysign(1.0, si))
+              * min(fabs(sim1), min(fabs(si), 0.5 * fabs(pi)));
+    }
+    yp[n-1] = (ya[n-1] - ya[n-2]) / (xa[n-1] - xa[n-2]);
+
+    a.resize(n - 1); b.resize(n - 1); c.resize(n - 1); d.resize(n - 1);
+    for (size_t i = 0; i < n - 1; ++i) {
+      const real_t hi{ xa[i+1] - xa[i] };
+      const real_t si{ (ya[i+1] - ya[i]) / hi };
+      a[i] = (yp[i] + yp[i+1] - 2 * si) / (hi * hi);
+      b[i] = (3 * si - 2 * yp[i] - yp[i+1]) / hi;
+      c[i] = yp[i];
+      d[i] = ya[i];
+    }
+  }
+
+  real_t operator()(real_t t) const
+  {
+    if ((t < xmin) || (t > xmax)) return NAN;
+    real_t y;
+    eval_fn(*this, t, &y);
+    return y;
+  }
+};
+
+
+template<class F>
+real_t time_per_call(const vector<real_t>& x, vector<real_t>& y, F f,
+                     int repeat=20)
+{
+  auto t0 = chrono::steady_clock::now();
+  for (int r = 0; r < repeat; ++r) {
+    for (size_t i = 0; i < x.size(); ++i) y[i] = f(x[i]);
+  }
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<real_t, nano>(t1 - t0).count()
+         / (repeat * x.size());
+}
+
+real_t max_abs_dev(const vector<real_t>& a, const vector<real_t>& b)
+{
+  real_t e{ 0 };
+  for (size_t i = 0; i < a.size(); ++i) {
+    e = max(e, fabs(a[i] - b[i]));
+  }
+  return e;
+}
+
+void report(const string& name, real_t t_ref, real_t t, real_t dev)
+{
+  cout << setw(20) << name << setw(12) << setprecision(3) << t_ref
+       << setw(12) << setprecision(3) << t
+       << setw(10) << setprecision(3) << (t_ref / t)
+       << setw(12) << setprecision(3) << dev << endl;
+}
+
+int main()
+{
+  const size_t nsamp{ 2000 };
+  const size_t n{ 1 << 16 };
+
+  vector<real_t> sx(nsamp), sy(nsamp);
+  for (size_t i = 0; i < nsamp; ++i) {
+    sx[i] = -30.0 + 60.0 * i / (nsamp - 1);
+    sy[i] = sx[i] + log1p(exp(0.5 * sx[i]));
+  }
+
+  const gsl_steffen_ref ref(sx, sy);
+  const auto spl = detail::interpol_pchip_impl::from_vector(sx, sy);
+
+  mt19937_64 rng{ 42 };
+  uniform_real_distribution<real_t> dist(sx.front(), sx.back());
+  vector<real_t> xr(n), xs(n), y0(n), y1(n);
+  for (size_t i = 0; i < n; ++i) xr[i] = dist(rng);
+  xs = xr;
+  sort(xs.begin(), xs.end());
+
+  cout << "# Time per lookup [ns] for GSL reference and new spline, "
+          "speedup, max. deviation" << endl;
+  cout << "#    " << nsamp << " samples, " << n << " lookups" << endl;
+
+  real_t t_ref = time_per_call(xr, y0,
+                   [&ref] (real_t v) {return ref(v);});
+  real_t t_new = time_per_call(xr, y1,
+                   [&spl] (real_t v) {return spl(v);});
+  report("random", t_ref, t_new, max_abs_dev(y0, y1));
+
+  t_ref = time_per_call(xs, y0, [&ref] (real_t v) {return ref(v);});
+  t_new = time_per_call(xs, y1, [&spl] (real_t v) {return spl(v);});
+  report("sweep", t_ref, t_new, max_abs_dev(y0, y1));
+
+  size_t hint{ 0 };
+  t_new = time_per_call(xs, y1,
+            [&spl, &hint] (real_t v) {return spl(v, hint);});
+  report("sweep with hint", t_ref, t_new, max_abs_dev(y0, y1));
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "eos_barotr_pwpoly.h"
+#include "eos_barotropic.h"
+
+using namespace std;
+using namespace EOS_Toolkit;
+
+/**
+Measures the time per density for evaluating all quantities of a 
+piecewise polytropic EOS, once point by point via eos_barotr::at_rho(),
+and once using the batch evaluation eos_barotr::eval_at_rho().
+**/
+
+template<class F>
+real_t time_per_point(size_t n, F f, int repeat=50)
+{
+  auto t0 = chrono::steady_clock::now();
+  for (int r = 0; r < repeat; ++r) f();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<real_t, nano>(t1 - t0).count() / (repeat * n);
+}
+
+int main()
+{
+  auto eos = make_eos_barotr_pwpoly(0.089, 
+                                    {0.0, 2.4e-4, 8.1e-4, 1.6e-3}, 
+                                    {1.357, 3.0, 2.9, 2.8}, 6e-3);
+  const real_t rho_max{ eos.range_rho().max() };
+  
+  const size_t n{ 1 << 16 };
+  vector<real_t> rho(n), gm1(n), press(n), eps(n), hm1(n), csnd(n);
+  for (size_t i = 0; i < n; ++i) {
+    rho[i] = rho_max * pow(1e-10, real_t(n - 1 - i) / (n - 1));
+  }
+  
+  real_t t_pt = time_per_point(n, [&] () {
+    for (size_t i = 0; i < n; ++i) {
+      auto s = eos.at_rho(rho[i]);
+      gm1[i]   = s.gm1();
+      press[i] = s.press();
+      eps[i]   = s.eps();
+      hm1[i]   = s.hm1();
+      csnd[i]  = s.csnd();
+    }
+  });
+  
+  real_t t_vars = time_per_point(n, [&] () {
+    for (size_t i = 0; i < n; ++i) {
+      auto s = eos.at_rho(rho[i]);
+      auto v = s.vars();
+      press[i] = v.press;
+      eps[i]   = v.eps;
+      hm1[i]   = v.hm1;
+    }
+  });
+  
+  eos_barotr::result_arrays res;
+  res.gm1   = gm1.data();
+  res.press = press.data();
+  res.eps   = eps.data();
+  res.hm1   = hm1.data();
+  res.csnd  = csnd.data();
+  real_t t_batch = time_per_point(n, [&] () {
+    eos.eval_at_rho(n, rho.data(), res);
+  });
+  
+  cout << "# Time per density [ns]" << endl
+       << setw(20) << "pointwise" << setw(12) << setprecision(3) 
+       << t_pt << endl
+       << setw(20) << "pointwise vars" << setw(12) << setprecision(3) 
+       << t_vars << endl
+       << setw(20) << "batch" << setw(12) << setprecision(3) 
+       << t_batch << endl;
+
+  return 0;
+}
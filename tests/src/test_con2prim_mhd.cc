@@ -5,11 +5,17 @@
 #include "test_config.h"
 #include "unitconv.h"
 #include "test_con2prim_mhd.h"
+#include "con2prim_imhd_internals.h"
+#include "find_roots.h"
+#include "c2p_stats.h"
+#include "hdf5store.h"
 
 #include "eos_thermal.h"
 #include "eos_idealgas.h"
 #include "eos_thermal_file.h"
 #include "eos_hybrid.h"
+#include "eos_thermal_table.h"
+#include "eos_thermal_static.h"
 
 using boost::format;
 using boost::str;
@@ -386,6 +392,57 @@ bool test_con2prim_mhd::chk_normal(real_t rho, real_t eps, real_t ye,
  
 
 
+bool test_con2prim_mhd::chk_hint(real_t rho, real_t eps, real_t ye, 
+                real_t z, real_t b, int vdim, int bdim, 
+                int& iter_saved) const
+{
+  failcount hope("C2P with guess for solution");
+
+  prim_vars_mhd pv0;
+  cons_vars_mhd cv0;
+  setup_prim_cons(pv0, cv0, rho, eps, ye, z, b, vdim, bdim);
+
+  prim_vars_mhd pv1;
+  cons_vars_mhd cv1 = cv0;
+  con2prim_mhd::report rep1;
+  cv2pv(pv1, cv1, g, rep1);
+  
+  const real_t mu0{ con2prim_mhd::root_hint(pv0) };
+  
+  for (const real_t f : {1.0, 1.0 + 1e-5, 1.0 - 1e-2, 2.0, 0.5}) {
+    prim_vars_mhd pv2;
+    cons_vars_mhd cv2 = cv0;
+    con2prim_mhd::report rep2;
+    hope.nothrow("C2P with guess", [&] () {cv2pv(pv2, cv2, g, rep2, 
+                                                 f * mu0);});
+    
+    if (!hope(rep1.status == rep2.status, 
+              "C2P with guess reports same status as without")) 
+    {
+      continue;
+    }
+    if (rep1.failed()) continue;
+    
+    hope(compare_prims(pv1, pv2), 
+         "C2P with guess agrees with C2P without");
+    hope(compare_prims(pv0, pv2), 
+         "C2P with guess close to original primitives");
+    if (f == 1.0) {
+      iter_saved += int(rep1.iters) - int(rep2.iters);
+    }
+  }
+  
+  if (!hope) {
+    hope.postmortem(str(format(
+          "rho=%.15e, eps=%.15e, ye=%.15e, "
+          "z(%d)=%.15e, b(%d)=%.15e")
+        % pv0.rho % pv0.eps % pv0.ye % vdim % z % bdim % b));
+  }
+
+  return hope;
+}
+
+
 bool test_con2prim_mhd::chk_eps_adj(real_t rho, real_t deps, real_t ye, 
           real_t z, real_t b, int vdim, int bdim) const
 {
@@ -551,7 +608,239 @@ bool test_con2prim_mhd::chk_fail_eps(cons_vars_mhd cv) const
 }
 
 
+bool test_con2prim_mhd::chk_batch(
+         const std::vector<cons_vars_mhd>& cells, bool with_hint) const
+{
+  failcount hope("Batched C2P agrees with pointwise C2P");
+
+  const std::size_t n{ cells.size() };
+  std::vector<std::vector<real_t>> p(17, std::vector<real_t>(n)); 
+  std::vector<std::vector<real_t>> c(9, std::vector<real_t>(n));
+  std::vector<std::vector<real_t>> m(6, std::vector<real_t>(n));
+  std::vector<std::uint8_t> status(n);
+  
+  EOS_Toolkit::prim_vars_mhd_arrays pa{p[0].data(), p[1].data(), 
+    p[2].data(), p[3].data(), {p[4].data(), p[5].data(), p[6].data()},
+    p[7].data(), {p[8].data(), p[9].data(), p[10].data()}, 
+    {p[11].data(), p[12].data(), p[13].data()}};
+  EOS_Toolkit::cons_vars_mhd_arrays ca{c[0].data(), c[1].data(), 
+    c[2].data(), {c[3].data(), c[4].data(), c[5].data()},
+    {c[6].data(), c[7].data(), c[8].data()}};
+  EOS_Toolkit::sm_metric3_arrays ma{m[0].data(), m[1].data(), 
+    m[2].data(), m[3].data(), m[4].data(), m[5].data()};
+
+  for (std::size_t i=0; i<n; ++i) {
+    const cons_vars_mhd& cv{ cells[i] };
+    c[0][i] = cv.dens;
+    c[1][i] = cv.tau;
+    c[2][i] = cv.tracer_ye;
+    for (int d=0; d<3; ++d) {
+      c[3+d][i] = cv.scon(d);
+      c[6+d][i] = cv.bcons(d);
+    }
+    m[0][i] = g.lo(0,0);
+    m[1][i] = g.lo(0,1);
+    m[2][i] = g.lo(0,2);
+    m[3][i] = g.lo(1,1);
+    m[4][i] = g.lo(1,2);
+    m[5][i] = g.lo(2,2);
+  }
+  
+  //Guesses slightly off from the solution, or missing
+  std::vector<real_t> hint(n, NAN);
+  if (with_hint) {
+    for (std::size_t i=0; i<n; i+=2) {
+      prim_vars_mhd pv0;
+      cons_vars_mhd cv0{ cells[i] };
+      con2prim_mhd::report rep;
+      cv2pv(pv0, cv0, g, rep);
+      hint[i] = con2prim_mhd::root_hint(pv0) * (1. + 1e-4);
+    }
+  }
+  
+  c2p_mhd_stats stats;
+  std::vector<std::uint16_t> iters(n);
+  hope.nothrow("Batched C2P", [&] () {cv2pv(n, pa, ca, ma, 
+                    status.data(), with_hint ? hint.data() : nullptr, 
+                    &stats, iters.data());});
+  if (!hope) return hope;
+  
+  c2p_mhd_stats stats0;
+  for (std::size_t i=0; i<n; ++i) {
+    prim_vars_mhd pv0;
+    cons_vars_mhd cv0{ cells[i] };
+    con2prim_mhd::report rep;
+    cv2pv(pv0, cv0, g, rep);
+    stats0.add(rep);
+    
+    hope(status[i] == rep.compact(), 
+         "Batched C2P reports same outcome as pointwise C2P");
+    if (con2prim_mhd::report::status_of(status[i]) != rep.status) {
+      continue;
+    }
+    hope(iters[i] > 0 || rep.iters == 0, 
+         "Batched C2P reports iteration count");
+    
+    prim_vars_mhd pv1{p[0][i], p[1][i], p[2][i], p[3][i],  
+                      sm_vec3u{p[4][i], p[5][i], p[6][i]}, p[7][i], 
+                      sm_vec3u{p[8][i], p[9][i], p[10][i]}, 
+                      sm_vec3u{p[11][i], p[12][i], p[13][i]}};
+    cons_vars_mhd cv1{ca.gather(i)};
+
+    if (rep.failed()) {
+      hope(check_isnan(pv1), 
+           "Batched C2P failure implies primitives set to NAN");
+      hope(check_same(cells[i], cv1), 
+           "Batched C2P failure leaves evolved variables unchanged");
+      const auto rep1 = cv2pv.diagnose(i, ca, ma, 
+                              with_hint ? hint.data() : nullptr);
+      hope(rep1.status == rep.status, 
+           "Diagnosing failed cell of batched C2P");
+    }
+    else {
+      hope(compare_prims(pv0, pv1), 
+           "Batched C2P primitives agree with pointwise");
+      hope(compare_cons(cv0, cv1, g.norm2(pv0.vel)), 
+           "Batched C2P evolved variables agree with pointwise");
+    }
+  }
+  
+  hope(stats.num_calls() == n, "Batched C2P statistics count all cells");
+  hope(stats.num_atmo() == stats0.num_atmo(), 
+       "Batched C2P statistics count atmosphere as pointwise C2P");
+  for (int k = 0; k <= con2prim_mhd::report::ERR_CODE_NOT_SET; ++k) {
+    const auto s = static_cast<con2prim_mhd::report::err_code>(k);
+    hope(stats.num_status(s) == stats0.num_status(s), 
+         "Batched C2P statistics count outcomes as pointwise C2P");
+  }
+
+  return hope;
+}
+
+
+
+template<class C>
+bool test_con2prim_mhd::chk_spec(const C& cv2pv_spec, 
+         const std::vector<cons_vars_mhd>& cells) const
+{
+  failcount hope("C2P specialized to EOS agrees with generic C2P");
+
+  for (const cons_vars_mhd& cv : cells) {
+    prim_vars_mhd pv0, pv1;
+    cons_vars_mhd cv0{ cv }, cv1{ cv };
+    con2prim_mhd::report rep0, rep1;
+    cv2pv(pv0, cv0, g, rep0);
+    hope.nothrow("Specialized C2P", [&] () {cv2pv_spec(pv1, cv1, g, 
+                                                        rep1);});
+    
+    hope(rep0.status == rep1.status, 
+         "Specialized C2P reports same status as generic C2P");
+    hope(rep0.iters == rep1.iters, 
+         "Specialized C2P needs same iterations as generic C2P");
+    if (rep0.status != rep1.status) continue;
+    
+    if (rep0.failed()) {
+      hope(check_isnan(cv1, pv1), 
+           "Specialized C2P failure implies results set to NAN");
+    }
+    else {
+      hope(compare_prims(pv0, pv1), 
+           "Specialized C2P primitives agree with generic");
+      hope(compare_cons(cv0, cv1, g.norm2(pv0.vel)), 
+           "Specialized C2P evolved variables agree with generic");
+    }
+  }
+
+  return hope;
+}
+
+
+bool test_con2prim_mhd::chk_solver(const con2prim_mhd& cv2pv_alt, 
+         const std::vector<cons_vars_mhd>& cells) const
+{
+  failcount hope("C2P with alternative root solver agrees with default");
+
+  for (const cons_vars_mhd& cv : cells) {
+    prim_vars_mhd pv0, pv1;
+    cons_vars_mhd cv0{ cv }, cv1{ cv };
+    con2prim_mhd::report rep0, rep1;
+    cv2pv(pv0, cv0, g, rep0);
+    hope.nothrow("C2P with alternative root solver", 
+                 [&] () {cv2pv_alt(pv1, cv1, g, rep1);});
+    
+    if (!hope(rep0.status == rep1.status, 
+              "Alternative root solver gives same status")) 
+    {
+      hope.postmortem(rep0.debug_message());
+      hope.postmortem(rep1.debug_message());
+      continue;
+    }
+    
+    if (rep0.failed()) {
+      hope(check_isnan(cv1, pv1), 
+           "Alternative root solver failure implies results set to NAN");
+    }
+    else {
+      hope(compare_prims(pv0, pv1), 
+           "Alternative root solver primitives agree with default");
+      hope(compare_cons(cv0, cv1, g.norm2(pv0.vel)), 
+           "Alternative root solver evolved variables agree with default");
+    }
+  }
+
+  return hope;
+}
+
+
+bool test_con2prim_mhd::chk_hydro(const con2prim_hydro& cv2pv_hyd, 
+         const std::vector<cons_vars_mhd>& cells) const
+{
+  failcount hope("Hydro C2P agrees with MHD C2P for zero B");
+  
+  const sm_vec3u zero{0., 0., 0.};
+
+  for (const cons_vars_mhd& cv : cells) {
+    prim_vars_mhd pv0;
+    cons_vars_mhd cv0{cv.dens, cv.tau, cv.tracer_ye, cv.scon, zero};
+    con2prim_mhd::report rep0, rep1;
+    cv2pv(pv0, cv0, g, rep0);
+    
+    EOS_Toolkit::prim_vars pvh;
+    EOS_Toolkit::cons_vars cvh{cv.dens, cv.tau, cv.tracer_ye, cv.scon};
+    hope.nothrow("Hydro C2P", [&] () {cv2pv_hyd(pvh, cvh, g, rep1);});
+    
+    if (!hope(rep0.status == rep1.status, 
+              "Hydro C2P reports same status as MHD C2P")) 
+    {
+      hope.postmortem(rep0.debug_message());
+      hope.postmortem(rep1.debug_message());
+      continue;
+    }
+    hope(rep0.set_atmo == rep1.set_atmo, 
+         "Hydro C2P sets atmosphere iff MHD C2P does");
+    hope(rep0.adjust_cons == rep1.adjust_cons, 
+         "Hydro C2P adjusts evolved variables iff MHD C2P does");
+    
+    //Magnetic field is NAN after failure, as for MHD 
+    const sm_vec3u em{ rep1.failed() ? pv0.B : zero };
+    const prim_vars_mhd pv1{pvh.rho, pvh.eps, pvh.ye, pvh.press, 
+                            pvh.vel, pvh.w_lor, em, em};
+    const cons_vars_mhd cv1{cvh.dens, cvh.tau, cvh.tracer_ye, 
+                            cvh.scon, em};
+    if (rep0.failed()) {
+      hope(check_isnan(cv1, pv1), 
+           "Hydro C2P failure implies results set to NAN");
+    }
+    else {
+      hope(compare_prims(pv0, pv1), 
+           "Hydro C2P primitives agree with MHD C2P");
+      hope(compare_cons(cv0, cv1, g.norm2(pv0.vel)), 
+           "Hydro C2P evolved variables agree with MHD C2P");
+    }
+  }
 
+  return hope;
+}
 
 
 test_con2prim_mhd make_env(const env_idealgas& e) 
@@ -691,6 +980,495 @@ BOOST_AUTO_TEST_CASE( c2p_mhd_fail )
 }
 
 
+BOOST_AUTO_TEST_CASE( c2p_mhd_batch )
+{
+  failcount hope{"C2P batch tests"};
+  
+  env_idealgas par{1e6, 100., 1e-11, 1e-6, 10.0, 10.0, 4e-8};
+
+  const auto tst = make_env(par);
+
+  const real_t ye_fixed{0.25};
+  const real_t rho{1e-5};
+  std::vector<cons_vars_mhd> cells;
+
+  //Avoid samples exactly at the speed limit z=10
+  for (const real_t z : log_spacing(1.5e-2, 1e3, 20)) {
+    for (const real_t b : linear_spacing(0.0, 5.0, 5)) {
+      prim_vars_mhd pv;
+      cons_vars_mhd cv;
+      tst.setup_prim_cons(pv, cv, rho, 0.5, ye_fixed, z, b, 0, 1);
+      cells.push_back(cv);
+      tst.setup_prim_cons(pv, cv, 0.9 * tst.atmo.rho_cut, 0.5, 
+                          ye_fixed, z, b, 1, 2);
+      cells.push_back(cv);
+      cv.tau *= 1e4;
+      cells.push_back(cv);
+    }
+  }
+  cells.push_back(cons_vars_mhd{2e-3, 1e-4, 1e-3, 
+                                {0.,0.,0.}, {0.,0.,0.}});
+  cells.push_back(cons_vars_mhd{1e-6, 2e-5, 5e-7, 
+                                {0.,0.,0.}, {0.,0.,0.}});
+  
+  hope(tst.chk_batch(cells), 
+       "Batched C2P gives same results as pointwise C2P");
+  hope(tst.chk_batch(cells, true), 
+       "Batched C2P with guesses gives same results as pointwise C2P");
+}
+
+BOOST_AUTO_TEST_CASE( c2p_mhd_stats_merge )
+{
+  failcount hope{"C2P statistics"};
+  
+  env_idealgas par{1e6, 100., 1e-11, 1e-6, 10.0, 10.0, 1e-8};
+  const auto tst = make_env(par);
+  
+  c2p_mhd_stats all(20), part1(20), part2(20);
+  std::size_t n{ 0 };
+  for (const real_t z : log_spacing(1e-2, 1e2, 10)) {
+    for (const real_t rho : {0.5 * tst.atmo.rho_cut, 1e-5, 1e-3}) {
+      prim_vars_mhd pv;
+      cons_vars_mhd cv;
+      tst.setup_prim_cons(pv, cv, rho, 0.5, 0.25, z, 1.0, 0, 1);
+      con2prim_mhd::report rep;
+      tst.cv2pv(pv, cv, tst.g, rep);
+      all.add(rep);
+      ((n++ % 2 == 0) ? part1 : part2).add(rep);
+    }
+  }
+  
+  part1 += part2;
+  hope(part1.num_calls() == n, "Number of calls");
+  hope(part1.num_calls() == all.num_calls(), "Merged number of calls");
+  hope(part1.num_failed() == all.num_failed(), "Merged failures");
+  hope(part1.num_atmo() == all.num_atmo(), "Merged atmosphere count");
+  hope(all.num_atmo() > 0, "Atmosphere count");
+  hope(part1.num_adjust() == all.num_adjust(), "Merged adjust count");
+  hope(part1.total_iters() == all.total_iters(), "Merged iterations");
+  hope(part1.iters_histogram() == all.iters_histogram(), 
+       "Merged histogram");
+  
+  c2p_mhd_stats::count_t nhist{ 0 };
+  for (auto c : all.iters_histogram()) nhist += c;
+  hope(nhist == n, "Histogram counts all calls");
+  
+  hope.dothrow("Merging different histogram sizes", 
+               [&] () {all += c2p_mhd_stats(10);});
+  
+  all.clear();
+  hope(all.num_calls() == 0, "Clearing statistics");
+  
+  char tmpn[L_tmpnam];
+  hope(std::tmpnam(tmpn) != nullptr, "Temporary filename");
+  
+  hope.nothrow("Saving statistics", 
+               [&] () {save_c2p_mhd_stats(tmpn, part1);});
+  if (hope) {
+    auto g = make_hdf5_file_source(tmpn) / "c2p_mhd_stats";
+    const double ncalls = g["num_calls"];
+    const double nsucc = (g / "status")["SUCCESS"];
+    const std::vector<double> hist = g["iters_histogram"];
+    hope(ncalls == n, "Saved number of calls");
+    hope(nsucc == part1.num_status(con2prim_mhd::report::SUCCESS), 
+         "Saved number of successes");
+    hope(hist.size() == part1.iters_histogram().size(), 
+         "Saved histogram");
+    std::remove(tmpn);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( c2p_mhd_batch_hybr )
+{
+  failcount hope{"C2P batch tests with hybrid EOS"};
+  
+  env_hybrideos par{1e-12, 1.0, 2e3, 1e-8};
+
+  const auto tst = make_env(par);
+
+  const real_t ye_fixed{0.25};
+  std::vector<cons_vars_mhd> cells;
+
+  for (const real_t z : log_spacing(1e-2, 1e3, 15)) {
+    for (const real_t b : linear_spacing(0.0, 5.0, 3)) {
+      for (const real_t rho : log_spacing(par.atmo_rho*5, 
+                                tst.eos.range_rho().max()/1.1, 7)) {
+        const auto rgeps = tst.eos.range_eps(rho, ye_fixed);
+        for (const real_t th : linear_spacing(2e-6, 0.99, 3)) {
+          const real_t eps{ rgeps.min()*(1.0-th) + rgeps.max()*th };
+          prim_vars_mhd pv;
+          cons_vars_mhd cv;
+          tst.setup_prim_cons(pv, cv, rho, eps, ye_fixed, z, b, 2, 0);
+          cells.push_back(cv);
+        }
+      }
+    }
+  }
+  
+  hope(tst.chk_batch(cells), 
+       "Batched C2P gives same results as pointwise C2P");
+}
+
+
+BOOST_AUTO_TEST_CASE( c2p_mhd_hint )
+{
+  failcount hope{"C2P using guess for solution works"};
+  
+  env_idealgas par_ig{1e6, 51., 1e-11, 1e-6, 1.0, 2e3, 1e-8};
+  const auto tst_ig = make_env(par_ig);
+  
+  env_hybrideos par_hyb{1e-12, 1.0, 2e3, 1e-8};
+  const auto tst_hyb = make_env(par_hyb);
+  
+  const real_t ye_fixed{0.25};
+  int iter_saved_ig{0}, iter_saved_hyb{0};
+  
+  for (const real_t z : log_spacing(1e-2, 1e3, 20)) {
+    for (const real_t b : linear_spacing(0.0, 5.0, 5)) {
+      for (const real_t eps : log_spacing(1e-4, 50., 5)) {
+        hope(tst_ig.chk_hint(1e-5, eps, ye_fixed, z, b, 0, 1, 
+                             iter_saved_ig), 
+             "C2P with guess works for ideal gas EOS");
+      }
+      for (const real_t rho : log_spacing(par_hyb.atmo_rho*5, 
+                                tst_hyb.eos.range_rho().max()/1.1, 5)) {
+        const auto rgeps = tst_hyb.eos.range_eps(rho, ye_fixed);
+        const real_t eps{ 0.9 * rgeps.min() + 0.1 * rgeps.max() };
+        hope(tst_hyb.chk_hint(rho, eps, ye_fixed, z, b, 2, 0, 
+                              iter_saved_hyb), 
+             "C2P with guess works for hybrid EOS");
+      }
+    }
+  }
+  
+  hope(iter_saved_ig > 0, 
+       "Exact guess saves iterations on average (ideal gas)");
+  hope(iter_saved_hyb > 0, 
+       "Exact guess saves iterations on average (hybrid EOS)");
+}
+
+
+BOOST_AUTO_TEST_CASE( c2p_mhd_specialized )
+{
+  failcount hope{"C2P specialized to EOS type"};
+  
+  env_idealgas par_ig{1e6, 100., 1e-11, 1e-6, 10.0, 10.0, 4e-8};
+  const auto tst_ig = make_env(par_ig);
+  
+  env_hybrideos par_hyb{1e-12, 1.0, 2e3, 1e-8};
+  const auto tst_hyb = make_env(par_hyb);
+
+  const real_t ye_fixed{0.25};
+  const real_t max_b{ 10. };
+  const int max_iter{ 30 };
+  
+  const con2prim_mhd_idealgas cv2pv_ig(tst_ig.eos, 
+    par_ig.c2p_strict * par_ig.atmo_rho, false, par_ig.c2p_zmax, 
+    max_b, tst_ig.atmo, par_ig.c2p_acc, max_iter);
+
+  const con2prim_mhd_hybrid cv2pv_hyb(tst_hyb.eos, 
+    par_hyb.c2p_strict * par_hyb.atmo_rho, false, par_hyb.c2p_zmax, 
+    max_b, tst_hyb.atmo, par_hyb.c2p_acc, max_iter);
+  
+  std::vector<cons_vars_mhd> cells_ig, cells_hyb;
+
+  for (const real_t z : log_spacing(1e-2, 1e3, 20)) {
+    for (const real_t b : linear_spacing(0.0, 5.0, 5)) {
+      prim_vars_mhd pv;
+      cons_vars_mhd cv;
+      for (const real_t eps : log_spacing(1e-4, 50., 5)) {
+        tst_ig.setup_prim_cons(pv, cv, 1e-5, eps, ye_fixed, z, b, 0, 1);
+        cells_ig.push_back(cv);
+      }
+      cv.tau *= 1e4;
+      cells_ig.push_back(cv);
+
+      for (const real_t rho : log_spacing(par_hyb.atmo_rho*5, 
+                                tst_hyb.eos.range_rho().max()/1.1, 5)) {
+        const auto rgeps = tst_hyb.eos.range_eps(rho, ye_fixed);
+        const real_t eps{ 0.9 * rgeps.min() + 0.1 * rgeps.max() };
+        tst_hyb.setup_prim_cons(pv, cv, rho, eps, ye_fixed, z, b, 2, 0);
+        cells_hyb.push_back(cv);
+      }
+    }
+  }
+  
+  hope(tst_ig.chk_spec(cv2pv_ig, cells_ig), 
+       "C2P specialized to ideal gas EOS agrees with generic C2P");
+  hope(tst_hyb.chk_spec(cv2pv_hyb, cells_hyb), 
+       "C2P specialized to hybrid EOS agrees with generic C2P");
+  
+  hope.dothrow("Specialization to wrong EOS type", [&] () {
+    con2prim_mhd_hybrid c(tst_ig.eos, 1.0, false, 10., 10., 
+                          tst_ig.atmo, 1e-8, max_iter);
+  });
+}
+
+
+BOOST_AUTO_TEST_CASE( c2p_mhd_root_deriv )
+{
+  failcount hope{"Derivative of master root function"};
+  
+  auto eos_ig = make_eos_idealgas(1.0, 100., 1e6);
+  auto eos_hyb = load_eos_thermal(PATH_EOS_HYB, units::geom_solar());
+  
+  for (const eos_thermal& eos : {eos_ig, eos_hyb}) {
+    const real_t rho{ eos.range_rho().max() / 1e3 };
+    const detail::c2p_eos_generic e{eos};
+    detail::froot::cache c;
+    for (const real_t rsqr : {1e-2, 1., 1e2}) {
+      for (const real_t bsqr : {0., 0.5, 5.}) {
+        for (const real_t q : {1e-3, 0.1, 2.}) {
+          detail::froot f(eos, 0.25, rho, q, rsqr, 0.3*rsqr*bsqr, 
+                          bsqr, c);
+          for (const real_t mu : linear_spacing(0.1, 0.9, 5)) {
+            const auto fd = f.eval_deriv(e, mu);
+            //Derivative not exact if eps limited by density dependent
+            //bound
+            const bool exact{ c.eps == c.eps_raw };
+            const real_t dmu{ 1e-6 * mu };
+            const real_t dfnum{ (f(mu + dmu) - f(mu - dmu)) / (2*dmu) };
+            const real_t f0{ f(mu) };
+            hope.isclose(fd.first, f0, 1e-14, 1e-14, 
+                         "Root function value");
+            if (exact) {
+              hope.isclose(fd.second, dfnum, 1e-5, 1e-7, 
+                           "Root function derivative");
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( c2p_mhd_table_adapter )
+{
+  failcount hope{"Direct calls for EOS tabulated in temperature"};
+  
+  //Polytrope plus thermal part linear in temperature
+  const eos_thermal::range rg_rho{1e-10, 1e-2}, rg_temp{1e-3, 1e2};
+  const std::size_t n_rho{ 60 }, n_temp{ 40 }, n_ye{ 2 };
+  const real_t kappa{ 100. }, gm1_th{ 0.8 }, cv{ 0.1 };
+  const std::size_t sz{ n_rho * n_temp * n_ye };
+  std::vector<real_t> vp(sz), veps(sz), vcs2(sz), vs(sz);
+  const real_t fr{ log(rg_rho.max() / rg_rho.min()) / (n_rho - 1) };
+  const real_t ft{ log(rg_temp.max() / rg_temp.min()) / (n_temp - 1) };
+  for (std::size_t iy = 0; iy < n_ye; ++iy) {
+    for (std::size_t it = 0; it < n_temp; ++it) {
+      for (std::size_t ir = 0; ir < n_rho; ++ir) {
+        const std::size_t j{ (iy * n_temp + it) * n_rho + ir };
+        const real_t rho{ rg_rho.min() * exp(ir * fr) };
+        const real_t temp{ rg_temp.min() * exp(it * ft) };
+        veps[j] = kappa * rho + cv * temp;
+        vp[j]   = kappa * rho * rho + gm1_th * rho * cv * temp;
+        vcs2[j] = 0.1;
+        vs[j]   = 0.;
+      }
+    }
+  }
+  auto eos = make_eos_thermal_table(rg_rho, n_rho, rg_temp, n_temp, 
+                                    {0.01, 0.6}, n_ye, vp, veps, vcs2, 
+                                    vs);
+  
+  const eos_thermal_static eos_s(eos);
+  hope(eos_s.get_kind() == eos_thermal_static::kind::TABLE, 
+       "Table detected");
+  const auto& impl = 
+    *eos.implementation_as<implementations::eos_thermal_table>();
+  const detail::c2p_eos_table et{ detail::c2p_eos(impl, eos) };
+  const detail::c2p_eos_generic eg{eos};
+  
+  const real_t rho{ 1e-4 };
+  detail::froot::cache c;
+  for (const real_t rsqr : {1e-2, 1., 1e2}) {
+    for (const real_t bsqr : {0., 0.5, 5.}) {
+      for (const real_t q : {1e-3, 0.1, 2.}) {
+        detail::froot f(eos, 0.25, rho, q, rsqr, 0.3*rsqr*bsqr, 
+                        bsqr, c);
+        for (const real_t mu : linear_spacing(0.1, 0.9, 5)) {
+          const auto fdt = f.eval_deriv(et, mu);
+          const auto fdg = f.eval_deriv(eg, mu);
+          hope.isclose(f.eval(et, mu), f.eval(eg, mu), 1e-14, 0, 
+                       "Root function value");
+          hope.isclose(fdt.first, fdg.first, 1e-14, 0, 
+                       "Root function value with derivative");
+          hope.isclose(fdt.second, fdg.second, 1e-14, 0, 
+                       "Root function derivative");
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( c2p_root_stats )
+{
+  failcount hope{"Root solver statistics"};
+
+  auto eos = make_eos_idealgas(1.0, 100., 1e6);
+  const real_t rho{ eos.range_rho().max() / 1e3 };
+
+  for (const real_t rsqr : {1e-2, 1., 1e2}) {
+    for (const real_t bsqr : {0., 0.5, 5.}) {
+      for (const real_t q : {1e-3, 0.1, 2.}) {
+        detail::froot::cache c;
+        detail::froot f(eos, 0.25, rho, q, rsqr, 0.3*rsqr*bsqr, bsqr, c);
+        con2prim_mhd::report rep;
+        rep.status = con2prim_mhd::report::SUCCESS;
+        const auto bracket = f.initial_bracket(rep);
+        if (!hope(!rep.failed(), "Initial bracket")) continue;
+
+        ROOTSTAT status;
+        root_stats st;
+        c.calls = 0;
+        const auto res = findroot_no_deriv(f, bracket, 1e-10, 30,
+                                           status, &st);
+        hope(status == ROOTSTAT::SUCCESS, "TOMS748 converged");
+        hope(f.stopif(res.min(), res.length(), 1e-10)
+             || (res.length() == 0), "TOMS748 accuracy");
+        hope(st.calls == unsigned(c.calls), "TOMS748 call count");
+        hope(st.calls == 2 + st.secant + st.quadratic + st.cubic
+                           + st.bisect, "TOMS748 step count");
+        hope(st.newton == 0, "TOMS748 no Newton steps");
+
+        c.calls = 0;
+        findroot_no_deriv(f, bracket, 0., 10, status, &st);
+        hope((status == ROOTSTAT::SUCCESS) 
+             || (status == ROOTSTAT::NOT_CONVERGED), "TOMS748 status");
+        hope(st.calls <= 10, "TOMS748 respects budget");
+        hope((status == ROOTSTAT::SUCCESS) || (st.calls == 10), 
+             "TOMS748 uses budget");
+        hope(st.calls == unsigned(c.calls), "TOMS748 call count");
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( c2p_mhd_newton )
+{
+  failcount hope{"C2P using Newton root solver"};
+  
+  env_idealgas par_ig{1e6, 100., 1e-11, 1e-6, 10.0, 2e3, 4e-8};
+  const auto tst_ig = make_env(par_ig);
+  
+  env_hybrideos par_hyb{1e-12, 1.0, 2e3, 1e-8};
+  const auto tst_hyb = make_env(par_hyb);
+
+  const real_t ye_fixed{0.25};
+  const real_t max_b{ 10. };
+  const int max_iter{ 30 };
+  const auto newton = con2prim_mhd::root_solver::NEWTON;
+  const auto toms748 = con2prim_mhd::root_solver::TOMS748;
+  
+  hope(tst_ig.cv2pv.get_root_solver() == newton,
+       "Default root solver for ideal gas EOS is Newton");
+  hope(tst_hyb.cv2pv.get_root_solver() == toms748,
+       "Default root solver for hybrid EOS is TOMS748");
+
+  const con2prim_mhd cv2pv_ig(tst_ig.eos, 
+    par_ig.c2p_strict * par_ig.atmo_rho, false, par_ig.c2p_zmax, 
+    max_b, tst_ig.atmo, par_ig.c2p_acc, max_iter, toms748);
+
+  const con2prim_mhd cv2pv_hyb(tst_hyb.eos, 
+    par_hyb.c2p_strict * par_hyb.atmo_rho, false, par_hyb.c2p_zmax, 
+    max_b, tst_hyb.atmo, par_hyb.c2p_acc, max_iter, newton);
+  
+  std::vector<cons_vars_mhd> cells_ig, cells_hyb;
+
+  for (const real_t z : log_spacing(1e-2, 1e3, 20)) {
+    for (const real_t b : linear_spacing(0.0, 5.0, 5)) {
+      prim_vars_mhd pv;
+      cons_vars_mhd cv;
+      for (const real_t eps : log_spacing(1e-4, 50., 5)) {
+        tst_ig.setup_prim_cons(pv, cv, 1e-5, eps, ye_fixed, z, b, 0, 1);
+        cells_ig.push_back(cv);
+      }
+      cv.tau *= 1e4;
+      cells_ig.push_back(cv);
+
+      for (const real_t rho : log_spacing(par_hyb.atmo_rho*5, 
+                                tst_hyb.eos.range_rho().max()/1.1, 5)) {
+        const auto rgeps = tst_hyb.eos.range_eps(rho, ye_fixed);
+        const real_t eps{ 0.9 * rgeps.min() + 0.1 * rgeps.max() };
+        tst_hyb.setup_prim_cons(pv, cv, rho, eps, ye_fixed, z, b, 2, 0);
+        cells_hyb.push_back(cv);
+      }
+      cv.dens *= 1.2;
+      cells_hyb.push_back(cv);
+    }
+  }
+  
+  hope(tst_ig.chk_solver(cv2pv_ig, cells_ig), 
+       "TOMS748 root solver agrees with Newton for ideal gas EOS");
+  hope(tst_hyb.chk_solver(cv2pv_hyb, cells_hyb), 
+       "Newton root solver agrees with TOMS748 for hybrid EOS");
+}
+
+
+BOOST_AUTO_TEST_CASE( c2p_hydro_zero_b )
+{
+  failcount hope{"C2P specialized to zero magnetic field"};
+  
+  env_idealgas par_ig{1e6, 51., 1e-11, 1e-6, 1.0, 2e3, 1e-8};
+  const auto tst_ig = make_env(par_ig);
+  
+  env_hybrideos par_hyb{1e-12, 1.0, 2e3, 1e-8};
+  const auto tst_hyb = make_env(par_hyb);
+
+  const real_t ye_fixed{0.25};
+  const int max_iter{ 30 };
+  
+  const con2prim_hydro cv2pv_ig(tst_ig.eos, 
+    par_ig.c2p_strict * par_ig.atmo_rho, false, par_ig.c2p_zmax, 
+    tst_ig.atmo, par_ig.c2p_acc, max_iter);
+
+  const con2prim_hydro cv2pv_hyb(tst_hyb.eos, 
+    par_hyb.c2p_strict * par_hyb.atmo_rho, false, par_hyb.c2p_zmax, 
+    tst_hyb.atmo, par_hyb.c2p_acc, max_iter);
+  
+  std::vector<cons_vars_mhd> cells_ig, cells_hyb;
+  prim_vars_mhd pv;
+  cons_vars_mhd cv;
+
+  for (const real_t z : log_spacing(1e-2, 1e3, 30)) {
+    for (int vdim=0; vdim<3; vdim++) {
+      for (const real_t eps : log_spacing(1e-4, 50., 10)) {
+        tst_ig.setup_prim_cons(pv, cv, 1e-5, eps, ye_fixed, z, 0., 
+                               vdim, 0);
+        cells_ig.push_back(cv);
+      }
+      //Energy too large
+      cv.tau *= 1e4;
+      cells_ig.push_back(cv);
+      //Below atmosphere cut
+      tst_ig.setup_prim_cons(pv, cv, par_ig.atmo_rho * 1.02, 1., 
+                             ye_fixed, z, 0., vdim, 0);
+      cells_ig.push_back(cv);
+
+      for (const real_t rho : log_spacing(par_hyb.atmo_rho*5, 
+                                tst_hyb.eos.range_rho().max()/1.1, 10)) {
+        const auto rgeps = tst_hyb.eos.range_eps(rho, ye_fixed);
+        const real_t eps{ 0.9 * rgeps.min() + 0.1 * rgeps.max() };
+        tst_hyb.setup_prim_cons(pv, cv, rho, eps, ye_fixed, z, 0., 
+                                vdim, 0);
+        cells_hyb.push_back(cv);
+      }
+      //Density possibly above EOS range
+      cv.dens *= 1.2;
+      cells_hyb.push_back(cv);
+      //Electron fraction outside EOS range
+      cv.tracer_ye = cv.dens * 2.0;
+      cells_hyb.push_back(cv);
+    }
+  }
+  
+  hope(tst_ig.chk_hydro(cv2pv_ig, cells_ig), 
+       "Hydro C2P agrees with MHD C2P for ideal gas EOS");
+  hope(tst_hyb.chk_hydro(cv2pv_hyb, cells_hyb), 
+       "Hydro C2P agrees with MHD C2P for hybrid EOS");
+}
+
+
 BOOST_AUTO_TEST_CASE( test_con2prim_phys_igas )
 {
   failcount hope{"C2P with ideal gas EOS works "
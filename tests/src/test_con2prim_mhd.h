@@ -1,7 +1,9 @@
 #include "test_utils.h"
 #include "con2prim_imhd.h"
+#include "con2prim_hydro.h"
 #include "eos_thermal.h"
 #include <boost/format.hpp>
+#include <vector>
 
 using EOS_Toolkit::eos_thermal;
 using EOS_Toolkit::real_t;
@@ -9,6 +11,7 @@ using EOS_Toolkit::sm_metric3;
 using EOS_Toolkit::sm_tensor1;
 using EOS_Toolkit::atmosphere;
 using EOS_Toolkit::con2prim_mhd;
+using EOS_Toolkit::con2prim_hydro;
 using EOS_Toolkit::prim_vars_mhd;
 using EOS_Toolkit::cons_vars_mhd;
 
@@ -95,6 +98,10 @@ class test_con2prim_mhd {
 
   bool chk_normal(real_t rho, real_t eps, real_t ye, 
                   real_t z, real_t b, int vdim, int bdim) const;
+
+  bool chk_hint(real_t rho, real_t eps, real_t ye, 
+                real_t z, real_t b, int vdim, int bdim, 
+                int& iter_saved) const;
                   
   bool chk_fail_rho(cons_vars_mhd cv) const;
   bool chk_fail_eps(cons_vars_mhd cv) const;
@@ -109,6 +116,19 @@ class test_con2prim_mhd {
   
   bool chk_atmo(real_t rho_fac, real_t eps, real_t ye, 
                 real_t z, real_t b, int vdim, int bdim) const;
+
+  bool chk_batch(const std::vector<cons_vars_mhd>& cells, 
+                 bool with_hint=false) const;
+
+  bool chk_solver(const con2prim_mhd& cv2pv_alt, 
+                  const std::vector<cons_vars_mhd>& cells) const;
+
+  bool chk_hydro(const con2prim_hydro& cv2pv_hyd, 
+                 const std::vector<cons_vars_mhd>& cells) const;
+
+  template<class C>
+  bool chk_spec(const C& cv2pv_spec, 
+                const std::vector<cons_vars_mhd>& cells) const;
 };
 
 
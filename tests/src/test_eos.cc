@@ -1,6 +1,10 @@
 #define BOOST_TEST_MODULE EOS
 
 #include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <boost/test/unit_test.hpp>
 #include "test_utils.h"
 #include <boost/format.hpp>
@@ -14,8 +18,12 @@
 #include "eos_barotropic.h"
 #include "eos_barotr_file.h"
 #include "eos_barotr_poly.h"
+#include "eos_barotr_gpoly.h"
 #include "eos_barotr_spline.h"
 #include "eos_hybrid.h"
+#include "eos_thermal_table.h"
+#include "eos_thermal_static.h"
+#include "eos_instrument.h"
 #include "interpol.h"
 
 #include "eos_data_ms1.h"
@@ -96,6 +104,13 @@ bool compare_eos_barotr(eos_barotr eos1, eos_barotr eos2,
     hope.isclose(1.+t1.eps(), 1.+t2.eps(), err_rhoe, 0., 
                  "1+eps from gm1");
     
+    for (const auto& t : {t1, t2}) 
+    {
+      const auto v = t.vars();
+      hope.isclose(v.press, t.press(), 1e-15, 0., "fused p from gm1");
+      hope.isclose(v.eps, t.eps(), 1e-15, 1e-15, "fused eps from gm1");
+      hope.isclose(v.hm1, t.hm1(), 1e-15, 1e-15, "fused h-1 from gm1");
+    }
   }
   return hope;
 }
@@ -322,6 +337,59 @@ BOOST_AUTO_TEST_CASE( test_eos_barotr_pwpoly_file )
 
 }
 
+bool check_barotr_batch(const eos_barotr& eos, real_t tol)
+{
+  failcount hope("Batched barotropic EOS evaluation agrees with "
+                 "pointwise evaluation");
+  
+  const real_t rhomax{ eos.range_rho().max() };
+  std::vector<real_t> rho{0.0, rhomax, -1.0, 1.01 * rhomax, 
+                          numeric_limits<real_t>::quiet_NaN()};
+  for (real_t r : log_spacing(1e-14 * rhomax, rhomax, 1000)) {
+    rho.push_back(std::min(r, rhomax));
+  }
+  const std::size_t n{ rho.size() };
+  std::vector<real_t> gm1(n), press(n), eps(n), hm1(n), csnd(n);
+  bool valid[2000];
+  eos_barotr::result_arrays res;
+  res.gm1   = gm1.data();
+  res.press = press.data();
+  res.eps   = eps.data();
+  res.hm1   = hm1.data();
+  res.csnd  = csnd.data();
+  eos.eval_at_rho(n, rho.data(), res, valid);
+  
+  for (std::size_t i = 0; i < n; ++i) {
+    auto s = eos.at_rho(rho[i]);
+    if (!hope(valid[i] == bool(s), "batch validity flag")) continue;
+    if (!s) {
+      hope(std::isnan(gm1[i]) && std::isnan(press[i]) 
+           && std::isnan(eps[i]) && std::isnan(hm1[i]) 
+           && std::isnan(csnd[i]), "batch invalid points give NAN");
+      continue;
+    }
+    hope.isclose(s.gm1(), gm1[i], tol, 1e-300, "batch g-1");
+    hope.isclose(s.press(), press[i], tol, 1e-300, "batch P");
+    hope.isclose(1 + s.eps(), 1 + eps[i], tol, 0, "batch 1+eps");
+    hope.isclose(s.hm1(), hm1[i], tol, 1e-300, "batch h-1");
+    hope.isclose(s.csnd(), csnd[i], tol, 1e-300, "batch c_s");
+  }
+  
+  return hope;
+}
+
+BOOST_AUTO_TEST_CASE( test_eos_barotr_batch )
+{
+  failcount hope("Batched barotropic EOS evaluation works");
+                 
+  auto u = units::geom_solar();
+  
+  hope(check_barotr_batch(load_eos_barotr(PATH_EOS_PP, u), 1e-13),
+       "Batched evaluation of piecewise polytrope");
+  hope(check_barotr_batch(load_eos_barotr(PATH_EOS, u), 0),
+       "Batched evaluation using default implementation");
+}
+
 std::string get_temp_filename()
 {
   char tmpn[L_tmpnam];
@@ -359,6 +427,39 @@ bool test_eos_file_io(const eos_barotr eos, real_t rho0,
 }
   
 
+BOOST_AUTO_TEST_CASE( test_eos_poly_index )
+{
+  failcount hope("Polytropic EOS with special indices accurate");
+  
+  const real_t rmd_p  = 0.1;
+  const real_t rhomax = 10.;
+  const real_t sed0   = 0.01;
+  const real_t tol    = 1e-14;
+  
+  for (real_t n : {1., 1.5, 2., 3., 0.5, 1.7}) {
+    auto eos  = make_eos_barotr_poly(n, rmd_p, rhomax);
+    auto eosg = make_eos_barotr_gpoly(n, rmd_p, sed0, rhomax);
+    const real_t h0 = 1 + sed0;
+    for (real_t rho : log_spacing(1e-10, 0.99 * rhomax, 1000)) {
+      if (!eos.is_rho_valid(rho)) continue;
+      const real_t gm1 = (n + 1) * pow(rho / rmd_p, 1. / n);
+      auto s = eos.at_rho(rho);
+      hope.isclose(s.gm1(), gm1, tol, 0, "poly g-1");
+      hope.isclose(s.press(), rho * gm1 / (n + 1), tol, 0, "poly P");
+      hope.isclose(s.eps(), n * gm1 / (n + 1), tol, 0, "poly eps");
+      hope.isclose(eos.at_gm1(gm1).rho(), rho, tol, 0, "poly rho");
+      
+      auto sg = eosg.at_rho(rho);
+      hope.isclose(sg.gm1(), gm1 / h0, tol, 0, "gpoly g-1");
+      hope.isclose(sg.press(), rho * gm1 / (n + 1), tol, 0, 
+                   "gpoly P");
+      hope.isclose(eosg.at_gm1(gm1 / h0).rho(), rho, tol, 0, 
+                   "gpoly rho");
+    }
+  }
+}
+
+
 BOOST_AUTO_TEST_CASE( test_eos_spline )
 {
   failcount hope("Spline EOS accurate");
@@ -516,3 +617,699 @@ BOOST_AUTO_TEST_CASE( test_eos_thermal_save )
 
 
 
+
+
+void check_press_limited(failcount& hope, const eos_thermal& eos, 
+                         real_t rho, real_t ye)
+{
+  const auto rgeps = eos.range_eps(rho, ye);
+  for (real_t eps : {rgeps.min() - 1e-3, rgeps.min(), 
+                     0.5 * (rgeps.min() + rgeps.max()), 
+                     rgeps.max(), 2 * rgeps.max()}) 
+  {
+    const auto pl = eos.press_limited(rho, eps, ye);
+    const real_t eps_l = rgeps.limit_to(eps);
+    const real_t p = eos.at_rho_eps_ye(rho, eps_l, ye).press();
+    hope.isclose(pl.eps, eps_l, 1e-15, 0, 
+                 "press_limited limits specific energy");
+    hope.isclose(pl.press, p, 1e-14, 0, 
+                 "press_limited pressure matches EOS state");
+    hope.isclose(pl.rgeps.min(), rgeps.min(), 1e-15, 0,
+                 "press_limited lower bound of eps range");
+    hope.isclose(pl.rgeps.max(), rgeps.max(), 1e-15, 0,
+                 "press_limited upper bound of eps range");
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_eos_thermal_press_limited )
+{
+  failcount hope("Fused limiting and pressure consistent with EOS");
+  
+  auto u = units::geom_solar(); 
+  real_t eps_max{ 1e2 };
+  real_t rho_max{ 0.1 };
+  
+  auto eos1 = make_eos_idealgas(1.0, eps_max, rho_max);
+  auto eos2 = make_eos_hybrid(load_eos_barotr(PATH_EOS_PP, u), 1.8, 
+                              eps_max, rho_max);
+
+  for (real_t rho : {1e-10, 1e-5, 1e-3, 0.05}) {
+    check_press_limited(hope, eos1, rho, 0.1);
+    check_press_limited(hope, eos2, rho, 0.1);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_eos_hybrid_cold_part )
+{
+  failcount hope("Hybrid EOS consistent with cold EOS and derivatives");
+  
+  auto u = units::geom_solar(); 
+  auto eos_c = load_eos_barotr(PATH_EOS_PP, u);
+  const real_t gamma_th{ 1.8 };
+  auto eos = make_eos_hybrid(eos_c, gamma_th, 1e2, 0.1);
+  const real_t ye{ 0.1 };
+  
+  for (real_t rho : {1e-9, 1e-5, 1e-3, 5e-3}) {
+    auto sc = eos_c.at_rho(rho);
+    auto s0 = eos.at_rho_eps_ye(rho, sc.eps(), ye);
+    hope.isclose(s0.press(), sc.press(), 1e-14, 0,
+                 "pressure at zero temperature matches cold EOS");
+    hope.isclose(s0.csnd(), sc.csnd(), 1e-14, 0,
+                 "soundspeed at zero temperature matches cold EOS");
+    
+    const real_t eps_th{ 0.3 * (1 + sc.eps()) };
+    const real_t eps{ sc.eps() + eps_th };
+    auto s = eos.at_rho_eps_ye(rho, eps, ye);
+    hope.isclose(s.press(), sc.press() + (gamma_th - 1) * rho * eps_th,
+                 1e-14, 0, "thermal pressure is ideal gas");
+    
+    const real_t d{ 1e-6 };
+    const real_t dp_drho{ 
+      (eos.press_at_rho_eps_ye(rho * (1 + d), eps, ye) 
+       - eos.press_at_rho_eps_ye(rho * (1 - d), eps, ye)) 
+      / (2 * d * rho) };
+    hope.isclose(s.dpress_drho(), dp_drho, 1e-6, 0,
+                 "dP/drho consistent with pressure");
+    hope.isclose(s.dpress_deps(), (gamma_th - 1) * rho, 1e-14, 0,
+                 "dP/deps");
+  }
+}
+
+
+/**
+Analytic model for testing tabulated thermal EOS: polytrope with 
+\f$ \Gamma=2 \f$ plus thermal part linear in temperature.
+**/
+struct thermal_model {
+  real_t kappa{ 100. };
+  real_t gm1_th{ 0.8 };
+  real_t cv{ 0.1 };
+
+  real_t eps(real_t rho, real_t temp) const 
+  {
+    return kappa * rho + cv * temp;
+  }
+  real_t press(real_t rho, real_t temp) const 
+  {
+    return kappa * rho * rho + gm1_th * rho * cv * temp;
+  }
+  real_t cs2(real_t rho, real_t temp) const 
+  {
+    const real_t p{ press(rho, temp) };
+    const real_t h{ 1 + eps(rho, temp) + p / rho };
+    const real_t dp_drho{ (2 - gm1_th) * kappa * rho 
+                          + gm1_th * cv * temp };
+    return (dp_drho + gm1_th * p / rho) / h;
+  }
+  
+  eos_thermal make_table(eos_thermal::range rg_rho, std::size_t n_rho,
+                         eos_thermal::range rg_temp, std::size_t n_temp,
+                         std::size_t n_ye) const
+  {
+    const std::size_t sz{ n_rho * n_temp * n_ye };
+    vector<real_t> vp(sz), veps(sz), vcs2(sz), vs(sz);
+    const real_t fr{ log(rg_rho.max() / rg_rho.min()) / (n_rho - 1) };
+    const real_t ft{ log(rg_temp.max() / rg_temp.min()) / (n_temp - 1) };
+    for (std::size_t iy = 0; iy < n_ye; ++iy) {
+      for (std::size_t it = 0; it < n_temp; ++it) {
+        for (std::size_t ir = 0; ir < n_rho; ++ir) {
+          const std::size_t j{ (iy * n_temp + it) * n_rho + ir };
+          const real_t rho{ rg_rho.min() * exp(ir * fr) };
+          const real_t temp{ rg_temp.min() * exp(it * ft) };
+          vp[j]   = press(rho, temp);
+          veps[j] = eps(rho, temp);
+          vcs2[j] = cs2(rho, temp);
+          vs[j]   = log(temp);
+        }
+      }
+    }
+    return make_eos_thermal_table(rg_rho, n_rho, rg_temp, n_temp, 
+                                  {0.01, 0.6}, n_ye, vp, veps, vcs2, vs);
+  }
+};
+
+
+BOOST_AUTO_TEST_CASE( test_eos_thermal_table )
+{
+  failcount hope("Tabulated thermal EOS works");
+
+  const thermal_model mdl;
+  const eos_thermal::range rg_rho{1e-10, 1e-2}, rg_temp{1e-3, 1e2};
+  auto eos = mdl.make_table(rg_rho, 400, rg_temp, 300, 5);
+
+  hope.isclose(eos.range_rho().min(), rg_rho.min(), 1e-15, 0, 
+               "min density");
+  hope.isclose(eos.range_rho().max(), rg_rho.max(), 1e-15, 0, 
+               "max density");
+  hope.isclose(eos.range_temp(1e-5, 0.1).max(), rg_temp.max(), 1e-15, 
+               0, "max temperature");
+  hope(eos.minimal_h() > 0, "minimal enthalpy positive");
+  hope(eos.minimal_h() <= 1 + mdl.eps(rg_rho.min(), rg_temp.min())
+                          + mdl.press(rg_rho.min(), rg_temp.min()) 
+                            / rg_rho.min(), 
+       "minimal enthalpy is lower bound");
+
+  for (real_t rho : {1.3e-10, 1e-7, 3.3e-5, 1e-3, 9.9e-3}) {
+    const real_t ye{ 0.27 };
+    for (real_t temp : {1.1e-3, 0.2, 3., 99.}) {
+      auto s = eos.at_rho_temp_ye(rho, temp, ye);
+      if (!hope(s.valid(), "can evaluate at valid rho, T, Y_e")) continue;
+      hope.isclose(s.press(), mdl.press(rho, temp), 1e-3, 0, 
+                   "pressure matches model");
+      hope.isclose(s.eps(), mdl.eps(rho, temp), 1e-3, 0, 
+                   "eps matches model");
+      hope.isclose(s.csnd(), sqrt(mdl.cs2(rho, temp)), 1e-3, 0, 
+                   "soundspeed matches model");
+      hope.isclose(s.sentr(), log(temp), 1e-3, 0, 
+                   "entropy matches model");
+
+      auto s2 = eos.at_rho_eps_ye(rho, s.eps(), ye);
+      if (!hope(s2.valid(), "can evaluate at valid rho, eps, Y_e")) continue;
+      hope.isclose(s2.temp(), temp, 1e-12, 0, 
+                   "temperature from eps consistent");
+      hope.isclose(s2.press(), s.press(), 1e-12, 0, 
+                   "pressure from eps consistent");
+
+      const real_t d{ 1e-7 };
+      const real_t dp_deps{ 
+        (eos.at_rho_eps_ye(rho, s.eps() * (1 + d), ye).press() 
+         - eos.at_rho_eps_ye(rho, s.eps() * (1 - d), ye).press())
+        / (2 * d * s.eps()) };
+      const real_t dp_drho{ 
+        (eos.at_rho_eps_ye(rho * (1 + d), s.eps(), ye).press() 
+         - eos.at_rho_eps_ye(rho * (1 - d), s.eps(), ye).press())
+        / (2 * d * rho) };
+      hope.isclose(s2.dpress_deps(), dp_deps, 1e-5, 0,
+                   "dP/deps consistent with pressure");
+      hope.isclose(s2.dpress_drho(), dp_drho, 1e-5, 0,
+                   "dP/drho consistent with pressure");
+    }
+    check_press_limited(hope, eos, rho, ye);
+  }
+
+  auto fn = get_temp_filename();
+  hope.nothrow("Can save tabulated thermal EOS", [&] () {
+    save_eos_thermal(fn, eos);
+  });
+  hope.nothrow("Can load tabulated thermal EOS", [&] () {
+    auto eos2 = load_eos_thermal(fn);
+    for (real_t rho : {1e-9, 1e-4}) {
+      for (real_t temp : {0.01, 10.}) {
+        auto s1 = eos.at_rho_temp_ye(rho, temp, 0.3);
+        auto s2 = eos2.at_rho_temp_ye(rho, temp, 0.3);
+        hope.isclose(s1.press(), s2.press(), 1e-13, 0, 
+                     "pressure same after loading");
+        hope.isclose(s1.eps(), s2.eps(), 1e-13, 0, 
+                     "eps same after loading");
+        hope.isclose(s1.csnd(), s2.csnd(), 1e-13, 0, 
+                     "soundspeed same after loading");
+      }
+    }
+  });
+  std::remove(fn.c_str());
+
+  bool thrown{ false };
+  try {
+    make_eos_thermal_table(rg_rho, 2, rg_temp, 2, {0., 1.}, 2,
+                           vector<real_t>(8, 1.), vector<real_t>(8, 1.), 
+                           vector<real_t>(8, 0.1), {});
+  } 
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "non-monotonic specific energy rejected");
+}
+
+
+void check_batch_eval(failcount& hope, const eos_thermal& eos, 
+                      bool has_temp)
+{
+  vector<real_t> rho, eps, ye;
+  for (real_t r : {-1.0, 1e-9, 1e-6, 1e-3, 1e-2 - 1e-9, 1.0}) {
+    for (real_t y : {-0.1, 0.1, 0.3}) {
+      const bool rho_ye_ok{ eos.is_rho_ye_valid(r, y) };
+      const auto rgeps = rho_ye_ok ? eos.range_eps(r, y) 
+                                   : eos_thermal::range{0., 1.};
+      for (real_t e : {rgeps.min() - 1e-3, rgeps.min(), 
+                       0.3 * rgeps.min() + 0.7 * rgeps.max(), 
+                       rgeps.max(), 2 * rgeps.max() + 1}) 
+      {
+        rho.push_back(r);
+        eps.push_back(e);
+        ye.push_back(y);
+      }
+    }
+  }
+  const std::size_t n{ rho.size() };
+  vector<real_t> p(n), cs(n), dpdr(n), dpde(n), t(n), e2(n);
+  std::unique_ptr<bool[]> ok{ new bool[n] };
+  
+  eos_thermal::result_arrays res;
+  res.press       = p.data();
+  res.csnd        = cs.data();
+  res.dpress_drho = dpdr.data();
+  res.dpress_deps = dpde.data();
+  if (has_temp) res.temp = t.data();
+  eos.eval_at_rho_eps_ye(n, rho.data(), eps.data(), ye.data(), res, 
+                         ok.get());
+  
+  for (std::size_t i = 0; i < n; ++i) {
+    const bool valid{ eos.is_rho_eps_ye_valid(rho[i], eps[i], ye[i]) };
+    hope(ok[i] == valid, "batch evaluation marks valid points");
+    if (!valid) {
+      hope.isnan(p[i], "batch evaluation sets NAN for invalid points");
+      continue;
+    }
+    hope.isclose(p[i], eos.press_at_rho_eps_ye(rho[i], eps[i], ye[i]),
+                 1e-15, 0, "batch pressure agrees with pointwise");
+    hope.isclose(cs[i], eos.csnd_at_rho_eps_ye(rho[i], eps[i], ye[i]),
+                 1e-15, 0, "batch soundspeed agrees with pointwise");
+    hope.isclose(dpdr[i], 
+                 eos.dpress_drho_at_rho_eps_ye(rho[i], eps[i], ye[i]),
+                 1e-15, 0, "batch dP/drho agrees with pointwise");
+    hope.isclose(dpde[i], 
+                 eos.dpress_deps_at_rho_eps_ye(rho[i], eps[i], ye[i]),
+                 1e-15, 0, "batch dP/deps agrees with pointwise");
+    if (has_temp) {
+      hope.isclose(t[i], eos.temp_at_rho_eps_ye(rho[i], eps[i], ye[i]),
+                   1e-15, 0, "batch temperature agrees with pointwise");
+    }
+  }
+  
+  if (!has_temp) return;
+  
+  eos_thermal::result_arrays res2;
+  res2.eps = e2.data();
+  eos.eval_at_rho_temp_ye(n, rho.data(), t.data(), ye.data(), res2);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (ok[i]) {
+      hope.isclose(e2[i], eps[i], 1e-12, 1e-14, 
+                   "batch evaluation based on temperature");
+    }
+    else {
+      hope.isnan(e2[i], "batch evaluation sets NAN for invalid points");
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_eos_thermal_batch )
+{
+  failcount hope("Batched thermal EOS evaluation agrees with pointwise");
+  
+  auto u = units::geom_solar(); 
+  real_t eps_max{ 1e2 };
+  real_t rho_max{ 1e-2 };
+  
+  auto eos1 = make_eos_idealgas(1.0, eps_max, rho_max);
+  auto eos2 = make_eos_hybrid(load_eos_barotr(PATH_EOS_PP, u), 1.8, 
+                              eps_max, rho_max);
+  thermal_model mdl;
+  auto eos3 = mdl.make_table({1e-10, rho_max}, 100, {1e-3, 1e2}, 80, 5);
+
+  check_batch_eval(hope, eos1, false);
+  check_batch_eval(hope, eos2, false);
+  check_batch_eval(hope, eos3, true);
+  
+  real_t x{ 1e-3 }, y{ 0 };
+  eos_thermal::result_arrays res;
+  res.temp = &y;
+  bool thrown{ false };
+  try {
+    eos1.eval_at_rho_eps_ye(1, &x, &x, &x, res);
+  } 
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "batch evaluation of unavailable quantity throws");
+
+  res.temp  = nullptr;
+  res.press = &y;
+  thrown    = false;
+  try {
+    eos1.eval_at_rho_temp_ye(1, &x, &x, &x, res);
+  } 
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "batch evaluation without temperature support throws");
+}
+
+
+void check_tabulated(failcount& hope, const eos_thermal& eos0,
+                     const eos_thermal::range& rg_rho, real_t err,
+                     bool has_temp)
+{
+  const eos_thermal::range rg_eps_th{1e-8, 10.};
+  auto eos = make_eos_thermal_tabulated(eos0, rg_rho, rg_eps_th, 10,
+                                        err);
+
+  hope.isclose(eos.range_rho().min(), rg_rho.min(), 1e-15, 0,
+               "min density");
+  hope.isclose(eos.range_rho().max(), rg_rho.max(), 1e-15, 0,
+               "max density");
+  hope(eos.minimal_h() > 0, "minimal enthalpy positive");
+
+  const real_t ye{ 0.27 };
+  for (real_t rho : {1.3e-10, 1e-7, 3.3e-5, 1e-3, 4.9e-3}) {
+    const real_t eps_min{ max(eos.range_eps(rho, ye).min(),
+                              eos0.range_eps(rho, ye).min()) };
+    for (real_t eps_th : {0., 1e-7, 1e-3, 0.2, 9.}) {
+      const real_t eps{ eps_min + eps_th };
+      auto s0 = eos0.at_rho_eps_ye(rho, eps, ye);
+      auto s  = eos.at_rho_eps_ye(rho, eps, ye);
+      if (!hope(s.valid(), "can evaluate at valid rho, eps, Y_e")) {
+        continue;
+      }
+      hope.isclose(s.press(), s0.press(), 2 * err,
+                   2 * err * rho * rg_eps_th.min(),
+                   "pressure matches original EOS");
+      if (has_temp) {
+        hope.isclose(s.temp(), s0.temp(), 1e-2, 0,
+                     "temperature matches original EOS");
+      }
+      hope.isclose(eos.press_at_rho_eps_ye(rho, eps, 0.01),
+                   eos.press_at_rho_eps_ye(rho, eps, 0.6), 0, 0,
+                   "no Y_e dependency if original EOS has none");
+
+      if (eps_th < 1e-3) continue;
+      const real_t d{ 1e-7 };
+      const real_t dp_deps{
+        (eos.press_at_rho_eps_ye(rho, eps * (1 + d), ye)
+         - eos.press_at_rho_eps_ye(rho, eps * (1 - d), ye))
+        / (2 * d * eps) };
+      const real_t dp_drho{
+        (eos.press_at_rho_eps_ye(rho * (1 + d), eps, ye)
+         - eos.press_at_rho_eps_ye(rho * (1 - d), eps, ye))
+        / (2 * d * rho) };
+      hope.isclose(s.dpress_deps(), dp_deps, 1e-5, 0,
+                   "dP/deps consistent with pressure");
+      hope.isclose(s.dpress_drho(), dp_drho, 1e-5, 0,
+                   "dP/drho consistent with pressure");
+    }
+    check_press_limited(hope, eos, rho, ye);
+  }
+  check_batch_eval(hope, eos, false);
+
+  auto fn = get_temp_filename();
+  hope.nothrow("Can save tabulated thermal EOS", [&] () {
+    save_eos_thermal(fn, eos);
+  });
+  hope.nothrow("Can load tabulated thermal EOS", [&] () {
+    auto eos2 = load_eos_thermal(fn);
+    for (real_t rho : {1e-9, 1e-4}) {
+      for (real_t eps_th : {0.01, 1.}) {
+        const real_t eps{ eos.range_eps(rho, ye).min() + eps_th };
+        auto s1 = eos.at_rho_eps_ye(rho, eps, ye);
+        auto s2 = eos2.at_rho_eps_ye(rho, eps, ye);
+        hope.isclose(s1.press(), s2.press(), 1e-13, 0,
+                     "pressure same after loading");
+        hope.isclose(s1.csnd(), s2.csnd(), 1e-13, 0,
+                     "soundspeed same after loading");
+      }
+    }
+  });
+  std::remove(fn.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( test_eos_thermal_tabulated )
+{
+  failcount hope("Tabulating arbitrary thermal EOS works");
+
+  auto u = units::geom_solar();
+  const eos_thermal::range rg_rho{1e-10, 5e-3};
+
+  auto eos1 = make_eos_hybrid(load_eos_barotr(PATH_EOS_PP, u), 1.8,
+                              1e2, 1e-2);
+  check_tabulated(hope, eos1, rg_rho, 1e-2, false);
+
+  thermal_model mdl;
+  auto eos2 = mdl.make_table({1e-10, 1e-2}, 100, {1e-3, 1e4}, 80, 5);
+  check_tabulated(hope, eos2, rg_rho, 1e-3, true);
+
+  bool thrown{ false };
+  try {
+    make_eos_thermal_tabulated(eos1, rg_rho, {1e-8, 1e3}, 10, 1e-2);
+  }
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "thermal energy range exceeding EOS is rejected");
+
+  thrown = false;
+  try {
+    make_eos_thermal_tabulated(eos1, rg_rho, {1e-8, 1.}, 10, 1e-6,
+                               100000);
+  }
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "unreachable error target is detected");
+}
+
+
+/// Pressure from EOS implementation, for testing static dispatch
+struct press_visitor {
+  real_t rho, eps, ye;
+
+  template<class E>
+  real_t operator()(const E& e) const
+  {
+    return e.press(rho, e.therm_from_rho_eps_ye(rho, eps, ye), ye);
+  }
+};
+
+BOOST_AUTO_TEST_CASE( test_eos_thermal_static )
+{
+  failcount hope("Static dispatch of thermal EOS works");
+
+  using kind = eos_thermal_static::kind;
+  auto u = units::geom_solar();
+  const real_t rho_max{ 1e-2 };
+
+  auto eos1 = make_eos_idealgas(1.0, 1e2, rho_max);
+  auto eos2 = make_eos_hybrid(load_eos_barotr(PATH_EOS_PP, u), 1.8,
+                              1e2, rho_max);
+  thermal_model mdl;
+  auto eos3 = mdl.make_table({1e-10, rho_max}, 100, {1e-3, 1e2}, 80, 5);
+  auto eos4 = make_eos_thermal_tabulated(eos1, {1e-10, rho_max},
+                                         {1e-8, 10.}, 10, 1e-2);
+
+  const std::vector<std::pair<eos_thermal, kind>> cases{
+    {eos1, kind::IDEALGAS}, {eos2, kind::HYBRID},
+    {eos3, kind::TABLE}, {eos4, kind::TABULATED}
+  };
+  for (const auto& c : cases) {
+    const eos_thermal_static eos{ c.first };
+    hope(eos.get_kind() == c.second, "EOS type detected");
+    for (real_t rho : {1e-9, 1e-5, 1e-3}) {
+      const real_t ye{ 0.3 };
+      const auto rg = eos.generic().range_eps(rho, ye);
+      const real_t eps{ 0.5 * (rg.min() + rg.max()) };
+      hope.isclose(eos.visit(press_visitor{rho, eps, ye}),
+                   eos.generic().press_at_rho_eps_ye(rho, eps, ye),
+                   1e-15, 0, "statically dispatched pressure");
+    }
+  }
+}
+
+
+void check_mapped(failcount& hope, const eos_thermal& eos)
+{
+  auto fn = get_temp_filename();
+  hope.nothrow("Can save EOS in memory-mappable format", [&] () {
+    save_eos_thermal_mapped(fn, eos);
+  });
+  hope.nothrow("Can load memory-mapped EOS", [&] () {
+    auto eos2 = load_eos_thermal(fn);
+    hope(eos_thermal_static(eos2).get_kind() 
+         == eos_thermal_static(eos).get_kind(), 
+         "memory-mapped EOS has same type");
+    hope.isclose(eos2.minimal_h(), eos.minimal_h(), 0, 0,
+                 "minimal enthalpy same after mapping");
+    const real_t ye{ 0.3 };
+    for (real_t rho : {1e-9, 1e-6, 1e-4, 3e-3}) {
+      const auto rg = eos.range_eps(rho, ye);
+      for (real_t f : {0.0, 1e-4, 0.1, 0.7}) {
+        const real_t eps{ rg.min() + f * (rg.max() - rg.min()) };
+        auto s1 = eos.at_rho_eps_ye(rho, eps, ye);
+        auto s2 = eos2.at_rho_eps_ye(rho, eps, ye);
+        hope.isclose(s1.press(), s2.press(), 0, 0,
+                     "pressure same after mapping");
+        hope.isclose(s1.csnd(), s2.csnd(), 0, 0,
+                     "soundspeed same after mapping");
+        hope.isclose(s1.dpress_drho(), s2.dpress_drho(), 0, 0,
+                     "dP/drho same after mapping");
+      }
+    }
+  });
+
+  bool thrown{ false };
+  try {
+    load_eos_thermal(fn, units::geom_meter());
+  }
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "loading memory-mapped EOS in other units throws");
+  std::remove(fn.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( test_eos_thermal_mapped )
+{
+  failcount hope("Memory-mapped thermal EOS files work");
+
+  const real_t rho_max{ 1e-2 };
+  auto eos1 = make_eos_idealgas(1.0, 1e2, rho_max);
+  thermal_model mdl;
+  auto eos2 = mdl.make_table({1e-10, rho_max}, 100, {1e-3, 1e2}, 80, 5);
+  auto eos3 = make_eos_thermal_tabulated(eos1, {1e-10, rho_max},
+                                         {1e-8, 10.}, 10, 1e-2);
+  check_mapped(hope, eos2);
+  check_mapped(hope, eos3);
+
+  auto fn = get_temp_filename();
+  bool thrown{ false };
+  try {
+    save_eos_thermal_mapped(fn, eos1);
+  }
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "saving unsupported EOS type as mapped file throws");
+
+  {
+    std::FILE* f = std::fopen(fn.c_str(), "wb");
+    std::fputs("RPRMEOS", f);
+    std::fputc('\0', f);
+    std::fputs("truncated", f);
+    std::fclose(f);
+  }
+  thrown = false;
+  try {
+    load_eos_thermal(fn);
+  }
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "corrupt memory-mapped EOS file is rejected");
+  std::remove(fn.c_str());
+}
+
+
+/// Check EOS in shared memory against original, in one process
+bool check_shared(const std::string& fn, const std::string& shm,
+                  const eos_thermal& eos)
+{
+  auto eos2 = load_eos_thermal_shared(fn, shm);
+  if (eos_thermal_static(eos2).get_kind() 
+      != eos_thermal_static::kind::TABLE) 
+  {
+    return false;
+  }
+  for (real_t rho : {1e-9, 1e-6, 1e-4, 3e-3}) {
+    for (real_t temp : {2e-3, 0.1, 30.}) {
+      if (eos.at_rho_temp_ye(rho, temp, 0.3).press() 
+          != eos2.at_rho_temp_ye(rho, temp, 0.3).press())
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+BOOST_AUTO_TEST_CASE( test_eos_thermal_shared )
+{
+  failcount hope("Thermal EOS in node-level shared memory works");
+
+  thermal_model mdl;
+  auto eos = mdl.make_table({1e-10, 1e-2}, 100, {1e-3, 1e2}, 80, 5);
+  auto fn  = get_temp_filename();
+  save_eos_thermal(fn, eos);
+  const std::string shm{ "/reprimand_test_" + std::to_string(getpid()) };
+  remove_eos_thermal_shared(shm);
+
+  // Processes racing to create the segment
+  const int nproc{ 4 };
+  std::vector<pid_t> pids;
+  for (int i = 0; i < nproc; ++i) {
+    const pid_t pid{ fork() };
+    if (pid == 0) {
+      bool ok{ false };
+      try {
+        ok = check_shared(fn, shm, eos);
+      }
+      catch (...) {
+      }
+      _exit(ok ? 0 : 1);
+    }
+    pids.push_back(pid);
+  }
+  int num_ok{ 0 };
+  for (pid_t pid : pids) {
+    int status{ 0 };
+    if ((pid > 0) && (waitpid(pid, &status, 0) == pid) 
+        && WIFEXITED(status) && (WEXITSTATUS(status) == 0)) 
+    {
+      ++num_ok;
+    }
+  }
+  hope(num_ok == nproc, "all processes can use shared EOS");
+
+  std::remove(fn.c_str());
+  hope.nothrow("can attach to existing segment", [&] () {
+    hope(check_shared(fn, shm, eos), "attached EOS matches original");
+  });
+  hope(remove_eos_thermal_shared(shm), "can remove segment");
+  hope(!remove_eos_thermal_shared(shm), "segment removed");
+
+  bool thrown{ false };
+  try {
+    load_eos_thermal_shared(fn, shm);
+  }
+  catch (std::runtime_error&) {
+    thrown = true;
+  }
+  hope(thrown, "creating segment from missing file throws");
+  remove_eos_thermal_shared(shm);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_eos_instrument )
+{
+  failcount hope("EOS call instrumentation works");
+
+  using instrument::eos_method;
+  auto eos = make_eos_idealgas(1.0, 1e2, 1e-2);
+  instrument::reset();
+  instrument::set_timing_interval(10);
+  const std::size_t n{ 100 };
+  for (std::size_t i = 0; i < n; ++i) {
+    eos.press_at_rho_eps_ye(1e-4, 0.1, 0.3);
+  }
+  instrument::set_timing_interval(0);
+  auto stats = instrument::collect();
+
+  if (!instrument::enabled()) {
+    hope(stats.empty(), "no statistics if instrumentation disabled");
+    return;
+  }
+  hope(stats.size() == 1, "statistics for one EOS instance");
+  if (stats.empty()) return;
+  const auto& m = stats[0].methods;
+  auto idx = [] (eos_method k) {return static_cast<std::size_t>(k);};
+  hope(m[idx(eos_method::press)].calls == n, "counted press calls");
+  hope(m[idx(eos_method::therm_from_rho_eps_ye)].calls == n,
+       "counted thermal variable calls");
+  hope(m[idx(eos_method::range_eps)].calls == n, 
+       "counted range_eps calls");
+  hope(m[idx(eos_method::csnd)].calls == 0, "no spurious counts");
+  hope(m[idx(eos_method::press)].sampled_calls > 0, 
+       "sampled timing of calls");
+  hope(stats[0].descr == eos.descr_str(), "EOS description recorded");
+
+  instrument::reset();
+  hope(instrument::collect().empty(), "can reset statistics");
+}
+
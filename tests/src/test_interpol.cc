@@ -3,6 +3,7 @@
 #include <boost/test/unit_test.hpp>
 #include "test_utils.h"
 #include <boost/format.hpp>
+#include <thread>
 
 #include "test_config.h"
 
@@ -12,6 +13,8 @@
 #include "interpol_logspl.h"
 #include "interpol_pchip_spline.h"
 #include "interpol_linear.h"
+#include "fast_logexp.h"
+#include "fixed_power.h"
 
 
 
@@ -249,6 +252,41 @@ BOOST_AUTO_TEST_CASE( test_interp_pchip_spline )
                  "spline approximation for quadratic function");
   }
 
+  detail::interpol_pchip_impl p1(x1, y1);
+  std::size_t hint{ 0 };
+  for (real_t x : ix1) {
+    hope.isclose(p1(x), p1(x, hint), eqtol, 0,
+                 "Spline evaluation with search hint");
+  }
+  hint = 1000;
+  hope.isclose(p1(-1.), p1(-1., hint), eqtol, 0,
+               "Spline evaluation with invalid search hint");
+
+  std::vector<real_t> x3{0., 1., 2., 3., 4., 5., 6.};
+  std::vector<real_t> y3{0., 0., 0., 1., 1., 1., 1.};
+  detail::interpol_pchip_impl p3(x3, y3);
+  for (real_t x : linear_spacing(0., 6., 200)) {
+    hope((p3(x) >= 0) && (p3(x) <= 1), 
+         "Spline interpolation does not overshoot monotonic data");
+  }
+
+  std::vector<real_t> xs;
+  for (real_t x : ix1) xs.push_back(x);
+  const int nthreads = 4;
+  std::vector<std::vector<real_t>> res(nthreads);
+  std::vector<std::thread> workers;
+  for (int k = 0; k < nthreads; ++k) {
+    workers.emplace_back([&s1, &xs, &res, k] () {
+      for (real_t x : xs) res[k].push_back(s1(x));
+    });
+  }
+  for (auto& w : workers) w.join();
+  for (int k = 0; k < nthreads; ++k) {
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+      hope(res[k][i] == s1(xs[i]), 
+           "Concurrent spline evaluation gives same results");
+    }
+  }
 }
 
 
@@ -256,3 +294,74 @@ BOOST_AUTO_TEST_CASE( test_interp_pchip_spline )
   
   
   
+
+
+BOOST_AUTO_TEST_CASE( test_fast_logexp )
+{
+  failcount hope("Fast log and exp approximations accurate");
+  
+  const real_t eqtol = 3e-16;
+  
+  for (real_t x : log_spacing(1e-300, 1e300, 200000)) {
+    hope.isclose(log(x), detail::fast_log(x), eqtol, 0, 
+                 "fast_log over full range");
+  }
+  for (real_t x : linear_spacing(0.5, 2.0, 100000)) {
+    hope.isclose(log(x), detail::fast_log(x), eqtol, 0, 
+                 "fast_log near 1");
+  }
+  hope(detail::fast_log(1.0) == 0, "fast_log(1) is exactly zero");
+  
+  for (real_t x : linear_spacing(-708., 709., 200000)) {
+    hope.isclose(exp(x), detail::fast_exp(x), eqtol, 0, 
+                 "fast_exp over full range");
+  }
+  for (real_t x : linear_spacing(-1e-3, 1e-3, 10000)) {
+    hope.isclose(exp(x), detail::fast_exp(x), eqtol, 0, 
+                 "fast_exp near 0");
+  }
+  hope(detail::fast_exp(0.0) == 1, "fast_exp(0) is exactly one");
+  hope.isclose(exp(709.), detail::fast_exp(1000.), eqtol, 0, 
+               "fast_exp limits large arguments");
+  hope.isclose(exp(-708.), detail::fast_exp(-1000.), eqtol, 0, 
+               "fast_exp limits small arguments");
+}
+
+BOOST_AUTO_TEST_CASE( test_fixed_power )
+{
+  failcount hope("Power function with fixed exponent accurate");
+  
+  const real_t eqtol = 1e-15;
+  
+  for (real_t p : {1., 2., 3., 8., 0.5, 1.5, 2.5}) {
+    detail::fixed_power f(p);
+    hope(f.is_specialized(), "integer or half-integer exponents are "
+                             "specialized");
+    for (real_t x : log_spacing(1e-30, 1e30, 20000)) {
+      hope.isclose(pow(x, p), f(x), eqtol, 0, 
+                   "specialized power agrees with std::pow");
+    }
+    hope(f(0.0) == 0, "specialized power of zero is zero");
+    hope(f(1.0) == 1, "specialized power of one is exactly one");
+  }
+  
+  //Exponent 1/3 is not exact, std::pow deviates for large |log(x)|
+  for (real_t p : {1./3., 2./3., 4./3., 7./3.}) {
+    detail::fixed_power f(p);
+    hope(f.is_specialized(), "multiples of 1/3 are specialized");
+    for (real_t x : log_spacing(1e-3, 1e3, 20000)) {
+      hope.isclose(pow(x, p), f(x), 2 * eqtol, 0, 
+                   "specialized power agrees with std::pow");
+    }
+    hope(f(0.0) == 0, "specialized power of zero is zero");
+    hope(f(1.0) == 1, "specialized power of one is exactly one");
+  }
+  
+  for (real_t p : {1.7, 9., 0.1, 0., -1., -0.5}) {
+    detail::fixed_power f(p);
+    hope(!f.is_specialized(), "other exponents use std::pow");
+    for (real_t x : log_spacing(1e-30, 1e30, 200)) {
+      hope(pow(x, p) == f(x), "unspecialized power is std::pow");
+    }
+  }
+}